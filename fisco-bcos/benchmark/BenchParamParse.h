@@ -0,0 +1,127 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2018 fisco-dev contributors.
+ */
+
+/**
+ * @brief: command line params of the consensus benchmark
+ * @file: BenchParamParse.h
+ */
+
+#pragma once
+#include <libdevcore/easylog.h>
+#include <boost/program_options.hpp>
+#include <iostream>
+#include <memory>
+
+INITIALIZE_EASYLOGGINGPP
+class Params
+{
+public:
+    Params() {}
+
+    Params(boost::program_options::variables_map const& vm,
+        boost::program_options::options_description const& option)
+    {
+        initParams(vm, option);
+    }
+
+    void initParams(boost::program_options::variables_map const& vm,
+        boost::program_options::options_description const&)
+    {
+        if (vm.count("nodes"))
+            m_nodes = vm["nodes"].as<unsigned>();
+        if (vm.count("consensus"))
+            m_consensus = vm["consensus"].as<std::string>();
+        if (vm.count("txSpeed"))
+            m_txSpeed = vm["txSpeed"].as<float>();
+        if (vm.count("duration"))
+            m_duration = vm["duration"].as<unsigned>();
+        if (vm.count("blockTime"))
+            m_blockTime = vm["blockTime"].as<unsigned>();
+        if (vm.count("latency"))
+            m_latency = vm["latency"].as<unsigned>();
+        if (vm.count("bandwidth"))
+            m_bandwidth = vm["bandwidth"].as<uint64_t>();
+        if (vm.count("loss"))
+            m_loss = vm["loss"].as<double>();
+        if (vm.count("seed"))
+            m_seed = vm["seed"].as<uint64_t>();
+        if (vm.count("dataDir"))
+            m_dataDir = vm["dataDir"].as<std::string>();
+    }
+
+    unsigned nodes() const { return m_nodes; }
+    std::string const& consensus() const { return m_consensus; }
+    float txSpeed() const { return m_txSpeed; }
+    unsigned duration() const { return m_duration; }
+    unsigned blockTime() const { return m_blockTime; }
+    unsigned latency() const { return m_latency; }
+    uint64_t bandwidth() const { return m_bandwidth; }
+    double loss() const { return m_loss; }
+    uint64_t seed() const { return m_seed; }
+    std::string const& dataDir() const { return m_dataDir; }
+
+private:
+    unsigned m_nodes = 4;
+    std::string m_consensus = "pbft";
+    float m_txSpeed = 1000;
+    unsigned m_duration = 30;
+    unsigned m_blockTime = 1000;
+    unsigned m_latency = 0;
+    uint64_t m_bandwidth = 0;
+    double m_loss = 0;
+    uint64_t m_seed = 1;
+    std::string m_dataDir = "./benchmark_data";
+};
+
+static Params initCommandLine(int argc, const char* argv[])
+{
+    boost::program_options::options_description server_options(
+        "consensus benchmark of FISCO-BCOS");
+    server_options.add_options()("nodes,n", boost::program_options::value<unsigned>(),
+        "number of the sealers, 4 by default")("consensus,c",
+        boost::program_options::value<std::string>(), "pbft or raft, pbft by default")("txSpeed,t",
+        boost::program_options::value<float>(), "transactions submitted per second")("duration,d",
+        boost::program_options::value<unsigned>(), "seconds to run")("blockTime",
+        boost::program_options::value<unsigned>(), "interval block time of PBFT in ms")(
+        "latency,l", boost::program_options::value<unsigned>(), "one-way link latency in ms")(
+        "bandwidth,b", boost::program_options::value<uint64_t>(),
+        "link bandwidth in bytes per second, 0 means unlimited")("loss,p",
+        boost::program_options::value<double>(), "probability of dropping a message")("seed,s",
+        boost::program_options::value<uint64_t>(), "seed of the link model")("dataDir",
+        boost::program_options::value<std::string>(), "directory of the PBFT backup")(
+        "help,h", "help of the consensus benchmark");
+
+    boost::program_options::variables_map vm;
+    try
+    {
+        boost::program_options::store(
+            boost::program_options::parse_command_line(argc, argv, server_options), vm);
+    }
+    catch (...)
+    {
+        std::cout << "invalid input" << std::endl;
+        exit(0);
+    }
+    /// help information
+    if (vm.count("help") || vm.count("h"))
+    {
+        std::cout << server_options << std::endl;
+        exit(0);
+    }
+    Params m_params(vm, server_options);
+    return m_params;
+}
@@ -0,0 +1,241 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2018 fisco-dev contributors.
+ */
+
+/**
+ * @brief: statistics of the consensus benchmark
+ * @file: BenchStats.cpp
+ */
+#include "BenchStats.h"
+#include <libconsensus/pbft/Common.h>
+#include <libconsensus/raft/Common.h>
+#include <algorithm>
+#include <iomanip>
+
+using namespace dev;
+using namespace dev::benchmark;
+using namespace dev::consensus;
+
+namespace
+{
+/// the packets kept for the blocks not committed yet
+int64_t const c_maxPendingHeights = 64;
+
+std::string pbftPacketName(int _type)
+{
+    switch (_type)
+    {
+    case PrepareReqPacket:
+        return "prepare";
+    case SignReqPacket:
+        return "sign";
+    case CommitReqPacket:
+        return "commit";
+    case ViewChangeReqPacket:
+        return "viewchange";
+    case CompactPrepareReqPacket:
+        return "compactPrepare";
+    case GetMissedTxsPacket:
+        return "getMissedTxs";
+    case MissedTxsPacket:
+        return "missedTxs";
+    default:
+        return "unknown";
+    }
+}
+
+std::string raftPacketName(int _type)
+{
+    switch (_type)
+    {
+    case RaftVoteReqPacket:
+        return "voteReq";
+    case RaftVoteRespPacket:
+        return "voteResp";
+    case RaftHeartBeatPacket:
+        return "heartbeat";
+    case RaftHeartBeatRespPacket:
+        return "heartbeatResp";
+    default:
+        return "unknown";
+    }
+}
+}  // namespace
+
+void LatencyHistogram::report(std::ostream& _out, std::string const& _name) const
+{
+    if (m_samples.empty())
+    {
+        _out << "  " << std::left << std::setw(14) << _name << "no samples" << std::endl;
+        return;
+    }
+    std::vector<uint64_t> sorted(m_samples);
+    std::sort(sorted.begin(), sorted.end());
+    auto percentile = [&](unsigned _p) { return sorted[(sorted.size() - 1) * _p / 100]; };
+    uint64_t sum = 0;
+    for (auto latency : sorted)
+    {
+        sum += latency;
+    }
+    _out << "  " << std::left << std::setw(14) << _name << "count=" << sorted.size()
+         << " avg=" << sum / sorted.size() << "ms p50=" << percentile(50)
+         << "ms p90=" << percentile(90) << "ms p99=" << percentile(99)
+         << "ms max=" << sorted.back() << "ms" << std::endl;
+    /// the buckets are [0, 1), [1, 2), [2, 4), [4, 8) ...
+    std::map<uint64_t, uint64_t> buckets;
+    for (auto latency : sorted)
+    {
+        uint64_t bound = 1;
+        while (bound <= latency)
+        {
+            bound <<= 1;
+        }
+        buckets[bound]++;
+    }
+    for (auto const& bucket : buckets)
+    {
+        _out << "    <" << std::setw(8) << std::to_string(bucket.first) + "ms"
+             << std::string(bucket.second * 50 / sorted.size(), '#') << " " << bucket.second
+             << std::endl;
+    }
+}
+
+std::string BenchStats::packetName(dev::p2p::P2PMessage::Ptr _message, int64_t& _height, int& _type)
+{
+    _height = -1;
+    _type = -1;
+    if (_message->protocolID() != m_protocolId)
+    {
+        return "protocol-" + std::to_string(_message->protocolID());
+    }
+    try
+    {
+        if (m_raft)
+        {
+            RaftMsgPacket packet;
+            packet.decode(ref(*_message->buffer()));
+            _type = packet.packetType;
+            return raftPacketName(_type);
+        }
+        PBFTMsgPacket packet;
+        packet.decode(ref(*_message->buffer()));
+        _type = packet.packet_id;
+        if (_type <= CompactPrepareReqPacket)
+        {
+            /// all the requests begin with the fields of PBFTMsg
+            PBFTMsg msg;
+            msg.decode(ref(packet.data));
+            _height = msg.height;
+        }
+        return pbftPacketName(_type);
+    }
+    catch (std::exception const&)
+    {
+        return "invalid";
+    }
+}
+
+void BenchStats::onSend(dev::p2p::P2PMessage::Ptr _message)
+{
+    int64_t height;
+    int type;
+    std::string name = packetName(_message, height, type);
+    uint64_t now = utcTime();
+    Guard l(x_stats);
+    auto& counter = m_messages[name];
+    counter.first++;
+    counter.second += dev::p2p::P2PMessage::HEADER_LENGTH + _message->buffer()->size();
+    if (height >= 0 && !m_firstCommitTime.count(height))
+    {
+        m_packetTime[height].insert(std::make_pair(type, now));
+    }
+}
+
+void BenchStats::recordPhase(std::string const& _phase, uint64_t _begin, uint64_t _end)
+{
+    if (_begin > 0 && _end >= _begin)
+    {
+        m_phases[_phase].record(_end - _begin);
+    }
+}
+
+void BenchStats::onCommit(size_t _nodeIdx, dev::eth::Block const& _block)
+{
+    uint64_t now = utcTime();
+    int64_t height = _block.blockHeader().number();
+    Guard l(x_stats);
+    auto it = m_firstCommitTime.find(height);
+    bool first = (it == m_firstCommitTime.end());
+    if (first)
+    {
+        it = m_firstCommitTime.insert(std::make_pair(height, now)).first;
+    }
+    recordPhase("seal->commit", (uint64_t)_block.blockHeader().timestamp(), now);
+    recordPhase("propagate", it->second, now);
+    if (!m_raft)
+    {
+        auto& packetTime = m_packetTime[height];
+        /// the prepare of the block may be compacted
+        uint64_t prepareTime = packetTime.count(PrepareReqPacket) ?
+                                   packetTime[PrepareReqPacket] :
+                                   packetTime[CompactPrepareReqPacket];
+        if (first)
+        {
+            recordPhase("prepare", prepareTime, packetTime[SignReqPacket]);
+            recordPhase("sign", packetTime[SignReqPacket], packetTime[CommitReqPacket]);
+        }
+        recordPhase("commit", packetTime[CommitReqPacket], now);
+    }
+    if (_nodeIdx == 0)
+    {
+        m_committedBlocks++;
+        m_committedTxs += _block.transactions().size();
+    }
+    /// forget the blocks all the nodes have committed
+    while (!m_firstCommitTime.empty() &&
+           m_firstCommitTime.begin()->first + c_maxPendingHeights < height)
+    {
+        m_packetTime.erase(m_firstCommitTime.begin()->first);
+        m_firstCommitTime.erase(m_firstCommitTime.begin());
+    }
+}
+
+void BenchStats::report(std::ostream& _out) const
+{
+    Guard l(x_stats);
+    uint64_t duration = std::max((uint64_t)1, m_stopTime - m_startTime);
+    _out << "duration: " << duration << "ms" << std::endl;
+    _out << "committed: blocks=" << m_committedBlocks << " txs=" << m_committedTxs
+         << " tps=" << std::fixed << std::setprecision(2)
+         << (double)m_committedTxs * 1000 / duration << std::endl;
+    _out << "latency:" << std::endl;
+    for (auto const& phase : m_phases)
+    {
+        phase.second.report(_out, phase.first);
+    }
+    _out << "messages:" << std::endl;
+    uint64_t totalMessages = 0;
+    uint64_t totalBytes = 0;
+    for (auto const& it : m_messages)
+    {
+        _out << "  " << std::left << std::setw(16) << it.first << "count=" << it.second.first
+             << " bytes=" << it.second.second << std::endl;
+        totalMessages += it.second.first;
+        totalBytes += it.second.second;
+    }
+    _out << "  " << std::left << std::setw(16) << "total"
+         << "count=" << totalMessages << " bytes=" << totalBytes << std::endl;
+}
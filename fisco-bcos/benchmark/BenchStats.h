@@ -0,0 +1,85 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2018 fisco-dev contributors.
+ */
+
+/**
+ * @brief: statistics of the consensus benchmark
+ * @file: BenchStats.h
+ */
+#pragma once
+#include <libdevcore/Common.h>
+#include <libdevcore/Guards.h>
+#include <libethcore/Block.h>
+#include <libp2p/P2PMessage.h>
+#include <map>
+#include <ostream>
+
+namespace dev
+{
+namespace benchmark
+{
+/// latency samples reported as percentiles and power-of-two buckets
+class LatencyHistogram
+{
+public:
+    void record(uint64_t _latency) { m_samples.push_back(_latency); }
+    size_t count() const { return m_samples.size(); }
+    void report(std::ostream& _out, std::string const& _name) const;
+
+private:
+    std::vector<uint64_t> m_samples;  // ms
+};
+
+class BenchStats
+{
+public:
+    BenchStats(PROTOCOL_ID const& _protocolId, bool _raft)
+      : m_protocolId(_protocolId), m_raft(_raft)
+    {}
+
+    /// observe the message sent on the simulated network
+    void onSend(dev::p2p::P2PMessage::Ptr _message);
+    /// the block is committed by the node of the index
+    void onCommit(size_t _nodeIdx, dev::eth::Block const& _block);
+
+    void start() { m_startTime = utcTime(); }
+    void stop() { m_stopTime = utcTime(); }
+    void report(std::ostream& _out) const;
+
+private:
+    /// the name of the consensus packet, decoded from the message
+    std::string packetName(dev::p2p::P2PMessage::Ptr _message, int64_t& _height, int& _type);
+    void recordPhase(std::string const& _phase, uint64_t _begin, uint64_t _end);
+
+    PROTOCOL_ID m_protocolId;
+    bool m_raft;
+    uint64_t m_startTime = 0;
+    uint64_t m_stopTime = 0;
+
+    mutable Mutex x_stats;
+    /// packet name => (messages, bytes)
+    std::map<std::string, std::pair<uint64_t, uint64_t>> m_messages;
+    /// height => packet type => the time the first packet of the type is sent
+    std::map<int64_t, std::map<int, uint64_t>> m_packetTime;
+    /// height => the time the first node commits the block
+    std::map<int64_t, uint64_t> m_firstCommitTime;
+    std::map<std::string, LatencyHistogram> m_phases;
+    /// the transactions and blocks committed by the first node
+    uint64_t m_committedTxs = 0;
+    uint64_t m_committedBlocks = 0;
+};
+}  // namespace benchmark
+}  // namespace dev
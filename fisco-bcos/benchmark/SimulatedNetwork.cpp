@@ -0,0 +1,331 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2018 fisco-dev contributors.
+ */
+
+/**
+ * @brief: in-process network connecting the nodes of the consensus benchmark
+ * @file: SimulatedNetwork.cpp
+ */
+#include "SimulatedNetwork.h"
+#include <libdevcore/easylog.h>
+#include <libethcore/Protocol.h>
+
+using namespace dev;
+using namespace dev::p2p;
+using namespace dev::network;
+using namespace dev::benchmark;
+
+SimulatedService::Ptr SimulatedNetwork::addNode(NodeID const& _nodeID)
+{
+    auto service = std::make_shared<SimulatedService>(shared_from_this(), _nodeID);
+    WriteGuard l(x_services);
+    /// every node listens on its own port of the loopback address
+    uint16_t port = 30300 + m_services.size();
+    auto session = std::make_shared<P2PSession>();
+    session->setNodeID(_nodeID);
+    session->setSession(std::make_shared<SimulatedSession>(
+        NodeIPEndpoint(bi::address::from_string("127.0.0.1"), port, port)));
+    m_services[_nodeID] = service;
+    m_sessions[_nodeID] = session;
+    return service;
+}
+
+void SimulatedNetwork::setLink(NodeID const& _from, NodeID const& _to, LinkModel const& _link)
+{
+    std::lock_guard<std::mutex> l(x_deliveries);
+    m_links[std::make_pair(_from, _to)] = _link;
+}
+
+LinkModel const& SimulatedNetwork::link(NodeID const& _from, NodeID const& _to) const
+{
+    auto it = m_links.find(std::make_pair(_from, _to));
+    if (it == m_links.end())
+    {
+        return m_defaultLink;
+    }
+    return it->second;
+}
+
+std::mt19937_64& SimulatedNetwork::linkRandom(NodeID const& _from, NodeID const& _to)
+{
+    auto key = std::make_pair(_from, _to);
+    auto it = m_linkRandom.find(key);
+    if (it == m_linkRandom.end())
+    {
+        std::hash<NodeID> hasher;
+        std::seed_seq seq{uint32_t(m_seed), uint32_t(m_seed >> 32), uint32_t(hasher(_from)),
+            uint32_t(hasher(_to))};
+        it = m_linkRandom.emplace(key, std::mt19937_64(seq)).first;
+    }
+    return it->second;
+}
+
+void SimulatedNetwork::start()
+{
+    std::lock_guard<std::mutex> l(x_deliveries);
+    if (m_running)
+    {
+        return;
+    }
+    m_running = true;
+    m_deliverThread = std::thread([this]() { deliverLoop(); });
+}
+
+void SimulatedNetwork::stop()
+{
+    {
+        std::lock_guard<std::mutex> l(x_deliveries);
+        if (!m_running)
+        {
+            return;
+        }
+        m_running = false;
+    }
+    m_signalled.notify_all();
+    m_deliverThread.join();
+    SIMNET_LOG(INFO) << LOG_DESC("stop") << LOG_KV("sent", m_sentMessages)
+                     << LOG_KV("dropped", m_droppedMessages) << LOG_KV("bytes", m_sentBytes);
+}
+
+void SimulatedNetwork::send(NodeID const& _from, NodeID const& _to, P2PMessage::Ptr _message)
+{
+    if (m_sendObserver)
+    {
+        m_sendObserver(_from, _to, _message);
+    }
+    size_t size = P2PMessage::HEADER_LENGTH + _message->buffer()->size();
+    m_sentMessages++;
+    m_sentBytes += size;
+
+    /// the receiver gets its own copy just like decoding it from the socket
+    auto message = std::make_shared<P2PMessage>();
+    message->setProtocolID(_message->protocolID());
+    message->setPacketType(_message->packetType());
+    message->setSeq(_message->seq());
+    message->setLength(size);
+    message->setBuffer(std::make_shared<bytes>(*_message->buffer()));
+
+    auto now = std::chrono::steady_clock::now();
+    {
+        std::lock_guard<std::mutex> l(x_deliveries);
+        LinkModel const& model = link(_from, _to);
+        if (model.loss > 0 &&
+            std::uniform_real_distribution<double>(0, 1)(linkRandom(_from, _to)) < model.loss)
+        {
+            m_droppedMessages++;
+            return;
+        }
+        /// the message is transmitted after the messages queued on the link before it
+        auto& busyUntil = m_linkBusyUntil[std::make_pair(_from, _to)];
+        auto transmitStart = std::max(now, busyUntil);
+        std::chrono::microseconds transmitTime(0);
+        if (model.bandwidth > 0)
+        {
+            transmitTime = std::chrono::microseconds(size * 1000000 / model.bandwidth);
+        }
+        busyUntil = transmitStart + transmitTime;
+        Delivery delivery{busyUntil + std::chrono::milliseconds(model.latency), m_seq++, _from,
+            _to, message};
+        m_deliveries.push(delivery);
+    }
+    m_signalled.notify_all();
+}
+
+void SimulatedNetwork::deliverLoop()
+{
+    std::unique_lock<std::mutex> l(x_deliveries);
+    while (m_running)
+    {
+        if (m_deliveries.empty())
+        {
+            m_signalled.wait(l);
+            continue;
+        }
+        auto deliverTime = m_deliveries.top().deliverTime;
+        if (deliverTime > std::chrono::steady_clock::now())
+        {
+            m_signalled.wait_until(l, deliverTime);
+            continue;
+        }
+        Delivery delivery = m_deliveries.top();
+        m_deliveries.pop();
+        /// the handlers may send messages
+        l.unlock();
+        deliver(delivery);
+        l.lock();
+    }
+}
+
+void SimulatedNetwork::deliver(Delivery const& _delivery)
+{
+    SimulatedService::Ptr service;
+    P2PSession::Ptr session;
+    {
+        ReadGuard l(x_services);
+        auto it = m_services.find(_delivery.to);
+        if (it == m_services.end())
+        {
+            return;
+        }
+        service = it->second;
+        session = m_sessions.at(_delivery.from);
+    }
+    service->onMessage(session, _delivery.message);
+}
+
+P2PSessionInfos SimulatedNetwork::sessionInfos(NodeID const& _nodeID) const
+{
+    P2PSessionInfos infos;
+    ReadGuard l(x_services);
+    for (auto const& it : m_sessions)
+    {
+        if (it.first == _nodeID)
+        {
+            continue;
+        }
+        infos.push_back(P2PSessionInfo(
+            it.first, it.second->session()->nodeIPEndpoint(), std::set<std::string>()));
+    }
+    return infos;
+}
+
+void SimulatedService::asyncSendMessageByNodeID(
+    NodeID _nodeID, P2PMessage::Ptr _message, CallbackFuncWithSession, dev::network::Options)
+{
+    auto network = m_network.lock();
+    if (!network)
+    {
+        return;
+    }
+    network->send(m_nodeID, _nodeID, _message);
+}
+
+void SimulatedService::asyncMulticastMessageByNodeIDList(
+    NodeIDs _nodeIDs, P2PMessage::Ptr _message)
+{
+    for (auto const& nodeID : _nodeIDs)
+    {
+        asyncSendMessageByNodeID(nodeID, _message, nullptr);
+    }
+}
+
+void SimulatedService::asyncBroadcastMessage(P2PMessage::Ptr _message, dev::network::Options)
+{
+    for (auto const& session : sessionInfos())
+    {
+        asyncSendMessageByNodeID(session.nodeID, _message, nullptr);
+    }
+}
+
+void SimulatedService::registerHandlerByProtoclID(
+    PROTOCOL_ID _protocolID, CallbackFuncWithSession _handler)
+{
+    WriteGuard l(x_handlers);
+    m_handlers[_protocolID] = _handler;
+}
+
+void SimulatedService::onMessage(P2PSession::Ptr _session, P2PMessage::Ptr _message)
+{
+    CallbackFuncWithSession handler;
+    {
+        ReadGuard l(x_handlers);
+        auto it = m_handlers.find(_message->protocolID());
+        if (it == m_handlers.end())
+        {
+            return;
+        }
+        handler = it->second;
+    }
+    handler(NetworkException(), _session, _message);
+}
+
+P2PSessionInfos SimulatedService::sessionInfos()
+{
+    auto network = m_network.lock();
+    if (!network)
+    {
+        return P2PSessionInfos();
+    }
+    return network->sessionInfos(m_nodeID);
+}
+
+P2PSessionInfos SimulatedService::sessionInfosByProtocolID(PROTOCOL_ID _protocolID) const
+{
+    auto network = m_network.lock();
+    if (!network)
+    {
+        return P2PSessionInfos();
+    }
+    /// only the nodes of the group of the protocol
+    h512s nodeList;
+    {
+        ReadGuard l(x_nodeList);
+        auto it = m_groupID2NodeList.find(dev::eth::getGroupAndProtocol(_protocolID).first);
+        if (it != m_groupID2NodeList.end())
+        {
+            nodeList = it->second;
+        }
+    }
+    P2PSessionInfos infos;
+    for (auto const& session : network->sessionInfos(m_nodeID))
+    {
+        if (std::find(nodeList.begin(), nodeList.end(), session.nodeID) != nodeList.end())
+        {
+            infos.push_back(session);
+        }
+    }
+    return infos;
+}
+
+bool SimulatedService::isConnected(NodeID const& _nodeID) const
+{
+    auto network = m_network.lock();
+    if (!network)
+    {
+        return false;
+    }
+    for (auto const& session : network->sessionInfos(m_nodeID))
+    {
+        if (session.nodeID == _nodeID)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+h512s SimulatedService::getNodeListByGroupID(GROUP_ID _groupID)
+{
+    ReadGuard l(x_nodeList);
+    auto it = m_groupID2NodeList.find(_groupID);
+    if (it == m_groupID2NodeList.end())
+    {
+        return h512s();
+    }
+    return it->second;
+}
+
+void SimulatedService::setGroupID2NodeList(std::map<GROUP_ID, h512s> _groupID2NodeList)
+{
+    WriteGuard l(x_nodeList);
+    m_groupID2NodeList = _groupID2NodeList;
+}
+
+void SimulatedService::setNodeListByGroupID(GROUP_ID _groupID, h512s _nodeList)
+{
+    WriteGuard l(x_nodeList);
+    m_groupID2NodeList[_groupID] = _nodeList;
+}
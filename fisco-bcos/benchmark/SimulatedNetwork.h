@@ -0,0 +1,233 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2018 fisco-dev contributors.
+ */
+
+/**
+ * @brief: in-process network connecting the nodes of the consensus benchmark
+ * @file: SimulatedNetwork.h
+ */
+#pragma once
+#include <libdevcore/Guards.h>
+#include <libnetwork/SessionFace.h>
+#include <libp2p/P2PInterface.h>
+#include <libp2p/P2PMessage.h>
+#include <libp2p/P2PSession.h>
+#include <atomic>
+#include <condition_variable>
+#include <map>
+#include <queue>
+#include <random>
+#include <thread>
+#include <tuple>
+
+#define SIMNET_LOG(LEVEL) LOG(LEVEL) << "[BENCHMARK][SimulatedNetwork]"
+
+namespace dev
+{
+namespace benchmark
+{
+/// the model of the directed link between two nodes
+struct LinkModel
+{
+    /// one-way propagation delay
+    unsigned latency = 0;  // ms
+    /// bytes per second, 0 means unlimited
+    uint64_t bandwidth = 0;
+    /// the probability of dropping a message
+    double loss = 0;
+};
+
+/// the session through which the handlers of the receiver get the sender
+class SimulatedSession : public dev::network::SessionFace
+{
+public:
+    SimulatedSession(dev::network::NodeIPEndpoint const& _endpoint) : m_endpoint(_endpoint) {}
+    void start() override {}
+    void disconnect(dev::network::DisconnectReason) override {}
+    bool isConnected() const override { return true; }
+    void asyncSendMessage(
+        dev::network::Message::Ptr, dev::network::Options, CallbackFunc) override
+    {}
+    std::shared_ptr<dev::network::SocketFace> socket() override { return nullptr; }
+    void setMessageHandler(std::function<void(dev::network::NetworkException,
+            std::shared_ptr<dev::network::SessionFace>, dev::network::Message::Ptr)>) override
+    {}
+    dev::network::NodeIPEndpoint nodeIPEndpoint() const override { return m_endpoint; }
+    bool actived() const override { return true; }
+
+private:
+    dev::network::NodeIPEndpoint m_endpoint;
+};
+
+class SimulatedService;
+
+/**
+ * routes the messages between the SimulatedServices of one process, every message is delayed by
+ * the latency of its link plus the time spent queueing behind the earlier messages of the link,
+ * and dropped with the loss probability of the link. Every link draws its losses from its own
+ * random source derived from the seed, so that a run with the same seed drops the same messages
+ * of every link whatever the interleaving of the sending threads.
+ */
+class SimulatedNetwork : public std::enable_shared_from_this<SimulatedNetwork>
+{
+public:
+    using Ptr = std::shared_ptr<SimulatedNetwork>;
+    /// called for every message sent, before the link model is applied
+    using SendObserver = std::function<void(
+        dev::p2p::NodeID const&, dev::p2p::NodeID const&, dev::p2p::P2PMessage::Ptr)>;
+
+    SimulatedNetwork(LinkModel const& _defaultLink, uint64_t _seed)
+      : m_defaultLink(_defaultLink), m_seed(_seed)
+    {}
+    virtual ~SimulatedNetwork() { stop(); }
+
+    /// create the service of the node and connect it to all the existing nodes
+    std::shared_ptr<SimulatedService> addNode(dev::p2p::NodeID const& _nodeID);
+    /// override the model of the link from _from to _to
+    void setLink(
+        dev::p2p::NodeID const& _from, dev::p2p::NodeID const& _to, LinkModel const& _link);
+    void setSendObserver(SendObserver const& _observer) { m_sendObserver = _observer; }
+
+    void start();
+    void stop();
+
+    void send(dev::p2p::NodeID const& _from, dev::p2p::NodeID const& _to,
+        dev::p2p::P2PMessage::Ptr _message);
+    dev::p2p::P2PSessionInfos sessionInfos(dev::p2p::NodeID const& _nodeID) const;
+
+    uint64_t sentMessages() const { return m_sentMessages; }
+    uint64_t droppedMessages() const { return m_droppedMessages; }
+    uint64_t sentBytes() const { return m_sentBytes; }
+
+private:
+    struct Delivery
+    {
+        std::chrono::steady_clock::time_point deliverTime;
+        /// keeps the messages of the same deliver time in sending order
+        uint64_t seq;
+        dev::p2p::NodeID from;
+        dev::p2p::NodeID to;
+        dev::p2p::P2PMessage::Ptr message;
+        bool operator>(Delivery const& _other) const
+        {
+            return std::tie(deliverTime, seq) > std::tie(_other.deliverTime, _other.seq);
+        }
+    };
+
+    void deliverLoop();
+    void deliver(Delivery const& _delivery);
+    LinkModel const& link(dev::p2p::NodeID const& _from, dev::p2p::NodeID const& _to) const;
+    /// the random source of the link, the caller must hold x_deliveries
+    std::mt19937_64& linkRandom(dev::p2p::NodeID const& _from, dev::p2p::NodeID const& _to);
+
+    LinkModel m_defaultLink;
+    std::map<std::pair<dev::p2p::NodeID, dev::p2p::NodeID>, LinkModel> m_links;
+    /// the time the link finishes transmitting the messages queued on it
+    std::map<std::pair<dev::p2p::NodeID, dev::p2p::NodeID>, std::chrono::steady_clock::time_point>
+        m_linkBusyUntil;
+    std::map<dev::p2p::NodeID, std::shared_ptr<SimulatedService>> m_services;
+    /// the session the receivers see the node through
+    std::map<dev::p2p::NodeID, dev::p2p::P2PSession::Ptr> m_sessions;
+    mutable SharedMutex x_services;
+
+    std::priority_queue<Delivery, std::vector<Delivery>, std::greater<Delivery>> m_deliveries;
+    uint64_t m_seed;
+    std::map<std::pair<dev::p2p::NodeID, dev::p2p::NodeID>, std::mt19937_64> m_linkRandom;
+    uint64_t m_seq = 0;
+    std::mutex x_deliveries;
+    std::condition_variable m_signalled;
+    std::thread m_deliverThread;
+    bool m_running = false;
+
+    SendObserver m_sendObserver;
+    std::atomic<uint64_t> m_sentMessages = {0};
+    std::atomic<uint64_t> m_droppedMessages = {0};
+    std::atomic<uint64_t> m_sentBytes = {0};
+};
+
+/// the P2PInterface of one node over the SimulatedNetwork, only the interfaces used by the
+/// consensus and the txpool are supported
+class SimulatedService : public dev::p2p::P2PInterface
+{
+public:
+    using Ptr = std::shared_ptr<SimulatedService>;
+    SimulatedService(std::weak_ptr<SimulatedNetwork> _network, dev::p2p::NodeID const& _nodeID)
+      : m_network(_network),
+        m_nodeID(_nodeID),
+        m_messageFactory(std::make_shared<dev::p2p::P2PMessageFactory>())
+    {}
+
+    dev::p2p::NodeID id() const override { return m_nodeID; }
+
+    std::shared_ptr<dev::p2p::P2PMessage> sendMessageByNodeID(
+        dev::p2p::NodeID, std::shared_ptr<dev::p2p::P2PMessage>) override
+    {
+        return nullptr;
+    }
+    void asyncSendMessageByNodeID(dev::p2p::NodeID _nodeID,
+        std::shared_ptr<dev::p2p::P2PMessage> _message, CallbackFuncWithSession,
+        dev::network::Options = dev::network::Options()) override;
+
+    std::shared_ptr<dev::p2p::P2PMessage> sendMessageByTopic(
+        std::string, std::shared_ptr<dev::p2p::P2PMessage>) override
+    {
+        return nullptr;
+    }
+    void asyncSendMessageByTopic(std::string, std::shared_ptr<dev::p2p::P2PMessage>,
+        CallbackFuncWithSession, dev::network::Options) override
+    {}
+    void asyncMulticastMessageByTopic(std::string, std::shared_ptr<dev::p2p::P2PMessage>) override
+    {}
+    void asyncMulticastMessageByNodeIDList(
+        dev::p2p::NodeIDs _nodeIDs, std::shared_ptr<dev::p2p::P2PMessage> _message) override;
+    void asyncBroadcastMessage(
+        std::shared_ptr<dev::p2p::P2PMessage> _message, dev::network::Options) override;
+
+    void registerHandlerByProtoclID(
+        dev::PROTOCOL_ID _protocolID, CallbackFuncWithSession _handler) override;
+    void registerHandlerByTopic(std::string, CallbackFuncWithSession) override {}
+
+    dev::p2p::P2PSessionInfos sessionInfos() override;
+    dev::p2p::P2PSessionInfos sessionInfosByProtocolID(dev::PROTOCOL_ID) const override;
+    bool isConnected(dev::p2p::NodeID const& _nodeID) const override;
+
+    std::vector<std::string> topics() override { return std::vector<std::string>(); }
+    void setTopics(std::shared_ptr<std::vector<std::string>>) override {}
+
+    dev::h512s getNodeListByGroupID(dev::GROUP_ID _groupID) override;
+    void setGroupID2NodeList(std::map<dev::GROUP_ID, dev::h512s> _groupID2NodeList) override;
+    void setNodeListByGroupID(dev::GROUP_ID _groupID, dev::h512s _nodeList) override;
+
+    std::shared_ptr<dev::p2p::P2PMessageFactory> p2pMessageFactory() override
+    {
+        return m_messageFactory;
+    }
+
+    /// called by the network thread with the message delivered through _session
+    void onMessage(dev::p2p::P2PSession::Ptr _session, dev::p2p::P2PMessage::Ptr _message);
+
+private:
+    std::weak_ptr<SimulatedNetwork> m_network;
+    dev::p2p::NodeID m_nodeID;
+    std::shared_ptr<dev::p2p::P2PMessageFactory> m_messageFactory;
+
+    std::map<dev::PROTOCOL_ID, CallbackFuncWithSession> m_handlers;
+    mutable SharedMutex x_handlers;
+    std::map<dev::GROUP_ID, dev::h512s> m_groupID2NodeList;
+    mutable SharedMutex x_nodeList;
+};
+}  // namespace benchmark
+}  // namespace dev
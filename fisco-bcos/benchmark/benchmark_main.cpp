@@ -0,0 +1,226 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2018 fisco-dev contributors.
+ */
+
+/**
+ * @brief: runs N consensus nodes in one process over a simulated network and reports the TPS,
+ *         the latency of every consensus phase and the messages sent
+ * @file: benchmark_main.cpp
+ */
+
+#include "BenchParamParse.h"
+#include "BenchStats.h"
+#include "SimulatedNetwork.h"
+#include <fisco-bcos/Fake.h>
+#include <libconsensus/pbft/PBFTEngine.h>
+#include <libconsensus/pbft/PBFTSealer.h>
+#include <libconsensus/raft/RaftEngine.h>
+#include <libconsensus/raft/RaftSealer.h>
+#include <libdevcore/easylog.h>
+#include <libethcore/Protocol.h>
+#include <libtxpool/TxPool.h>
+#include <boost/filesystem.hpp>
+
+using namespace dev;
+using namespace dev::eth;
+using namespace dev::p2p;
+using namespace dev::consensus;
+using namespace dev::benchmark;
+
+#define BENCHMARK_LOG(LEVEL) LOG(LEVEL) << "[#BENCHMARK_MAIN] "
+
+/// the in-memory chain of one node, all the nodes are sealers
+class BenchBlockChain : public FakeBlockChain
+{
+public:
+    BenchBlockChain(h512s const& _sealerList) : m_sealerList(_sealerList) {}
+    h512s sealerList() override { return m_sealerList; }
+
+private:
+    h512s m_sealerList;
+};
+
+struct BenchNode
+{
+    KeyPair keyPair;
+    std::shared_ptr<SimulatedService> service;
+    std::shared_ptr<BenchBlockChain> blockChain;
+    std::shared_ptr<dev::txpool::TxPool> txPool;
+    std::shared_ptr<Sealer> sealer;
+    Handler<int64_t> onCommit;
+};
+
+static std::vector<std::shared_ptr<BenchNode>> createNodes(Params const& params,
+    SimulatedNetwork::Ptr network, std::shared_ptr<BenchStats> stats, GROUP_ID const& groupId)
+{
+    std::vector<std::shared_ptr<BenchNode>> nodes;
+    h512s sealerList;
+    for (unsigned i = 0; i < params.nodes(); i++)
+    {
+        auto node = std::make_shared<BenchNode>();
+        node->keyPair = KeyPair::create();
+        sealerList.push_back(node->keyPair.pub());
+        nodes.push_back(node);
+    }
+    bool raft = (params.consensus() == "raft");
+    PROTOCOL_ID txPoolId = getGroupProtoclID(groupId, ProtocolID::TxPool);
+    PROTOCOL_ID consensusId =
+        getGroupProtoclID(groupId, raft ? ProtocolID::Raft : ProtocolID::PBFT);
+    for (size_t i = 0; i < nodes.size(); i++)
+    {
+        auto node = nodes[i];
+        node->service = network->addNode(node->keyPair.pub());
+        node->service->setNodeListByGroupID(groupId, sealerList);
+        node->blockChain = std::make_shared<BenchBlockChain>(sealerList);
+        node->txPool =
+            std::make_shared<dev::txpool::TxPool>(node->service, node->blockChain, txPoolId);
+        auto sync = std::make_shared<FakeBlockSync>();
+        auto blockVerifier = std::make_shared<FakeBlockVerifier>();
+        if (raft)
+        {
+            node->sealer = std::make_shared<RaftSealer>(node->service, node->txPool,
+                node->blockChain, sync, blockVerifier, node->keyPair, 1000, 2000, consensusId,
+                sealerList);
+        }
+        else
+        {
+            std::string baseDir = params.dataDir() + "/node" + std::to_string(i);
+            boost::filesystem::create_directories(baseDir);
+            auto pbftSealer = std::make_shared<PBFTSealer>(node->service, node->txPool,
+                node->blockChain, sync, blockVerifier, consensusId, baseDir, node->keyPair,
+                sealerList);
+            auto pbftEngine =
+                std::dynamic_pointer_cast<PBFTEngine>(pbftSealer->consensusEngine());
+            pbftEngine->setIntervalBlockTime(params.blockTime());
+            pbftEngine->setOmitEmptyBlock(true);
+            node->sealer = pbftSealer;
+        }
+        auto blockChain = node->blockChain;
+        node->onCommit = blockChain->onReady([stats, blockChain, i](int64_t) {
+            auto block = blockChain->getBlockByNumber(blockChain->number());
+            if (block)
+            {
+                stats->onCommit(i, *block);
+            }
+        });
+    }
+    return nodes;
+}
+
+/// submit the transactions to all the nodes, as if the txpools were synchronized already
+static void submitTransactions(std::vector<std::shared_ptr<BenchNode>> const& nodes,
+    float txSpeed, uint64_t const& stopTime)
+{
+#ifdef FISCO_GM
+    bytes rlpBytes = fromHex(
+        "f901309f65f0d06e39dc3c08e32ac10a5070858962bc6c0f5760baca823f2d5582d14485174876e7ff8609"
+        "184e729fff8204a294d6f1a71052366dbae2f7ab2d5d5845e77965cf0d80b86448f85bce00000000000000"
+        "0000000000000000000000000000000000000000000000001bf5bd8a9e7ba8b936ea704292ff4aaa5797bf"
+        "671fdc8526dcd159f23c1f5a05f44e9fa862834dc7cb4541558f2b4961dc39eaaf0af7f7395028658d0e01"
+        "b86a37b840c7ca78e7ab80ee4be6d3936ba8e899d8fe12c12114502956ebe8c8629d36d88481dec9973574"
+        "2ea523c88cf3becba1cc4375bc9e225143fe1e8e43abc8a7c493a0ba3ce8383b7c91528bede9cf890b4b1e"
+        "9b99c1d8e56d6f8292c827470a606827a0ed511490a1666791b2bd7fc4f499eb5ff18fb97ba68ff9aee206"
+        "8fd63b88e817");
+#else
+    bytes rlpBytes = fromHex(
+        "f8ef9f65f0d06e39dc3c08e32ac10a5070858962bc6c0f5760baca823f2d5582d03f85174876e7ff"
+        "8609184e729fff82020394d6f1a71052366dbae2f7ab2d5d5845e77965cf0d80b86448f85bce000000"
+        "000000000000000000000000000000000000000000000000000000001bf5bd8a9e7ba8b936ea704292"
+        "ff4aaa5797bf671fdc8526dcd159f23c1f5a05f44e9fa862834dc7cb4541558f2b4961dc39eaaf0af7"
+        "f7395028658d0e01b86a371ca00b2b3fabd8598fefdda4efdb54f626367fc68e1735a8047f0f1c4f84"
+        "0255ca1ea0512500bc29f4cfe18ee1c88683006d73e56c934100b8abf4d2334560e1d2f75e");
+#endif
+    Transaction tx(ref(rlpBytes), CheckTransaction::Everything);
+    Secret sec = KeyPair::create().secret();
+    u256 nonce = u256(utcTime()) << 32;
+    /// submit the transactions of every 10ms together
+    double pending = 0;
+    while (utcTime() < stopTime)
+    {
+        pending += txSpeed / 100;
+        for (; pending >= 1; pending -= 1)
+        {
+            tx.setNonce(nonce++);
+            tx.setBlockLimit(u256(nodes[0]->blockChain->number()) + 500);
+            dev::Signature sig = sign(sec, tx.sha3(WithoutSignature));
+            tx.updateSignature(SignatureStruct(sig));
+            for (auto const& node : nodes)
+            {
+                try
+                {
+                    Transaction nodeTx(tx);
+                    node->txPool->submit(nodeTx);
+                }
+                catch (std::exception& e)
+                {
+                    BENCHMARK_LOG(WARNING) << LOG_DESC("submit transaction failed")
+                                           << LOG_KV("EINFO", boost::diagnostic_information(e));
+                }
+            }
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+}
+
+static void runBenchmark(Params const& params)
+{
+    GROUP_ID groupId = 1;
+    bool raft = (params.consensus() == "raft");
+    PROTOCOL_ID consensusId =
+        getGroupProtoclID(groupId, raft ? ProtocolID::Raft : ProtocolID::PBFT);
+    auto stats = std::make_shared<BenchStats>(consensusId, raft);
+
+    LinkModel link;
+    link.latency = params.latency();
+    link.bandwidth = params.bandwidth();
+    link.loss = params.loss();
+    auto network = std::make_shared<SimulatedNetwork>(link, params.seed());
+    network->setSendObserver(
+        [stats](NodeID const&, NodeID const&, P2PMessage::Ptr _message) {
+            stats->onSend(_message);
+        });
+
+    auto nodes = createNodes(params, network, stats, groupId);
+    network->start();
+    for (auto const& node : nodes)
+    {
+        node->sealer->start();
+    }
+    stats->start();
+    std::cout << "running " << params.nodes() << " " << params.consensus() << " nodes for "
+              << params.duration() << "s, latency=" << params.latency()
+              << "ms bandwidth=" << params.bandwidth() << "B/s loss=" << params.loss()
+              << std::endl;
+    submitTransactions(nodes, params.txSpeed(), utcTime() + params.duration() * 1000);
+    stats->stop();
+
+    for (auto const& node : nodes)
+    {
+        node->sealer->stop();
+    }
+    network->stop();
+    stats->report(std::cout);
+    std::cout << "network: sent=" << network->sentMessages()
+              << " dropped=" << network->droppedMessages() << " bytes=" << network->sentBytes()
+              << std::endl;
+}
+
+int main(int argc, const char* argv[])
+{
+    Params params = initCommandLine(argc, argv);
+    runBenchmark(params);
+    return 0;
+}
@@ -186,6 +186,17 @@ int64_t BlockChainImp::number()
     return m_blockNumber;
 }
 
+void BlockChainImp::reloadFromStorage()
+{
+    {
+        WriteGuard l(m_blockNumberMutex);
+        m_blockNumber = -1;
+    }
+    int64_t num = number();
+    BLOCKCHAIN_LOG(INFO) << LOG_DESC("[#reloadFromStorage]") << LOG_KV("number", num);
+    m_onReady(num);
+}
+
 int64_t BlockChainImp::obtainNumber()
 {
     int64_t num = 0;
@@ -588,6 +599,52 @@ std::shared_ptr<Block> BlockChainImp::getBlockByNumber(int64_t _i)
     }
 }
 
+std::vector<bytes> BlockChainImp::getBlockRLPsByNumber(int64_t _from, int64_t _size)
+{
+    std::vector<bytes> blockRLPs;
+    int64_t to = min(_from + _size - 1, number());
+    if (_from < 0 || to < _from)
+    {
+        return blockRLPs;
+    }
+
+    /// read the hashes of the range, then the blocks stored in the same encoding as sent
+    auto memoryTableFactory = getMemoryTableFactory();
+    std::vector<std::string> blockHashes;
+    Table::Ptr tb = memoryTableFactory->openTable(SYS_NUMBER_2_HASH);
+    if (!tb)
+    {
+        return blockRLPs;
+    }
+    for (int64_t i = _from; i <= to; i++)
+    {
+        auto entries = tb->select(lexical_cast<std::string>(i), tb->newCondition());
+        if (entries->size() == 0)
+        {
+            break;
+        }
+        blockHashes.push_back(h256(entries->get(0)->getField(SYS_VALUE)).hex());
+    }
+
+    tb = memoryTableFactory->openTable(SYS_HASH_2_BLOCK);
+    if (!tb)
+    {
+        return blockRLPs;
+    }
+    for (auto const& blockHash : blockHashes)
+    {
+        auto entries = tb->select(blockHash, tb->newCondition());
+        if (entries->size() == 0)
+        {
+            BLOCKCHAIN_LOG(TRACE) << LOG_DESC("[#getBlockRLPsByNumber]Can't find the block")
+                                  << LOG_KV("blockHash", blockHash);
+            break;
+        }
+        blockRLPs.push_back(fromHex(entries->get(0)->getField(SYS_VALUE)));
+    }
+    return blockRLPs;
+}
+
 Transaction BlockChainImp::getTxByHash(dev::h256 const& _txHash)
 {
     string strblock = "";
@@ -69,6 +69,20 @@ public:
         dev::h256 const& _txHash) = 0;
     virtual std::shared_ptr<dev::eth::Block> getBlockByHash(dev::h256 const& _blockHash) = 0;
     virtual std::shared_ptr<dev::eth::Block> getBlockByNumber(int64_t _i) = 0;
+    /// the encoded blocks in [_from, _from + _size), stops at the first block not found
+    virtual std::vector<dev::bytes> getBlockRLPsByNumber(int64_t _from, int64_t _size)
+    {
+        std::vector<dev::bytes> blockRLPs;
+        int64_t to = std::min(_from + _size - 1, number());
+        for (int64_t i = _from; i <= to; i++)
+        {
+            auto block = getBlockByNumber(i);
+            if (!block || block->header().number() != i)
+                break;
+            blockRLPs.push_back(block->rlp());
+        }
+        return blockRLPs;
+    }
     virtual CommitResult commitBlock(
         dev::eth::Block& block, std::shared_ptr<dev::blockverifier::ExecutiveContext>) = 0;
     virtual std::pair<int64_t, int64_t> totalTransactionCount() = 0;
@@ -85,6 +99,8 @@ public:
     virtual dev::h512s observerList() = 0;
     /// get system config
     virtual std::string getSystemConfigByKey(std::string const& key, int64_t number = -1) = 0;
+    /// reload the cached state after the storage was written by others, e.g. a state snapshot
+    virtual void reloadFromStorage() {}
 
     /// Register a handler that will be called once there is a new transaction imported
     template <class T>
@@ -46,38 +46,14 @@ ExecutiveContext::Ptr BlockVerifier::executeBlock(Block& block, BlockInfo const&
                             << LOG_KV("parentNum", parentBlockInfo.number)
                             << LOG_KV("parentStateRoot", parentBlockInfo.stateRoot);
 
-    ExecutiveContext::Ptr executiveContext = std::make_shared<ExecutiveContext>();
-    try
-    {
-        m_executiveContextFactory->initExecutiveContext(
-            parentBlockInfo, parentBlockInfo.stateRoot, executiveContext);
-    }
-    catch (exception& e)
-    {
-        BLOCKVERIFIER_LOG(ERROR) << LOG_DESC("[#executeBlock] Error during initExecutiveContext")
-                                 << LOG_KV("EINFO", boost::diagnostic_information(e));
-
-        BOOST_THROW_EXCEPTION(InvalidBlockWithBadStateOrReceipt()
-                              << errinfo_comment("Error during initExecutiveContext"));
-    }
-
+    ExecutiveContext::Ptr executiveContext = createExecutiveContext(parentBlockInfo);
     BlockHeader tmpHeader = block.blockHeader();
     block.clearAllReceipts();
     for (Transaction const& tr : block.transactions())
     {
-        EnvInfo envInfo(block.blockHeader(), m_pNumberHash,
-            block.getTransactionReceipts().size() > 0 ?
-                block.getTransactionReceipts().back().gasUsed() :
-                0);
-        envInfo.setPrecompiledEngine(executiveContext);
-        std::pair<ExecutionResult, TransactionReceipt> resultReceipt =
-            execute(envInfo, tr, OnOpFunc(), executiveContext);
-        block.appendTransactionReceipt(resultReceipt.second);
-        executiveContext->getState()->commit();
+        executeNextTransaction(block, tr, executiveContext);
     }
-    block.calReceiptRoot();
-    block.header().setStateRoot(executiveContext->getState()->rootHash());
-    block.header().setDBhash(executiveContext->getMemoryTableFactory()->hash());
+    finalizeExecutedBlock(block, executiveContext);
     /// if executeBlock is called by consensus module, no need to compare receiptRoot and stateRoot
     /// since origin value is empty if executeBlock is called by sync module, need to compare
     /// receiptRoot, stateRoot and dbHash
@@ -102,6 +78,59 @@ ExecutiveContext::Ptr BlockVerifier::executeBlock(Block& block, BlockInfo const&
     return executiveContext;
 }
 
+ExecutiveContext::Ptr BlockVerifier::createExecutiveContext(BlockInfo const& parentBlockInfo)
+{
+    ExecutiveContext::Ptr executiveContext = std::make_shared<ExecutiveContext>();
+    try
+    {
+        m_executiveContextFactory->initExecutiveContext(
+            parentBlockInfo, parentBlockInfo.stateRoot, executiveContext);
+    }
+    catch (exception& e)
+    {
+        BLOCKVERIFIER_LOG(ERROR) << LOG_DESC("[#executeBlock] Error during initExecutiveContext")
+                                 << LOG_KV("EINFO", boost::diagnostic_information(e));
+
+        BOOST_THROW_EXCEPTION(InvalidBlockWithBadStateOrReceipt()
+                              << errinfo_comment("Error during initExecutiveContext"));
+    }
+    return executiveContext;
+}
+
+void BlockVerifier::executeNextTransaction(
+    Block& block, Transaction const& _t, ExecutiveContext::Ptr executiveContext)
+{
+    EnvInfo envInfo(block.blockHeader(), m_pNumberHash,
+        block.getTransactionReceipts().size() > 0 ?
+            block.getTransactionReceipts().back().gasUsed() :
+            0);
+    envInfo.setPrecompiledEngine(executiveContext);
+    /// the changes of the transaction failed are reverted, so the block being packed can go on
+    /// without it
+    auto stateSavepoint = executiveContext->getState()->savepoint();
+    auto tableSavepoint = executiveContext->getMemoryTableFactory()->savepoint();
+    std::pair<ExecutionResult, TransactionReceipt> resultReceipt;
+    try
+    {
+        resultReceipt = execute(envInfo, _t, OnOpFunc(), executiveContext);
+    }
+    catch (...)
+    {
+        executiveContext->getState()->rollback(stateSavepoint);
+        executiveContext->getMemoryTableFactory()->rollback(tableSavepoint);
+        throw;
+    }
+    block.appendTransactionReceipt(resultReceipt.second);
+    executiveContext->getState()->commit();
+}
+
+void BlockVerifier::finalizeExecutedBlock(Block& block, ExecutiveContext::Ptr executiveContext)
+{
+    block.calReceiptRoot();
+    block.header().setStateRoot(executiveContext->getState()->rootHash());
+    block.header().setDBhash(executiveContext->getMemoryTableFactory()->hash());
+}
+
 std::pair<ExecutionResult, TransactionReceipt> BlockVerifier::executeTransaction(
     const BlockHeader& blockHeader, dev::eth::Transaction const& _t)
 {
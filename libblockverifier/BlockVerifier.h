@@ -65,6 +65,12 @@ public:
     std::pair<dev::executive::ExecutionResult, dev::eth::TransactionReceipt> executeTransaction(
         const dev::eth::BlockHeader& blockHeader, dev::eth::Transaction const& _t);
 
+    ExecutiveContext::Ptr createExecutiveContext(BlockInfo const& parentBlockInfo) override;
+    void executeNextTransaction(dev::eth::Block& block, dev::eth::Transaction const& _t,
+        ExecutiveContext::Ptr executiveContext) override;
+    void finalizeExecutedBlock(
+        dev::eth::Block& block, ExecutiveContext::Ptr executiveContext) override;
+
     std::pair<dev::executive::ExecutionResult, dev::eth::TransactionReceipt> execute(
         dev::eth::EnvInfo const& _envInfo, dev::eth::Transaction const& _t,
         dev::eth::OnOpFunc const& _onOp,
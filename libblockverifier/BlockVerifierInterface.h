@@ -54,6 +54,17 @@ public:
     virtual std::pair<dev::executive::ExecutionResult, dev::eth::TransactionReceipt>
     executeTransaction(
         const dev::eth::BlockHeader& blockHeader, dev::eth::Transaction const& _t) = 0;
+
+    /// the interfaces to execute the block transaction by transaction while it is being packed
+    /// create the context to execute the block on top of the state of its parent
+    virtual ExecutiveContext::Ptr createExecutiveContext(BlockInfo const& parentBlockInfo) = 0;
+    /// execute the transaction as the next one of the block and append its receipt to the block,
+    /// throw and leave the context unchanged if the transaction can't be executed
+    virtual void executeNextTransaction(dev::eth::Block& block, dev::eth::Transaction const& _t,
+        ExecutiveContext::Ptr executiveContext) = 0;
+    /// set the receipt root, state root and dbHash of the executed block
+    virtual void finalizeExecutedBlock(
+        dev::eth::Block& block, ExecutiveContext::Ptr executiveContext) = 0;
 };
 
 }  // namespace blockverifier
@@ -44,6 +44,10 @@ void dev::channel::ChannelServer::run()
         boost::asio::socket_base::reuse_address optionReuseAddress(true);
         _acceptor->set_option(optionReuseAddress);
     }
+    if (_ioServicePool)
+    {
+        _ioServicePool->start();
+    }
 
     _serverThread = std::make_shared<std::thread>([=]() {
         pthread_setThreadName("ChannelServer");
@@ -128,13 +132,15 @@ void dev::channel::ChannelServer::startAccept()
     {
         ChannelSession::Ptr session = std::make_shared<ChannelSession>();
         session->setThreadPool(_threadPool);
-        session->setIOService(_ioService);
+        /// the socket and the timers of the session run on the same thread
+        auto ioService = _ioServicePool ? _ioServicePool->next() : _ioService;
+        session->setIOService(ioService);
         session->setEnableSSL(_enableSSL);
         session->setMessageFactory(_messageFactory);
 
         session->setSSLSocket(
             std::make_shared<boost::asio::ssl::stream<boost::asio::ip::tcp::socket> >(
-                *_ioService, *_sslContext));
+                *ioService, *_sslContext));
 
         _acceptor->async_accept(session->sslSocket()->lowest_layer(),
             boost::bind(&ChannelServer::onAccept, shared_from_this(),
@@ -177,6 +183,10 @@ void dev::channel::ChannelServer::stop()
         ;
     }
     _serverThread->join();
+    if (_ioServicePool)
+    {
+        _ioServicePool->stop();
+    }
 }
 
 void dev::channel::ChannelServer::onHandshake(
@@ -37,6 +37,7 @@
 #include "ChannelException.h"
 #include "ChannelSession.h"
 #include "Message.h"
+#include "libdevcore/IOServicePool.h"
 #include "libdevcore/ThreadPool.h"
 
 namespace dev
@@ -72,6 +73,12 @@ public:
     {
         _ioService = ioService;
     };
+    /// the sessions run on the pool if it's set, the acceptor runs on ioService
+    void setIOServicePool(std::shared_ptr<dev::IOServicePool> ioServicePool)
+    {
+        _ioServicePool = ioServicePool;
+    };
+    std::shared_ptr<dev::IOServicePool> ioServicePool() { return _ioServicePool; }
     void setSSLContext(std::shared_ptr<boost::asio::ssl::context> sslContext)
     {
         _sslContext = sslContext;
@@ -86,6 +93,7 @@ private:
     void onHandshake(const boost::system::error_code& error, ChannelSession::Ptr session);
 
     std::shared_ptr<boost::asio::io_service> _ioService;
+    std::shared_ptr<dev::IOServicePool> _ioServicePool;
     std::shared_ptr<boost::asio::ssl::context> _sslContext;
 
     std::shared_ptr<std::thread> _serverThread;
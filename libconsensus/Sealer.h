@@ -113,7 +113,7 @@ protected:
     virtual bool shouldSeal();
     virtual bool shouldWait(bool const& wait) const;
     /// load transactions from transaction pool
-    void loadTransactions(uint64_t const& transToFetch);
+    virtual void loadTransactions(uint64_t const& transToFetch);
     virtual uint64_t calculateMaxPackTxNum() { return m_consensusEngine->maxBlockTransactions(); }
     virtual bool checkTxsEnough(uint64_t maxTxsCanSeal)
     {
@@ -49,6 +49,12 @@ enum PBFTPacketType : byte
     SignReqPacket = 0x01,
     CommitReqPacket = 0x02,
     ViewChangeReqPacket = 0x03,
+    /// prepare request carrying the block header and the transaction hashes
+    CompactPrepareReqPacket = 0x04,
+    /// request the transactions missed when rebuilding a compact prepare
+    GetMissedTxsPacket = 0x05,
+    /// response to GetMissedTxsPacket
+    MissedTxsPacket = 0x06,
     PBFTPacketCount
 };
 
@@ -70,6 +76,9 @@ struct PBFTMsgPacket
     u256 timestamp;
     /// endpoint
     std::string endpoint;
+    /// the sender whose signatures have been checked by the pre-verification stage
+    /// (not sent across the network)
+    h512 signVerifiedBy = h512();
     /// default constructor
     PBFTMsgPacket()
       : node_idx(0), node_id(h512(0)), packet_id(0), ttl(MAXTTL), timestamp(u256(utcTime()))
@@ -154,6 +163,9 @@ struct PBFTMsg
     Signature sig = Signature();
     /// signature to the hash of other fields except block_hash, sig and sig2
     Signature sig2 = Signature();
+    /// the sender whose signatures have been checked by the pre-verification stage
+    /// (not sent across the network)
+    h512 signVerifiedBy = h512();
     PBFTMsg() = default;
     PBFTMsg(KeyPair const& _keyPair, int64_t const& _height, VIEWTYPE const& _view,
         IDXTYPE const& _idx, h256 const _blockHash)
@@ -238,6 +250,7 @@ struct PBFTMsg
         block_hash = h256();
         sig = Signature();
         sig2 = Signature();
+        signVerifiedBy = h512();
     }
 
     /// get the hash of the fields without block_hash, sig and sig2
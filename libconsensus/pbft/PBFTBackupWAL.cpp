@@ -0,0 +1,309 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2018 fisco-dev contributors.
+ */
+/**
+ * @brief : append-only write-ahead log backing up the PBFT messages
+ * @file: PBFTBackupWAL.cpp
+ */
+#include "PBFTBackupWAL.h"
+#include <fcntl.h>
+#include <libdevcore/CommonIO.h>
+#include <libdevcore/RLP.h>
+#include <unistd.h>
+#include <boost/crc.hpp>
+#include <boost/filesystem.hpp>
+#include <cstdio>
+
+using namespace dev;
+using namespace dev::consensus;
+
+namespace
+{
+size_t const c_walRecordHeaderSize = 8;
+
+uint32_t crc32(bytesConstRef _data)
+{
+    boost::crc_32_type crc;
+    crc.process_bytes(_data.data(), _data.size());
+    return crc.checksum();
+}
+
+void putUint32(bytes& _out, uint32_t _value)
+{
+    for (int i = 3; i >= 0; i--)
+    {
+        _out.push_back((byte)(_value >> (8 * i)));
+    }
+}
+
+uint32_t getUint32(byte const* _in)
+{
+    return ((uint32_t)_in[0] << 24) | ((uint32_t)_in[1] << 16) | ((uint32_t)_in[2] << 8) |
+           (uint32_t)_in[3];
+}
+
+/// fsync the directory containing _path, so that a rename to _path survives a crash
+bool syncParentDir(std::string const& _path)
+{
+    std::string dir = boost::filesystem::path(_path).parent_path().string();
+    int fd = ::open(dir.empty() ? "." : dir.c_str(), O_RDONLY | O_DIRECTORY);
+    if (fd < 0)
+    {
+        return false;
+    }
+    bool ret = (::fsync(fd) == 0);
+    ::close(fd);
+    return ret;
+}
+}  // namespace
+
+WALSyncPolicy PBFTBackupWAL::toSyncPolicy(std::string const& _policy)
+{
+    if (_policy == "always")
+    {
+        return WALSyncPolicy::Always;
+    }
+    if (_policy == "batch")
+    {
+        return WALSyncPolicy::Batch;
+    }
+    return WALSyncPolicy::None;
+}
+
+void PBFTBackupWAL::open()
+{
+    {
+        Guard l(x_wal);
+        if (m_fd >= 0)
+        {
+            return;
+        }
+        m_fd = ::open(m_path.c_str(), O_RDWR | O_CREAT | O_APPEND, 0644);
+        if (m_fd < 0)
+        {
+            BOOST_THROW_EXCEPTION(
+                OpenPBFTWALFailed() << errinfo_comment("open " + m_path + " failed"));
+        }
+        bytes content = contents(m_path);
+        m_records.clear();
+        m_fileSize = recover(content);
+        /// drop the record torn by the crash
+        if (m_fileSize < content.size())
+        {
+            PBFTWAL_LOG(WARNING) << LOG_DESC("open: truncate the invalid tail")
+                                 << LOG_KV("path", m_path) << LOG_KV("fileSize", content.size())
+                                 << LOG_KV("validSize", m_fileSize);
+            if (::ftruncate(m_fd, m_fileSize) != 0)
+            {
+                BOOST_THROW_EXCEPTION(
+                    OpenPBFTWALFailed() << errinfo_comment("truncate " + m_path + " failed"));
+            }
+        }
+        PBFTWAL_LOG(INFO) << LOG_DESC("open") << LOG_KV("path", m_path)
+                          << LOG_KV("records", m_records.size()) << LOG_KV("size", m_fileSize);
+    }
+    if (m_policy == WALSyncPolicy::Batch)
+    {
+        startWorking();
+    }
+}
+
+void PBFTBackupWAL::close()
+{
+    if (isWorking())
+    {
+        stopWorking();
+    }
+    Guard l(x_wal);
+    if (m_fd < 0)
+    {
+        return;
+    }
+    if (m_policy != WALSyncPolicy::None)
+    {
+        ::fsync(m_fd);
+    }
+    ::close(m_fd);
+    m_fd = -1;
+}
+
+uint64_t PBFTBackupWAL::recover(bytes const& _content)
+{
+    uint64_t offset = 0;
+    while (offset + c_walRecordHeaderSize <= _content.size())
+    {
+        uint32_t length = getUint32(&_content[offset]);
+        uint32_t checksum = getUint32(&_content[offset + 4]);
+        if (offset + c_walRecordHeaderSize + length > _content.size())
+        {
+            break;
+        }
+        bytesConstRef payload = ref(_content).cropped(offset + c_walRecordHeaderSize, length);
+        if (crc32(payload) != checksum)
+        {
+            break;
+        }
+        try
+        {
+            RLP rlp(payload);
+            m_records[rlp[0].toString()] = rlp[1].toBytes();
+        }
+        catch (std::exception const&)
+        {
+            break;
+        }
+        offset += c_walRecordHeaderSize + length;
+    }
+    return offset;
+}
+
+void PBFTBackupWAL::encodeRecord(std::string const& _key, bytesConstRef _data, bytes& _out)
+{
+    RLPStream s;
+    s.appendList(2) << _key << _data;
+    bytes payload;
+    s.swapOut(payload);
+    putUint32(_out, payload.size());
+    putUint32(_out, crc32(ref(payload)));
+    _out.insert(_out.end(), payload.begin(), payload.end());
+}
+
+bool PBFTBackupWAL::writeAll(int _fd, bytesConstRef _data)
+{
+    size_t written = 0;
+    while (written < _data.size())
+    {
+        ssize_t ret = ::write(_fd, _data.data() + written, _data.size() - written);
+        if (ret < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            return false;
+        }
+        written += ret;
+    }
+    return true;
+}
+
+bool PBFTBackupWAL::append(std::string const& _key, bytesConstRef _data)
+{
+    bytes record;
+    encodeRecord(_key, _data, record);
+    Guard l(x_wal);
+    if (m_fd < 0)
+    {
+        PBFTWAL_LOG(ERROR) << LOG_DESC("append: the log is not open") << LOG_KV("path", m_path)
+                           << LOG_KV("key", _key);
+        return false;
+    }
+    if (!writeAll(m_fd, ref(record)))
+    {
+        PBFTWAL_LOG(ERROR) << LOG_DESC("append failed") << LOG_KV("path", m_path)
+                           << LOG_KV("errno", errno);
+        /// drop the partially written record, it is truncated when opened otherwise
+        if (::ftruncate(m_fd, m_fileSize) != 0)
+        {
+            PBFTWAL_LOG(ERROR) << LOG_DESC("append: truncate failed") << LOG_KV("errno", errno);
+        }
+        return false;
+    }
+    m_fileSize += record.size();
+    m_records[_key] = _data.toBytes();
+    if (m_policy == WALSyncPolicy::Always)
+    {
+        ::fsync(m_fd);
+    }
+    else if (m_policy == WALSyncPolicy::Batch)
+    {
+        m_dirty = true;
+    }
+    if (m_fileSize > m_compactSize)
+    {
+        compact();
+    }
+    return true;
+}
+
+bytes PBFTBackupWAL::lookup(std::string const& _key) const
+{
+    Guard l(x_wal);
+    auto it = m_records.find(_key);
+    if (it == m_records.end())
+    {
+        return bytes();
+    }
+    return it->second;
+}
+
+void PBFTBackupWAL::sync()
+{
+    Guard l(x_wal);
+    if (m_fd >= 0)
+    {
+        ::fsync(m_fd);
+    }
+    m_dirty = false;
+}
+
+/// flush all the records appended since the last interval with one fsync
+void PBFTBackupWAL::doWork()
+{
+    if (m_dirty)
+    {
+        sync();
+    }
+}
+
+void PBFTBackupWAL::compact()
+{
+    bytes content;
+    for (auto const& record : m_records)
+    {
+        encodeRecord(record.first, ref(record.second), content);
+    }
+    /// the compacted file is opened for appending before it replaces the log, the old log is
+    /// kept if any step fails, so the records are never appended to a closed file
+    std::string tmpPath = m_path + ".tmp";
+    int fd = ::open(tmpPath.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_APPEND, 0644);
+    if (fd < 0 || !writeAll(fd, ref(content)) || ::fsync(fd) != 0 ||
+        std::rename(tmpPath.c_str(), m_path.c_str()) != 0)
+    {
+        PBFTWAL_LOG(ERROR) << LOG_DESC("compact failed, keep appending to the old log")
+                           << LOG_KV("path", tmpPath) << LOG_KV("errno", errno);
+        if (fd >= 0)
+        {
+            ::close(fd);
+            ::unlink(tmpPath.c_str());
+        }
+        /// retry after the log grows as large again
+        m_compactSize = m_fileSize * 2;
+        return;
+    }
+    /// the log has been replaced, the compacted file is used even if the rename is not durable
+    if (!syncParentDir(m_path))
+    {
+        PBFTWAL_LOG(WARNING) << LOG_DESC("compact: sync the directory of the log failed")
+                             << LOG_KV("path", m_path) << LOG_KV("errno", errno);
+    }
+    ::close(m_fd);
+    m_fd = fd;
+    PBFTWAL_LOG(INFO) << LOG_DESC("compact") << LOG_KV("path", m_path)
+                      << LOG_KV("size", m_fileSize) << LOG_KV("compactedSize", content.size());
+    m_fileSize = content.size();
+    m_compactSize = std::max(c_maxWALFileSize, m_fileSize * 2);
+}
@@ -0,0 +1,100 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2018 fisco-dev contributors.
+ */
+/**
+ * @brief : append-only write-ahead log backing up the PBFT messages
+ * @file: PBFTBackupWAL.h
+ */
+#pragma once
+#include <libdevcore/Common.h>
+#include <libdevcore/Exceptions.h>
+#include <libdevcore/Guards.h>
+#include <libdevcore/Worker.h>
+#include <libdevcore/easylog.h>
+#include <map>
+
+#define PBFTWAL_LOG(LEVEL) LOG(LEVEL) << "[CONSENSUS][PBFTWAL]"
+
+namespace dev
+{
+namespace consensus
+{
+DEV_SIMPLE_EXCEPTION(OpenPBFTWALFailed);
+
+/// when to flush the appended records to the disk
+enum class WALSyncPolicy
+{
+    None,   ///< leave it to the operating system
+    Batch,  ///< the syncing thread flushes the records appended in the last interval together
+    Always  ///< flush every record before append returns
+};
+
+/// the log is compacted to the latest record of each key when it grows over the size
+static uint64_t const c_maxWALFileSize = 64 * 1024 * 1024;
+static unsigned const c_walSyncInterval = 50;  // ms
+
+/**
+ * each record is [length(4 bytes)][crc32 of the payload(4 bytes)][payload], the payload is the RLP
+ * list of the key and the data, a later record of the same key overrides the earlier ones
+ */
+class PBFTBackupWAL : public Worker
+{
+public:
+    PBFTBackupWAL(std::string const& _path, WALSyncPolicy const& _policy = WALSyncPolicy::None)
+      : Worker("pbftWALSync", c_walSyncInterval), m_path(_path), m_policy(_policy)
+    {}
+    virtual ~PBFTBackupWAL()
+    {
+        close();
+        terminate();
+    }
+
+    /// open the log and recover the records, the torn or corrupted tail is truncated
+    void open();
+    void close();
+    /// append the record and write it to the file
+    bool append(std::string const& _key, bytesConstRef _data);
+    /// the latest data of the key, empty if not found
+    bytes lookup(std::string const& _key) const;
+    /// flush the written records to the disk
+    void sync();
+
+    uint64_t fileSize() const { return m_fileSize; }
+    static WALSyncPolicy toSyncPolicy(std::string const& _policy);
+
+protected:
+    void doWork() override;
+
+private:
+    /// decode the valid records, return the offset of the end of the last valid record
+    uint64_t recover(bytes const& _content);
+    /// rewrite the log with the latest record of each key
+    void compact();
+    static void encodeRecord(std::string const& _key, bytesConstRef _data, bytes& _out);
+    bool writeAll(int _fd, bytesConstRef _data);
+
+    std::string m_path;
+    WALSyncPolicy m_policy;
+    int m_fd = -1;
+    uint64_t m_fileSize = 0;
+    /// the log is compacted when it grows over the size
+    uint64_t m_compactSize = c_maxWALFileSize;
+    std::atomic_bool m_dirty = {false};
+    std::map<std::string, bytes> m_records;
+    mutable Mutex x_wal;
+};
+}  // namespace consensus
+}  // namespace dev
@@ -30,6 +30,7 @@
 #include <libsecurity/EncryptedLevelDB.h>
 #include <libstorage/Storage.h>
 #include <libtxpool/TxPool.h>
+#include <future>
 using namespace dev::eth;
 using namespace dev::db;
 using namespace dev::blockverifier;
@@ -43,6 +44,8 @@ namespace consensus
 {
 const std::string PBFTEngine::c_backupKeyCommitted = "committed";
 const std::string PBFTEngine::c_backupMsgDirName = "pbftMsgBackup";
+const std::string PBFTEngine::c_backupWALName = "pbft.wal";
+const std::string PBFTEngine::c_backupKeyTimeStats = "timeStats";
 
 void PBFTEngine::start()
 {
@@ -94,6 +97,11 @@ bool PBFTEngine::shouldSeal()
         }
         return false;
     }
+    /// the block of this height has been proposed before the last block committed
+    if (m_pipelinedHeight == m_consensusBlockNumber && m_view == 0)
+    {
+        return false;
+    }
     return true;
 }
 
@@ -157,18 +165,37 @@ void PBFTEngine::initBackupDB()
         boost::filesystem::create_directories(path_handler);
     }
 
-    db::BasicLevelDB* basicDB = NULL;
-    leveldb::Status status;
-
     if (g_BCOSConfig.diskEncryption.enable)
-        status = EncryptedLevelDB::Open(LevelDB::defaultDBOptions(), path_handler.string(),
-            &basicDB, g_BCOSConfig.diskEncryption.cipherDataKey);
+    {
+        db::BasicLevelDB* basicDB = NULL;
+        leveldb::Status status = EncryptedLevelDB::Open(LevelDB::defaultDBOptions(),
+            path_handler.string(), &basicDB, g_BCOSConfig.diskEncryption.cipherDataKey);
+        LevelDB::checkStatus(status, path_handler);
+        m_backupDB = std::make_shared<LevelDB>(basicDB);
+    }
     else
-        status = BasicLevelDB::Open(LevelDB::defaultDBOptions(), path_handler.string(), &basicDB);
-
-    LevelDB::checkStatus(status, path_handler);
-
-    m_backupDB = std::make_shared<LevelDB>(basicDB);
+    {
+        m_backupWAL = std::make_shared<PBFTBackupWAL>(
+            (path_handler / c_backupWALName).string(), m_backupSyncPolicy);
+        m_backupWAL->open();
+        /// migrate the committed prepare backed up by the former LevelDB backup
+        if (m_backupWAL->lookup(c_backupKeyCommitted).empty() &&
+            boost::filesystem::exists(path_handler / "CURRENT"))
+        {
+            db::BasicLevelDB* basicDB = NULL;
+            leveldb::Status status = BasicLevelDB::Open(
+                LevelDB::defaultDBOptions(), path_handler.string(), &basicDB);
+            LevelDB::checkStatus(status, path_handler);
+            LevelDB legacyDB(basicDB);
+            bytes data = fromHex(legacyDB.lookup(c_backupKeyCommitted));
+            if (!data.empty())
+            {
+                m_backupWAL->append(c_backupKeyCommitted, ref(data));
+            }
+            PBFTENGINE_LOG(INFO) << LOG_DESC("initBackupDB: migrate the LevelDB backup")
+                                 << LOG_KV("size", data.size());
+        }
+    }
 
     if (!isDiskSpaceEnough(path))
     {
@@ -178,6 +205,53 @@ void PBFTEngine::initBackupDB()
     }
     // reload msg from db to commited-prepare-cache
     reloadMsg(c_backupKeyCommitted, m_reqCache->mutableCommittedPrepareCache());
+    // reload the timing statistics of the sealers
+    try
+    {
+        bytes timeStats = loadBackupData(c_backupKeyTimeStats);
+        if (!timeStats.empty())
+        {
+            m_timeManager.decodeSealerStats(ref(timeStats));
+        }
+    }
+    catch (std::exception& e)
+    {
+        PBFTENGINE_LOG(WARNING) << LOG_DESC("reload timeStats failed")
+                                << LOG_KV("EINFO", boost::diagnostic_information(e));
+    }
+}
+
+bytes PBFTEngine::loadBackupData(std::string const& _key)
+{
+    if (m_backupWAL)
+    {
+        return m_backupWAL->lookup(_key);
+    }
+    if (m_backupDB)
+    {
+        return fromHex(m_backupDB->lookup(_key));
+    }
+    return bytes();
+}
+
+void PBFTEngine::backupData(std::string const& _key, bytesConstRef _data)
+{
+    try
+    {
+        if (m_backupWAL)
+        {
+            m_backupWAL->append(_key, _data);
+        }
+        else if (m_backupDB)
+        {
+            m_backupDB->insert(_key, toHex(_data));
+        }
+    }
+    catch (std::exception& e)
+    {
+        PBFTENGINE_LOG(WARNING) << LOG_DESC("backupData failed") << LOG_KV("key", _key)
+                                << LOG_KV("EINFO", boost::diagnostic_information(e));
+    }
 }
 
 /**
@@ -187,13 +261,13 @@ void PBFTEngine::initBackupDB()
  */
 void PBFTEngine::reloadMsg(std::string const& key, PBFTMsg* msg)
 {
-    if (!m_backupDB || !msg)
+    if ((!m_backupWAL && !m_backupDB) || !msg)
     {
         return;
     }
     try
     {
-        bytes data = fromHex(m_backupDB->lookup(key));
+        bytes data = loadBackupData(key);
         if (data.empty())
         {
             PBFTENGINE_LOG(DEBUG) << LOG_DESC("reloadMsg: Empty message stored")
@@ -224,21 +298,13 @@ void PBFTEngine::reloadMsg(std::string const& key, PBFTMsg* msg)
  */
 void PBFTEngine::backupMsg(std::string const& _key, PBFTMsg const& _msg)
 {
-    if (!m_backupDB)
+    if (!m_backupWAL && !m_backupDB)
     {
         return;
     }
     bytes message_data;
     _msg.encode(message_data);
-    try
-    {
-        m_backupDB->insert(_key, toHex(message_data));
-    }
-    catch (std::exception& e)
-    {
-        PBFTENGINE_LOG(WARNING) << LOG_DESC("backupMsg failed")
-                                << LOG_KV("EINFO", boost::diagnostic_information(e));
-    }
+    backupData(_key, ref(message_data));
 }
 
 /// sealing the generated block into prepareReq and push its to msgQueue
@@ -246,12 +312,55 @@ bool PBFTEngine::generatePrepare(Block const& block)
 {
     Guard l(m_mutex);
     m_notifyNextLeaderSeal = false;
-    PrepareReq prepare_req(block, m_keyPair, m_view, nodeIdx());
+    /// the pipelined prepare is handled in the first view of its height after the last block
+    /// committed, it is cached as a future prepare by all the sealers until then
+    /// (the empty block is not pipelined, it may trigger a view change of the next height)
+    bool pipelined = block.blockHeader().number() > m_consensusBlockNumber;
+    if (pipelined && (!m_pipeline || block.getTransactionSize() == 0))
+    {
+        return false;
+    }
+    PrepareReq prepare_req(block, m_keyPair, (pipelined ? 0 : m_view), nodeIdx());
+    if (pipelined)
+    {
+        m_pipelinedHeight = prepare_req.height;
+        PBFTENGINE_LOG(DEBUG) << LOG_DESC("generatePrepare: pipelined")
+                              << LOG_KV("H", prepare_req.height)
+                              << LOG_KV("consNum", m_consensusBlockNumber)
+                              << LOG_KV("parent", block.blockHeader().parentHash().abridged());
+    }
     bytes prepare_data;
-    prepare_req.encode(prepare_data);
+    unsigned packetType = PrepareReqPacket;
+    if (m_compactPrepare)
+    {
+        /// replace the block with its header and transaction hashes temporarily
+        bytes blockData;
+        blockData.swap(prepare_req.block);
+        encodeCompactBlock(*prepare_req.pBlock, prepare_req.block);
+        prepare_req.encode(prepare_data);
+        prepare_req.block.swap(blockData);
+        packetType = CompactPrepareReqPacket;
+    }
+    else
+    {
+        prepare_req.encode(prepare_data);
+    }
 
     /// broadcast the generated preparePacket
-    bool succ = broadcastMsg(PrepareReqPacket, prepare_req.uniqueKey(), ref(prepare_data));
+    bool succ = false;
+    if (m_treeWidth > 0)
+    {
+        succ = treeBroadcastMsg(packetType, prepare_req.uniqueKey(), ref(prepare_data), nodeIdx());
+        m_treePrepareKey = prepare_req.uniqueKey();
+        m_treePrepareHash = prepare_req.block_hash;
+        m_treePrepareType = packetType;
+        m_treePrepareData.swap(prepare_data);
+        m_treePrepareTime = utcTime();
+    }
+    else
+    {
+        succ = broadcastMsg(packetType, prepare_req.uniqueKey(), ref(prepare_data));
+    }
     if (succ)
     {
         if (prepare_req.pBlock->getTransactionSize() == 0 && m_omitEmptyBlock)
@@ -303,13 +412,54 @@ bool PBFTEngine::checkSign(PBFTMsg const& req) const
     h512 node_id;
     if (getNodeIDByIndex(node_id, req.idx))
     {
-        Public pub_id = jsToPublic(toJS(node_id.hex()));
-        return dev::verify(pub_id, req.sig, req.block_hash) &&
-               dev::verify(pub_id, req.sig2, req.fieldsWithoutBlock());
+        /// the signatures have been checked against the same sealer by preVerifyMsg
+        if (req.signVerifiedBy != h512() && req.signVerifiedBy == node_id)
+        {
+            return true;
+        }
+        /// the node id of the sealer is its public key
+        return dev::verify(node_id, req.sig, req.block_hash) &&
+               dev::verify(node_id, req.sig2, req.fieldsWithoutBlock());
     }
     return false;
 }
 
+/**
+ * @brief: check the signatures of the signed PBFT messages on the verify pool, so that workLoop
+ *         only checks the signature of the messages that failed or skipped the pre-verification
+ * @param pbftMsg: the network-received message, signVerifiedBy is set if the signatures are valid
+ */
+void PBFTEngine::preVerifyMsg(PBFTMsgPacket& pbftMsg)
+{
+    switch (pbftMsg.packet_id)
+    {
+    case PrepareReqPacket:
+    case SignReqPacket:
+    case CommitReqPacket:
+    case ViewChangeReqPacket:
+    case CompactPrepareReqPacket:
+        break;
+    default:
+        return;
+    }
+    /// only decode the signed fields, the block of the prepare is not copied
+    PBFTMsg req;
+    if (!decodeToRequests(req, ref(pbftMsg.data)))
+    {
+        return;
+    }
+    h512 node_id;
+    if (!getNodeIDByIndex(node_id, req.idx))
+    {
+        return;
+    }
+    if (dev::verify(node_id, req.sig, req.block_hash) &&
+        dev::verify(node_id, req.sig2, req.fieldsWithoutBlock()))
+    {
+        pbftMsg.signVerifiedBy = node_id;
+    }
+}
+
 /**
  * @brief: 1. generate commitReq according to prepare req
  *         2. broadcast the commitReq
@@ -423,6 +573,8 @@ bool PBFTEngine::broadcastMsg(unsigned const& packetType, std::string const& key
 {
     auto sessions = m_service->sessionInfosByProtocolID(m_protocolId);
     m_connectedNode = sessions.size();
+    /// encoded once, the sessions share the payload
+    dev::p2p::P2PMessage::Ptr message;
     for (auto session : sessions)
     {
         /// get node index of the sealer from m_sealerList failed ?
@@ -444,13 +596,116 @@ bool PBFTEngine::broadcastMsg(unsigned const& packetType, std::string const& key
                               << LOG_KV("nodeIdx", nodeIdx())
                               << LOG_KV("myNode", session.nodeID.abridged());
         /// send messages
-        m_service->asyncSendMessageByNodeID(
-            session.nodeID, transDataToMessage(data, packetType, ttl), nullptr);
+        if (!message)
+            message = transDataToMessage(data, packetType, ttl);
+        m_service->asyncSendMessageByNodeID(session.nodeID, message, nullptr);
         broadcastMark(session.nodeID, packetType, key);
     }
     return true;
 }
 
+std::vector<IDXTYPE> PBFTEngine::treeChildren(IDXTYPE const& _rootIdx, IDXTYPE const& _idx) const
+{
+    std::vector<IDXTYPE> children;
+    if (m_nodeNum == 0 || m_treeWidth == 0)
+    {
+        return children;
+    }
+    /// position of the node in the tree, the sealers are ordered from the root
+    size_t pos = (_idx + m_nodeNum - _rootIdx % m_nodeNum) % m_nodeNum;
+    for (size_t i = 1; i <= m_treeWidth; i++)
+    {
+        size_t childPos = pos * m_treeWidth + i;
+        if (childPos >= m_nodeNum)
+        {
+            break;
+        }
+        children.push_back((childPos + _rootIdx) % m_nodeNum);
+    }
+    return children;
+}
+
+/**
+ * @brief: send the message to the subtree of this node in the broadcast tree, the tree is derived
+ *         from the sealer list and the root(the leader generating the prepare of current view)
+ * @param packetType: type of the message
+ * @param key: key of the message used by the broadcast cache
+ * @param data: encoded message
+ * @param _rootIdx: index of the root sealer
+ */
+bool PBFTEngine::treeBroadcastMsg(unsigned const& packetType, std::string const& key,
+    bytesConstRef data, IDXTYPE const& _rootIdx)
+{
+    auto sessions = m_service->sessionInfosByProtocolID(m_protocolId);
+    m_connectedNode = sessions.size();
+    std::unordered_set<h512> connected;
+    for (auto const& session : sessions)
+    {
+        connected.insert(session.nodeID);
+    }
+    std::vector<IDXTYPE> pending = treeChildren(_rootIdx, nodeIdx());
+    dev::p2p::P2PMessage::Ptr message;
+    for (size_t i = 0; i < pending.size(); i++)
+    {
+        h512 nodeId = getSealerByIndex(pending[i]);
+        if (nodeId == h512() || pending[i] == nodeIdx())
+        {
+            continue;
+        }
+        /// the subtree of the disconnected child is served by this node
+        if (!connected.count(nodeId))
+        {
+            auto children = treeChildren(_rootIdx, pending[i]);
+            pending.insert(pending.end(), children.begin(), children.end());
+            continue;
+        }
+        if (broadcastFilter(nodeId, packetType, key))
+        {
+            continue;
+        }
+        PBFTENGINE_LOG(TRACE) << LOG_DESC("treeBroadcastMsg") << LOG_KV("packetType", packetType)
+                              << LOG_KV("dstNodeId", nodeId.abridged())
+                              << LOG_KV("rootIdx", _rootIdx) << LOG_KV("nodeIdx", nodeIdx());
+        if (!message)
+            message = transDataToMessage(data, packetType, 0);
+        m_service->asyncSendMessageByNodeID(nodeId, message, nullptr);
+        broadcastMark(nodeId, packetType, key);
+    }
+    return true;
+}
+
+/// fall back to broadcast the prepare to all the sealers if it has not collected enough signReqs
+void PBFTEngine::checkTreeBroadcastTimeout()
+{
+    Guard l(m_mutex);
+    if (m_treePrepareTime == 0 || utcTime() - m_treePrepareTime < c_treeBroadcastTimeout)
+    {
+        return;
+    }
+    m_treePrepareTime = 0;
+    /// the prepare sent along the tree has been replaced
+    if (m_reqCache->rawPrepareCache().block_hash != m_treePrepareHash)
+    {
+        return;
+    }
+    /// the sealers sign the hash of the executed block
+    size_t signNum = 0;
+    PrepareReq const& executedPrepare = m_reqCache->prepareCache();
+    if (executedPrepare.height == m_reqCache->rawPrepareCache().height)
+    {
+        signNum = m_reqCache->getSigCacheSize(executedPrepare.block_hash);
+    }
+    if (signNum + 1 >= minValidNodes())
+    {
+        return;
+    }
+    PBFTENGINE_LOG(INFO) << LOG_DESC("checkTreeBroadcastTimeout: broadcast prepare to all sealers")
+                         << LOG_KV("hash", m_treePrepareHash.abridged())
+                         << LOG_KV("signNum", signNum) << LOG_KV("nodeIdx", nodeIdx());
+    /// the sealers that have received the prepare are skipped by the broadcast cache
+    broadcastMsg(m_treePrepareType, m_treePrepareKey, ref(m_treePrepareData));
+}
+
 /**
  * @brief: check the specified prepareReq is valid or not
  *       1. should not be existed in the prepareCache
@@ -553,7 +808,7 @@ bool PBFTEngine::checkBlock(Block const& block)
         return false;
     }
     /// check sign num
-    auto sig_list = block.sigList();
+    auto const& sig_list = block.sigList();
     if (sig_list.size() < minValidNodes())
     {
         PBFTENGINE_LOG(ERROR) << LOG_DESC("checkBlock: insufficient signatures")
@@ -561,27 +816,31 @@ bool PBFTEngine::checkBlock(Block const& block)
                               << LOG_KV("minValidSign", minValidNodes());
         return false;
     }
-    /// check sign
-    for (auto sign : sig_list)
+    /// check signers, a sealer signing more than once is counted once
+    std::set<u256> signers;
+    for (auto const& sign : sig_list)
     {
-        if (sign.first >= m_sealerList.size())
+        if (sign.first >= block.blockHeader().sealerList().size())
         {
             PBFTENGINE_LOG(ERROR) << LOG_DESC("checkBlock: overflowed signer")
                                   << LOG_KV("signer", sign.first)
-                                  << LOG_KV("Nsealer", m_sealerList.size());
-            return false;
-        }
-        if (!dev::verify(m_sealerList[sign.first.convert_to<size_t>()], sign.second,
-                block.blockHeader().hash()))
-        {
-            PBFTENGINE_LOG(ERROR) << LOG_DESC("checkBlock: invalid sign")
-                                  << LOG_KV("signer", sign.first)
-                                  << LOG_KV("pub",
-                                         m_sealerList[sign.first.convert_to<size_t>()].abridged())
-                                  << LOG_KV("hash", block.blockHeader().hash().abridged());
+                                  << LOG_KV("Nsealer", block.blockHeader().sealerList().size());
             return false;
         }
-    }  /// end of check sign
+        signers.insert(sign.first);
+    }
+    if (signers.size() < minValidNodes())
+    {
+        PBFTENGINE_LOG(ERROR) << LOG_DESC("checkBlock: insufficient signers")
+                              << LOG_KV("signerNum", signers.size())
+                              << LOG_KV("minValidSign", minValidNodes());
+        return false;
+    }
+    /// check sign
+    if (!verifySigList(block))
+    {
+        return false;
+    }
 
     /// Check whether the number of transactions in block exceeds the limit
     if (block.transactions().size() > maxBlockTransactions())
@@ -591,6 +850,66 @@ bool PBFTEngine::checkBlock(Block const& block)
     return true;
 }
 
+/**
+ * @brief: verify the signatures of the block, the sig list is split into batches, one batch is
+ *         verified by the calling thread and the others by the sig list verify pool
+ *         a batch is verified by the first thread claiming it, the calling thread verifies the
+ *         batches not yet started by the pool itself, so it never waits for a task that may not
+ *         run, e.g. when called on a pool thread or after the pool stopped
+ * @param block: the block whose signers have been checked by checkBlock
+ * @return true: all the signatures are valid
+ */
+bool PBFTEngine::verifySigList(Block const& block)
+{
+    auto const& sig_list = block.sigList();
+    auto const& sealers = block.blockHeader().sealerList();
+    h256 hash = block.blockHeader().hash();
+    auto verifyBatch = [&sig_list, &sealers, &hash, this](size_t _begin, size_t _end) -> bool {
+        for (size_t i = _begin; i < _end; i++)
+        {
+            auto const& pub = sealers[sig_list[i].first.convert_to<size_t>()];
+            if (!dev::verify(pub, sig_list[i].second, hash))
+            {
+                PBFTENGINE_LOG(ERROR)
+                    << LOG_DESC("checkBlock: invalid sign") << LOG_KV("signer", sig_list[i].first)
+                    << LOG_KV("pub", pub.abridged()) << LOG_KV("hash", hash.abridged());
+                return false;
+            }
+        }
+        return true;
+    };
+    struct VerifyBatch
+    {
+        std::atomic<bool> claimed = {false};
+        std::packaged_task<bool()> task;
+    };
+    size_t batchNum = c_sigListVerifyThreadNum + 1;
+    size_t batchSize = std::max(c_minSigVerifyBatch, (sig_list.size() + batchNum - 1) / batchNum);
+    std::vector<std::shared_ptr<VerifyBatch>> batches;
+    std::vector<std::future<bool>> results;
+    for (size_t begin = batchSize; begin < sig_list.size(); begin += batchSize)
+    {
+        auto batch = std::make_shared<VerifyBatch>();
+        batch->task = std::packaged_task<bool()>(
+            std::bind(verifyBatch, begin, std::min(begin + batchSize, sig_list.size())));
+        results.push_back(batch->task.get_future());
+        batches.push_back(batch);
+        m_sigListVerifyPool->enqueue([batch]() {
+            if (!batch->claimed.exchange(true))
+                batch->task();
+        });
+    }
+    bool valid = verifyBatch(0, std::min(batchSize, sig_list.size()));
+    /// wait for all the batches, they refer to the sig list of the block
+    for (size_t i = 0; i < batches.size(); i++)
+    {
+        if (!batches[i]->claimed.exchange(true))
+            batches[i]->task();
+        valid = results[i].get() && valid;
+    }
+    return valid;
+}
+
 /**
  * @brief: notify the seal module to seal block if the current node is the next leader
  * @param block: block obtained from the prepare packet, used to filter transactions
@@ -652,6 +971,18 @@ void PBFTEngine::execBlock(Sealing& sealing, PrepareReq const& req, std::ostring
 
     m_blockSync->noteSealingBlockNumber(sealing.block.header().number());
 
+    /// the block has been executed in the former view
+    h256 proposalHash = sealing.block.header().hash();
+    if (loadExecutedSealing(proposalHash, sealing))
+    {
+        PBFTENGINE_LOG(DEBUG) << LOG_DESC("execBlock: reuse the executed block")
+                              << LOG_KV("blkNum", sealing.block.header().number())
+                              << LOG_KV("reqIdx", req.idx)
+                              << LOG_KV("hash", proposalHash.abridged())
+                              << LOG_KV("nodeIdx", nodeIdx());
+        return;
+    }
+
     /// ignore the signature verification of the transactions have already been verified in
     /// transation pool
     /// the transactions that has not been verified by the txpool should be verified
@@ -669,6 +1000,58 @@ void PBFTEngine::execBlock(Sealing& sealing, PrepareReq const& req, std::ostring
                           << LOG_KV("timecost", time_cost)
                           << LOG_KV("execPerTx",
                                  (float)time_cost / (float)sealing.block.getTransactionSize());
+    cacheExecutedSealing(proposalHash, sealing);
+}
+
+bool PBFTEngine::loadExecutedSealing(h256 const& _hash, Sealing& _sealing)
+{
+    Guard l(x_executedSealings);
+    auto it = m_executedSealings.find(_hash);
+    if (it == m_executedSealings.end() || !it->second.p_execContext)
+    {
+        return false;
+    }
+    _sealing.block = it->second.block;
+    _sealing.p_execContext = it->second.p_execContext;
+    return true;
+}
+
+void PBFTEngine::cacheExecutedSealing(h256 const& _hash, Sealing const& _sealing)
+{
+    Guard l(x_executedSealings);
+    /// evict the proposals of the lowest height
+    while (m_executedSealings.size() + 2 > c_maxExecutedSealings)
+    {
+        auto lowest = m_executedSealings.begin();
+        for (auto it = m_executedSealings.begin(); it != m_executedSealings.end(); it++)
+        {
+            if (it->second.block.blockHeader().number() <
+                lowest->second.block.blockHeader().number())
+            {
+                lowest = it;
+            }
+        }
+        m_executedSealings.erase(lowest);
+    }
+    m_executedSealings[_hash] = _sealing;
+    /// the re-generated prepare carries the hash of the executed block
+    m_executedSealings[_sealing.block.blockHeader().hash()] = _sealing;
+}
+
+void PBFTEngine::clearExecutedSealings(int64_t const& _number)
+{
+    Guard l(x_executedSealings);
+    for (auto it = m_executedSealings.begin(); it != m_executedSealings.end();)
+    {
+        if (it->second.block.blockHeader().number() <= _number)
+        {
+            it = m_executedSealings.erase(it);
+        }
+        else
+        {
+            it++;
+        }
+    }
 }
 
 /// check whether the block is empty
@@ -711,11 +1094,17 @@ void PBFTEngine::onRecvPBFTMessage(
     {
         return;
     }
-    if (pbft_msg.packet_id <= ViewChangeReqPacket)
+    if (pbft_msg.packet_id < PBFTPacketCount)
     {
-        m_msgQueue.push(pbft_msg);
-        /// notify to handleMsg after push new PBFTMsgPacket into m_msgQueue
-        m_signalled.notify_all();
+        /// check the signatures on the verify pool of the sender, and then push the message into
+        /// m_msgQueue, the messages of different senders are verified in parallel
+        size_t shard = std::hash<h512>()(pbft_msg.node_id) % m_msgVerifyPools.size();
+        m_msgVerifyPools[shard]->enqueue([this, pbft_msg]() mutable {
+            preVerifyMsg(pbft_msg);
+            m_msgQueue.push(pbft_msg);
+            /// notify to handleMsg after push new PBFTMsgPacket into m_msgQueue
+            m_signalled.notify_all();
+        });
     }
     else
     {
@@ -728,7 +1117,7 @@ void PBFTEngine::onRecvPBFTMessage(
 
 bool PBFTEngine::handlePrepareMsg(PrepareReq& prepare_req, PBFTMsgPacket const& pbftMsg)
 {
-    bool valid = decodeToRequests(prepare_req, ref(pbftMsg.data));
+    bool valid = decodePBFTMsg(prepare_req, pbftMsg);
     if (!valid)
     {
         return false;
@@ -772,6 +1161,8 @@ bool PBFTEngine::handlePrepareMsg(PrepareReq const& prepareReq, std::string cons
     }
     /// add raw prepare request
     m_reqCache->addRawPrepare(prepareReq);
+    m_timeManager.m_prepareTime = utcTime();
+    m_timeManager.m_prepareHeight = prepareReq.height;
 
     Sealing workingSealing;
     try
@@ -813,6 +1204,280 @@ bool PBFTEngine::handlePrepareMsg(PrepareReq const& prepareReq, std::string cons
 }
 
 
+/// encode the block header and hashes of the transactions into RLP list
+void PBFTEngine::encodeCompactBlock(Block const& block, bytes& out) const
+{
+    bytes header_data;
+    block.blockHeader().encode(header_data);
+    std::vector<h256> txsHash;
+    txsHash.reserve(block.transactions().size());
+    for (auto const& tx : block.transactions())
+    {
+        txsHash.push_back(tx.sha3());
+    }
+    RLPStream s;
+    s.appendList(2);
+    s.appendRaw(header_data);
+    s << txsHash;
+    s.swapOut(out);
+}
+
+/**
+ * @brief: handle the compact prepare request:
+ *       1. decode the block header and the transaction hashes
+ *       2. rebuild the block from the transactions of txpool
+ *       3. handle the rebuilt prepare if all transactions are hit, otherwise request the missed
+ *          transactions from the node which sends the compact prepare
+ * @param prepare_req: the compact prepare request decoded from the network
+ * @return true: the prepare has been rebuilt and handled successfully, forward it
+ * @return false: the prepare is invalid or is waiting for the missed transactions
+ */
+bool PBFTEngine::handleCompactPrepareMsg(PrepareReq& prepare_req, PBFTMsgPacket const& pbftMsg)
+{
+    if (!decodePBFTMsg(prepare_req, pbftMsg))
+    {
+        return false;
+    }
+    if (m_reqCache->isExistPrepare(prepare_req) || hasConsensused(prepare_req))
+    {
+        return false;
+    }
+    /// the duplicated compact prepare requests the missed transactions again after timeout
+    if (m_partiallyPrepare && m_partiallyPrepare->block_hash == prepare_req.block_hash &&
+        utcTime() - m_partiallyPrepareTime < c_missedTxsTimeout)
+    {
+        return false;
+    }
+    /// check the signature before requesting the missed transactions
+    if (!checkSign(prepare_req))
+    {
+        PBFTENGINE_LOG(TRACE) << LOG_DESC("InvalidCompactPrepare: invalid signature")
+                              << LOG_KV("reqIdx", prepare_req.idx)
+                              << LOG_KV("hash", prepare_req.block_hash.abridged());
+        return false;
+    }
+    std::vector<h256> txsHash;
+    prepare_req.pBlock = std::make_shared<Block>();
+    try
+    {
+        RLP compact_rlp(ref(prepare_req.block));
+        prepare_req.pBlock->setBlockHeader(BlockHeader(compact_rlp[0].data(), HeaderData));
+        txsHash = compact_rlp[1].toVector<h256>();
+    }
+    catch (std::exception const& e)
+    {
+        PBFTENGINE_LOG(WARNING) << LOG_DESC("handleCompactPrepareMsg: invalid compact block")
+                                << LOG_KV("reqIdx", prepare_req.idx)
+                                << LOG_KV("fromIp", pbftMsg.endpoint)
+                                << LOG_KV("EINFO", boost::diagnostic_information(e));
+        return false;
+    }
+    if (prepare_req.pBlock->blockHeader().hash() != prepare_req.block_hash)
+    {
+        PBFTENGINE_LOG(WARNING) << LOG_DESC("handleCompactPrepareMsg: inconsistent block hash")
+                                << LOG_KV("reqIdx", prepare_req.idx)
+                                << LOG_KV("hash", prepare_req.block_hash.abridged());
+        return false;
+    }
+
+    /// transactionsByHash keeps the order of the given hashes and skips the missed ones
+    Transactions hitTxs = m_txPool->transactionsByHash(txsHash);
+    Transactions txs(txsHash.size());
+    std::vector<size_t> missedIndex;
+    size_t hit = 0;
+    for (size_t i = 0; i < txsHash.size(); i++)
+    {
+        if (hit < hitTxs.size() && hitTxs[hit].sha3() == txsHash[i])
+        {
+            txs[i] = hitTxs[hit++];
+        }
+        else
+        {
+            missedIndex.push_back(i);
+        }
+    }
+    PBFTENGINE_LOG(DEBUG) << LOG_DESC("handleCompactPrepareMsg")
+                          << LOG_KV("reqIdx", prepare_req.idx)
+                          << LOG_KV("number", prepare_req.height)
+                          << LOG_KV("hash", prepare_req.block_hash.abridged())
+                          << LOG_KV("txs", txsHash.size()) << LOG_KV("missed", missedIndex.size())
+                          << LOG_KV("fromIp", pbftMsg.endpoint) << LOG_KV("nodeIdx", nodeIdx())
+                          << LOG_KV("myNode", m_keyPair.pub().abridged());
+    if (missedIndex.size() == 0)
+    {
+        return handleRebuiltPrepare(prepare_req, txs, pbftMsg.endpoint);
+    }
+
+    /// request the missed transactions from the node that sends the compact prepare
+    std::vector<h256> missedHashes;
+    missedHashes.reserve(missedIndex.size());
+    for (auto const& index : missedIndex)
+    {
+        missedHashes.push_back(txsHash[index]);
+    }
+    RLPStream s;
+    s.appendList(2);
+    s << prepare_req.block_hash << missedHashes;
+    bytes request_data;
+    s.swapOut(request_data);
+    m_service->asyncSendMessageByNodeID(
+        pbftMsg.node_id, transDataToMessage(ref(request_data), GetMissedTxsPacket, 1), nullptr);
+
+    m_partiallyPrepare = std::make_shared<PrepareReq>(prepare_req);
+    m_partiallyPrepareMsg = pbftMsg;
+    m_partiallyTxs.swap(txs);
+    m_missedTxsIndex.swap(missedIndex);
+    m_partiallyPrepareTime = utcTime();
+    return false;
+}
+
+/// response the missed transactions from the proposal being handled or from the txpool
+void PBFTEngine::handleGetMissedTxsMsg(PBFTMsgPacket const& pbftMsg)
+{
+    h256 blockHash;
+    std::vector<h256> missedHashes;
+    try
+    {
+        RLP request_rlp(ref(pbftMsg.data));
+        blockHash = request_rlp[0].toHash<h256>();
+        missedHashes = request_rlp[1].toVector<h256>();
+    }
+    catch (std::exception const& e)
+    {
+        PBFTENGINE_LOG(WARNING) << LOG_DESC("handleGetMissedTxsMsg: invalid request")
+                                << LOG_KV("fromIp", pbftMsg.endpoint)
+                                << LOG_KV("EINFO", boost::diagnostic_information(e));
+        return;
+    }
+    std::shared_ptr<Block> block = nullptr;
+    if (m_reqCache->rawPrepareCache().block_hash == blockHash)
+    {
+        block = m_reqCache->rawPrepareCache().pBlock;
+    }
+    else if (m_reqCache->prepareCache().block_hash == blockHash)
+    {
+        block = m_reqCache->prepareCache().pBlock;
+    }
+
+    Transactions txs;
+    if (block)
+    {
+        std::unordered_map<h256, size_t> txIndex;
+        for (size_t i = 0; i < block->transactions().size(); i++)
+        {
+            txIndex[block->transactions()[i].sha3()] = i;
+        }
+        for (auto const& txHash : missedHashes)
+        {
+            auto it = txIndex.find(txHash);
+            if (it != txIndex.end())
+            {
+                txs.push_back(block->transactions()[it->second]);
+            }
+        }
+    }
+    else
+    {
+        txs = m_txPool->transactionsByHash(missedHashes);
+    }
+    if (txs.size() != missedHashes.size())
+    {
+        PBFTENGINE_LOG(DEBUG) << LOG_DESC("handleGetMissedTxsMsg: missed transactions not found")
+                              << LOG_KV("hash", blockHash.abridged())
+                              << LOG_KV("request", missedHashes.size())
+                              << LOG_KV("found", txs.size()) << LOG_KV("fromIp", pbftMsg.endpoint);
+        return;
+    }
+    RLPStream s;
+    s.appendList(2);
+    s << blockHash;
+    s.appendList(txs.size());
+    for (auto const& tx : txs)
+    {
+        bytes tx_data;
+        tx.encode(tx_data);
+        s.appendRaw(tx_data);
+    }
+    bytes response_data;
+    s.swapOut(response_data);
+    m_service->asyncSendMessageByNodeID(
+        pbftMsg.node_id, transDataToMessage(ref(response_data), MissedTxsPacket, 1), nullptr);
+    PBFTENGINE_LOG(DEBUG) << LOG_DESC("handleGetMissedTxsMsg: response missed transactions")
+                          << LOG_KV("hash", blockHash.abridged()) << LOG_KV("txs", txs.size())
+                          << LOG_KV("toIp", pbftMsg.endpoint) << LOG_KV("nodeIdx", nodeIdx())
+                          << LOG_KV("myNode", m_keyPair.pub().abridged());
+}
+
+void PBFTEngine::handleMissedTxsMsg(PBFTMsgPacket const& pbftMsg)
+{
+    if (!m_partiallyPrepare || pbftMsg.node_id != m_partiallyPrepareMsg.node_id)
+    {
+        return;
+    }
+    try
+    {
+        RLP response_rlp(ref(pbftMsg.data));
+        if (response_rlp[0].toHash<h256>() != m_partiallyPrepare->block_hash)
+        {
+            return;
+        }
+        RLP txs_rlp = response_rlp[1];
+        if (txs_rlp.itemCount() != m_missedTxsIndex.size())
+        {
+            return;
+        }
+        /// the signatures are verified by verifyAndSetSenderForBlock when executing the block
+        for (size_t i = 0; i < m_missedTxsIndex.size(); i++)
+        {
+            m_partiallyTxs[m_missedTxsIndex[i]].decode(txs_rlp[i], CheckTransaction::None);
+        }
+    }
+    catch (std::exception const& e)
+    {
+        PBFTENGINE_LOG(WARNING) << LOG_DESC("handleMissedTxsMsg: invalid response")
+                                << LOG_KV("fromIp", pbftMsg.endpoint)
+                                << LOG_KV("EINFO", boost::diagnostic_information(e));
+        return;
+    }
+    std::shared_ptr<PrepareReq> prepare_req = m_partiallyPrepare;
+    PBFTMsgPacket prepareMsg = m_partiallyPrepareMsg;
+    Transactions txs;
+    txs.swap(m_partiallyTxs);
+    clearPartiallyPrepare();
+    if (handleRebuiltPrepare(*prepare_req, txs, prepareMsg.endpoint))
+    {
+        forwardMsg(prepareMsg, *prepare_req, prepare_req->uniqueKey());
+    }
+}
+
+void PBFTEngine::clearPartiallyPrepare()
+{
+    m_partiallyPrepare = nullptr;
+    m_partiallyTxs.clear();
+    m_missedTxsIndex.clear();
+    m_partiallyPrepareTime = 0;
+}
+
+bool PBFTEngine::handleRebuiltPrepare(
+    PrepareReq& prepare_req, Transactions const& txs, std::string const& endpoint)
+{
+    prepare_req.pBlock->setTransactions(txs);
+    /// the rebuilt transactions must be consistent with the signed block header
+    h256 txsRoot = prepare_req.pBlock->header().transactionsRoot();
+    prepare_req.pBlock->calTransactionRoot();
+    if (prepare_req.pBlock->header().transactionsRoot() != txsRoot)
+    {
+        PBFTENGINE_LOG(WARNING) << LOG_DESC("handleRebuiltPrepare: inconsistent transactionsRoot")
+                                << LOG_KV("reqIdx", prepare_req.idx)
+                                << LOG_KV("hash", prepare_req.block_hash.abridged())
+                                << LOG_KV("fromIp", endpoint);
+        return false;
+    }
+    /// keep the whole block for the committed prepare backup
+    prepare_req.pBlock->encode(prepare_req.block);
+    return handlePrepareMsg(prepare_req, endpoint);
+}
+
 void PBFTEngine::checkAndCommit()
 {
     size_t sign_size = m_reqCache->getSigCacheSize(m_reqCache->prepareCache().block_hash);
@@ -837,6 +1502,11 @@ void PBFTEngine::checkAndCommit()
             return;
         }
         m_reqCache->updateCommittedPrepare();
+        if (m_pipeline && m_reqCache->prepareCache().pBlock)
+        {
+            Guard l(x_pipelineParent);
+            m_pipelineParent = m_reqCache->prepareCache().pBlock->blockHeader();
+        }
         /// update and backup the commit cache
         PBFTENGINE_LOG(DEBUG) << LOG_DESC("checkAndCommit: backup/updateCommittedPrepare")
                               << LOG_KV("blkNum", m_reqCache->committedPrepareCache().height)
@@ -890,14 +1560,18 @@ void PBFTEngine::checkAndSave()
         {
             /// Block block(m_reqCache->prepareCache().block);
             std::shared_ptr<dev::eth::Block> p_block = m_reqCache->prepareCache().pBlock;
-            m_reqCache->generateAndSetSigList(*p_block, minValidNodes());
+            m_reqCache->generateAndSetSigList(*p_block, minValidNodes(), m_commitCertificate);
             auto start_commit_time = utcTime();
             /// callback block chain to commit block
             CommitResult ret = m_blockChain->commitBlock((*p_block),
                 std::shared_ptr<ExecutiveContext>(m_reqCache->prepareCache().p_execContext));
+            /// the execution context has been consumed by the commit
+            clearExecutedSealings(p_block->blockHeader().number());
             /// drop handled transactions
             if (ret == CommitResult::OK)
             {
+                updateCommitLatency(
+                    m_reqCache->prepareCache().height, m_reqCache->prepareCache().idx);
                 dropHandledTransactions(*p_block);
                 m_blockSync->noteSealingBlockNumber(m_reqCache->prepareCache().height);
                 PBFTENGINE_LOG(DEBUG)
@@ -965,6 +1639,8 @@ void PBFTEngine::reportBlockWithoutLock(Block const& block)
         }
         resetConfig();
         m_reqCache->delCache(m_highestBlock.hash());
+        clearExecutedSealings(m_highestBlock.number());
+        clearPartiallyPrepare();
         PBFTENGINE_LOG(INFO) << LOG_DESC("^^^^^^^^Report") << LOG_KV("num", m_highestBlock.number())
                              << LOG_KV("sealerIdx", m_highestBlock.sealer())
                              << LOG_KV("hash", m_highestBlock.hash().abridged())
@@ -985,7 +1661,7 @@ void PBFTEngine::reportBlockWithoutLock(Block const& block)
 bool PBFTEngine::handleSignMsg(SignReq& sign_req, PBFTMsgPacket const& pbftMsg)
 {
     Timer t;
-    bool valid = decodeToRequests(sign_req, ref(pbftMsg.data));
+    bool valid = decodePBFTMsg(sign_req, pbftMsg);
     if (!valid)
     {
         return false;
@@ -1062,7 +1738,7 @@ CheckResult PBFTEngine::isValidSignReq(SignReq const& req, std::ostringstream& o
 bool PBFTEngine::handleCommitMsg(CommitReq& commit_req, PBFTMsgPacket const& pbftMsg)
 {
     Timer t;
-    bool valid = decodeToRequests(commit_req, ref(pbftMsg.data));
+    bool valid = decodePBFTMsg(commit_req, pbftMsg);
     if (!valid)
     {
         return false;
@@ -1124,7 +1800,7 @@ CheckResult PBFTEngine::isValidCommitReq(CommitReq const& req, std::ostringstrea
 
 bool PBFTEngine::handleViewChangeMsg(ViewChangeReq& viewChange_req, PBFTMsgPacket const& pbftMsg)
 {
-    bool valid = decodeToRequests(viewChange_req, ref(pbftMsg.data));
+    bool valid = decodePBFTMsg(viewChange_req, pbftMsg);
     if (!valid)
     {
         return false;
@@ -1243,6 +1919,7 @@ void PBFTEngine::checkAndChangeView()
         m_view = m_toView;
         m_notifyNextLeaderSeal = false;
         m_reqCache->triggerViewChange(m_view);
+        clearPartiallyPrepare();
         m_blockSync->noteSealingBlockNumber(m_blockChain->number());
     }
 }
@@ -1267,13 +1944,37 @@ void PBFTEngine::collectGarbage()
     }
 }
 
+void PBFTEngine::updateCommitLatency(int64_t const& _number, IDXTYPE const& _leader)
+{
+    if (m_timeManager.m_prepareHeight != _number)
+    {
+        return;
+    }
+    auto latency = utcTime() - m_timeManager.m_prepareTime;
+    m_timeManager.updateLatency(getSealerByIndex(_leader), latency);
+    if (m_timeManager.m_adaptive && _number % c_timeStatsBackupInterval == 0)
+    {
+        bytes timeStats;
+        m_timeManager.encodeSealerStats(timeStats);
+        backupData(c_backupKeyTimeStats, ref(timeStats));
+    }
+}
+
 void PBFTEngine::checkTimeout()
 {
     bool flag = false;
     {
         Guard l(m_mutex);
+        /// the leader of the view to be changed to
+        h512 leader;
+        if (m_nodeNum > 0)
+        {
+            leader = getSealerByIndex((m_toView + m_highestBlock.number()) % m_nodeNum);
+        }
+        m_timeManager.m_currentTimeout = m_timeManager.viewTimeout(leader);
         if (m_timeManager.isTimeout())
         {
+            m_timeManager.updateTimeouts(leader);
             /// timeout not triggered by fast view change
             if (m_timeManager.m_lastConsensusTime != 0)
             {
@@ -1318,6 +2019,24 @@ void PBFTEngine::handleMsg(PBFTMsgPacket const& pbftMsg)
         pbft_msg = prepare_req;
         break;
     }
+    case CompactPrepareReqPacket:
+    {
+        PrepareReq prepare_req;
+        succ = handleCompactPrepareMsg(prepare_req, pbftMsg);
+        key = prepare_req.uniqueKey();
+        pbft_msg = prepare_req;
+        break;
+    }
+    case GetMissedTxsPacket:
+    {
+        handleGetMissedTxsMsg(pbftMsg);
+        return;
+    }
+    case MissedTxsPacket:
+    {
+        handleMissedTxsMsg(pbftMsg);
+        return;
+    }
     case SignReqPacket:
     {
         SignReq req;
@@ -1350,14 +2069,29 @@ void PBFTEngine::handleMsg(PBFTMsgPacket const& pbftMsg)
         return;
     }
     }
+    if (succ)
+    {
+        forwardMsg(pbftMsg, pbft_msg, key);
+    }
+}
 
+void PBFTEngine::forwardMsg(
+    PBFTMsgPacket const& pbftMsg, PBFTMsg const& pbft_msg, std::string const& key)
+{
+    /// the prepare is forwarded to the subtree of this node regardless of the ttl
+    if (m_treeWidth > 0 && key.size() > 0 &&
+        (pbftMsg.packet_id == PrepareReqPacket || pbftMsg.packet_id == CompactPrepareReqPacket))
+    {
+        treeBroadcastMsg(pbftMsg.packet_id, key, ref(pbftMsg.data), pbft_msg.idx);
+        return;
+    }
     if (pbftMsg.ttl == 1)
     {
         return;
     }
     bool height_flag = (pbft_msg.height > m_highestBlock.number()) ||
                        (m_highestBlock.number() - pbft_msg.height < 10);
-    if (succ && key.size() > 0 && height_flag)
+    if (key.size() > 0 && height_flag)
     {
         std::unordered_set<h512> filter;
         filter.insert(pbftMsg.node_id);
@@ -1395,6 +2129,7 @@ void PBFTEngine::workLoop()
                 m_signalled.wait_for(l, std::chrono::milliseconds(5));
             }
             checkTimeout();
+            checkTreeBroadcastTimeout();
             handleFutureBlock();
             collectGarbage();
         }
@@ -1447,6 +2182,9 @@ const std::string PBFTEngine::consensusStatus()
 
     /// get cache-related informations
     m_reqCache->getCacheConsensusStatus(status);
+    /// get the latencies and timeouts of the sealers, appended last to keep the positions of the
+    /// items above
+    getSealerTimeStatus(status);
     json_spirit::Value value(status);
     std::string status_str = json_spirit::write_string(value, true);
     return status_str;
@@ -1471,5 +2209,23 @@ void PBFTEngine::getAllNodesViewStatus(json_spirit::Array& status)
     status.push_back(view_array);
 }
 
+void PBFTEngine::getSealerTimeStatus(json_spirit::Array& status)
+{
+    json_spirit::Array time_array;
+    for (auto const& it : m_timeManager.sealerStats())
+    {
+        json_spirit::Object time_obj;
+        time_obj.push_back(json_spirit::Pair("nodeId", dev::toHex(it.first)));
+        time_obj.push_back(
+            json_spirit::Pair("latencySamples", (uint64_t)it.second.latencies.size()));
+        time_obj.push_back(json_spirit::Pair("latencyP95", it.second.percentile));
+        time_obj.push_back(json_spirit::Pair("timeouts", (uint64_t)it.second.timeouts));
+        time_obj.push_back(
+            json_spirit::Pair("viewTimeout", (uint64_t)m_timeManager.viewTimeout(it.first)));
+        time_array.push_back(time_obj);
+    }
+    status.push_back(time_array);
+}
+
 }  // namespace consensus
 }  // namespace dev
@@ -23,12 +23,14 @@
  */
 #pragma once
 #include "Common.h"
+#include "PBFTBackupWAL.h"
 #include "PBFTMsgCache.h"
 #include "PBFTReqCache.h"
 #include "TimeManager.h"
 #include <libconsensus/ConsensusEngineBase.h>
 #include <libdevcore/FileSystem.h>
 #include <libdevcore/LevelDB.h>
+#include <libdevcore/ThreadPool.h>
 #include <libdevcore/concurrent_queue.h>
 #include <libsync/SyncStatus.h>
 #include <sstream>
@@ -48,6 +50,20 @@ enum CheckResult
     FUTURE = 2
 };
 using PBFTMsgQueue = dev::concurrent_queue<PBFTMsgPacket>;
+/// threads checking the signatures of the received messages before they enter m_msgQueue
+static size_t const c_pbftVerifyThreadNum = 4;
+/// threads checking the signature lists of the blocks, separated from the message verification
+/// so that the blocks downloaded by sync don't delay the consensus messages
+static size_t const c_sigListVerifyThreadNum = 4;
+/// the minimum signatures of a block verified by one task of the sig list verify pool
+static size_t const c_minSigVerifyBatch = 4;
+/// the leader broadcasts the prepare to all the sealers if it is not signed by 2f+1 sealers in
+/// time after sent along the broadcast tree
+static uint64_t const c_treeBroadcastTimeout = 500;  // ms
+/// the missed transactions of a compact prepare are requested again if not received in time
+static uint64_t const c_missedTxsTimeout = 1000;  // ms
+/// executed but uncommitted proposals kept for the re-proposals in the later views
+static size_t const c_maxExecutedSealings = 16;
 class PBFTEngine : public ConsensusEngineBase
 {
 public:
@@ -63,6 +79,13 @@ public:
             _keyPair, _sealerList),
         m_baseDir(_baseDir)
     {
+        m_sigListVerifyPool = std::make_shared<dev::ThreadPool>(
+            "pbftSigList-" + std::to_string(m_groupId), c_sigListVerifyThreadNum);
+        for (size_t i = 0; i < c_pbftVerifyThreadNum; i++)
+        {
+            m_msgVerifyPools.push_back(std::make_shared<dev::ThreadPool>(
+                "pbftMsgVerify-" + std::to_string(m_groupId), 1));
+        }
         PBFTENGINE_LOG(INFO) << LOG_DESC("Register handler for PBFTEngine");
         m_service->registerHandlerByProtoclID(
             m_protocolId, boost::bind(&PBFTEngine::onRecvPBFTMessage, this, _1, _2, _3));
@@ -126,9 +149,36 @@ public:
             return true;
         }
         if (m_notifyNextLeaderSeal && getNextLeader() == nodeIdx())
+        {
+            /// pipelined: propose once the last block is locked by 2f+1 signReqs
+            dev::eth::BlockHeader parent;
+            return pipelineParent(parent);
+        }
+        return true;
+    }
+    /// adapt the view timeout to the latencies of the leader and skip the failed leaders
+    void setAdaptiveTimeout(bool const& _adaptive) { m_timeManager.m_adaptive = _adaptive; }
+    /// when to flush the backup log to the disk: none, batch or always
+    void setBackupSyncPolicy(WALSyncPolicy const& _policy) { m_backupSyncPolicy = _policy; }
+    /// propose the next block once the current one is locked instead of committed
+    void setPipeline(bool const& _pipeline) { m_pipeline = _pipeline; }
+    /**
+     * @brief: get the header of the block locked by 2f+1 signReqs but not committed yet, the next
+     *         leader seals the next block on it in pipelined mode
+     * @return true: the locked block is the child of the highest block
+     */
+    bool pipelineParent(dev::eth::BlockHeader& _parent)
+    {
+        if (!m_pipeline)
+        {
+            return false;
+        }
+        Guard l(x_pipelineParent);
+        if (m_pipelineParent.number() != m_blockChain->number() + 1)
         {
             return false;
         }
+        _parent = m_pipelineParent;
         return true;
     }
     void rehandleCommitedPrepareCache(PrepareReq const& req);
@@ -156,6 +206,21 @@ public:
     void setOmitEmptyBlock(bool setter) { m_omitEmptyBlock = setter; }
 
     void setMaxTTL(uint8_t const& ttl) { maxTTL = ttl; }
+    /// broadcast the block header and transaction hashes instead of the whole block
+    void setCompactPrepare(bool const& _compactPrepare) { m_compactPrepare = _compactPrepare; }
+    /// only keep the signatures of a quorum in the sig list of the committed block
+    void setCommitCertificate(bool const& _commitCertificate)
+    {
+        m_commitCertificate = _commitCertificate;
+    }
+    /// disseminate the prepare along a tree of sealers with the given width, 0 means broadcast
+    void setTreeBroadcastWidth(unsigned const& _treeWidth) { m_treeWidth = _treeWidth; }
+
+    /// the block executed by the sealer while packing needn't be executed again
+    void notePreExecutedSealing(Sealing const& _sealing)
+    {
+        cacheExecutedSealing(_sealing.block.blockHeader().hash(), _sealing);
+    }
 
     inline IDXTYPE getNextLeader() const { return (m_highestBlock.number() + 1) % m_nodeNum; }
 
@@ -189,6 +254,14 @@ protected:
         std::unordered_set<dev::network::NodeID> const& filter =
             std::unordered_set<dev::network::NodeID>(),
         unsigned const& ttl = 0);
+    /// send the message to the children of this node in the broadcast tree rooted at _rootIdx,
+    /// the children that are not connected are replaced by their own children
+    bool treeBroadcastMsg(unsigned const& packetType, std::string const& key, bytesConstRef data,
+        IDXTYPE const& _rootIdx);
+    /// the children of _idx in the m_treeWidth-ary tree of sealers rooted at _rootIdx
+    std::vector<IDXTYPE> treeChildren(IDXTYPE const& _rootIdx, IDXTYPE const& _idx) const;
+    /// broadcast the prepare to all the sealers if the tree broadcast timed out
+    void checkTreeBroadcastTimeout();
 
     void sendViewChangeMsg(dev::network::NodeID const& nodeId);
     bool sendMsg(dev::network::NodeID const& nodeId, unsigned const& packetType,
@@ -205,9 +278,19 @@ protected:
     /// handler called when receiving data from the network
     void onRecvPBFTMessage(dev::p2p::NetworkException exception,
         std::shared_ptr<dev::p2p::P2PSession> session, dev::p2p::P2PMessage::Ptr message);
+    /// check the signatures of the received message out of the workLoop
+    void preVerifyMsg(PBFTMsgPacket& pbftMsg);
     bool handlePrepareMsg(PrepareReq const& prepare_req, std::string const& endpoint = "self");
     /// handler prepare messages
     bool handlePrepareMsg(PrepareReq& prepareReq, PBFTMsgPacket const& pbftMsg);
+    /// rebuild the block of the compact prepare from txpool, request the missed transactions
+    bool handleCompactPrepareMsg(PrepareReq& prepareReq, PBFTMsgPacket const& pbftMsg);
+    /// response the transactions requested by the node rebuilding the compact prepare
+    void handleGetMissedTxsMsg(PBFTMsgPacket const& pbftMsg);
+    /// fill the missed transactions into the pending compact prepare and handle it
+    void handleMissedTxsMsg(PBFTMsgPacket const& pbftMsg);
+    /// drop the compact prepare waiting for the missed transactions
+    void clearPartiallyPrepare();
     /// 1. decode the network-received PBFTMsgPacket to signReq
     /// 2. check the validation of the signReq
     /// add the signReq to the cache and
@@ -216,6 +299,8 @@ protected:
     bool handleCommitMsg(CommitReq& commitReq, PBFTMsgPacket const& pbftMsg);
     bool handleViewChangeMsg(ViewChangeReq& viewChangeReq, PBFTMsgPacket const& pbftMsg);
     void handleMsg(PBFTMsgPacket const& pbftMsg);
+    /// forward the handled message to the other sealers until ttl expires
+    void forwardMsg(PBFTMsgPacket const& pbftMsg, PBFTMsg const& pbft_msg, std::string const& key);
     void catchupView(ViewChangeReq const& req, std::ostringstream& oss);
     void checkAndCommit();
 
@@ -230,9 +315,26 @@ protected:
     virtual void initBackupDB();
     void reloadMsg(std::string const& _key, PBFTMsg* _msg);
     void backupMsg(std::string const& _key, PBFTMsg const& _msg);
+    /// write the data to the backup log (or the backup DB if disk encryption is enabled)
+    void backupData(std::string const& _key, bytesConstRef _data);
+    bytes loadBackupData(std::string const& _key);
+    /// record the latency of the committed block and back up the timing statistics
+    void updateCommitLatency(int64_t const& _number, IDXTYPE const& _leader);
+    void getSealerTimeStatus(json_spirit::Array& status);
     inline std::string getBackupMsgPath() { return m_baseDir + "/" + c_backupMsgDirName; }
 
     bool checkSign(PBFTMsg const& req) const;
+    /// decode the request and take over the result of the pre-verification stage
+    template <class T>
+    inline bool decodePBFTMsg(T& req, PBFTMsgPacket const& pbftMsg)
+    {
+        if (!decodeToRequests(req, ref(pbftMsg.data)))
+        {
+            return false;
+        }
+        req.signVerifiedBy = pbftMsg.signVerifiedBy;
+        return true;
+    }
     inline bool broadcastFilter(
         dev::network::NodeID const& nodeId, unsigned const& packetType, std::string const& key)
     {
@@ -486,7 +588,21 @@ protected:
     void checkSealerList(dev::eth::Block const& block);
     /// check block
     bool checkBlock(dev::eth::Block const& block);
+    /// verify the signatures of the block in batches on the verify pool
+    bool verifySigList(dev::eth::Block const& block);
     void execBlock(Sealing& sealing, PrepareReq const& req, std::ostringstream& oss);
+    /// get the executed sealing of the given proposal, return false if it's not executed
+    bool loadExecutedSealing(h256 const& _hash, Sealing& _sealing);
+    /// keep the executed sealing, indexed by the hashes of the block before and after executed
+    void cacheExecutedSealing(h256 const& _hash, Sealing const& _sealing);
+    /// drop the executed sealings whose block number is no more than the given number
+    void clearExecutedSealings(int64_t const& _number);
+    /// encode the block header and the transaction hashes of the given block
+    void encodeCompactBlock(dev::eth::Block const& block, bytes& out) const;
+    /// set the transactions of the rebuilt block, check them with the transaction root and
+    /// handle the prepare request
+    bool handleRebuiltPrepare(
+        PrepareReq& prepareReq, dev::eth::Transactions const& txs, std::string const& endpoint);
     void changeViewForEmptyBlock()
     {
         m_timeManager.changeView();
@@ -517,10 +633,17 @@ protected:
 
     // backup msg
     std::shared_ptr<dev::db::LevelDB> m_backupDB = nullptr;
+    /// append-only backup log, the encrypted m_backupDB is used instead if disk encryption is on
+    std::shared_ptr<PBFTBackupWAL> m_backupWAL = nullptr;
+    WALSyncPolicy m_backupSyncPolicy = WALSyncPolicy::None;
 
     /// static vars
     static const std::string c_backupKeyCommitted;
     static const std::string c_backupMsgDirName;
+    static const std::string c_backupWALName;
+    static const std::string c_backupKeyTimeStats;
+    /// back up the timing statistics of the sealers every such blocks
+    static const unsigned c_timeStatsBackupInterval = 10;
     static const unsigned c_PopWaitSeconds = 5;
 
     std::shared_ptr<PBFTBroadcastCache> m_broadCastCache;
@@ -544,6 +667,43 @@ protected:
     /// map between nodeIdx to view
     mutable SharedMutex x_viewMap;
     std::map<IDXTYPE, VIEWTYPE> m_viewMap;
+
+    /// broadcast the prepare with block header and transaction hashes
+    bool m_compactPrepare = false;
+    /// the compact prepare waiting for the missed transactions (protected by m_mutex)
+    std::shared_ptr<PrepareReq> m_partiallyPrepare = nullptr;
+    PBFTMsgPacket m_partiallyPrepareMsg;
+    dev::eth::Transactions m_partiallyTxs;
+    std::vector<size_t> m_missedTxsIndex;
+    uint64_t m_partiallyPrepareTime = 0;
+    /// commit the block with the signatures of exactly 2f+1 sealers
+    bool m_commitCertificate = false;
+    /// propose the block of the next height while the current block is collecting commitReqs
+    bool m_pipeline = false;
+    /// header of the latest block locked by 2f+1 signReqs
+    dev::eth::BlockHeader m_pipelineParent;
+    Mutex x_pipelineParent;
+    /// height of the prepare proposed by this node before the last block committed
+    std::atomic<int64_t> m_pipelinedHeight = {-1};
+    /// width of the prepare broadcast tree, 0 disables the tree broadcast
+    unsigned m_treeWidth = 0;
+    /// the prepare sent along the broadcast tree by this leader (protected by m_mutex)
+    std::string m_treePrepareKey;
+    h256 m_treePrepareHash;
+    unsigned m_treePrepareType = PrepareReqPacket;
+    bytes m_treePrepareData;
+    uint64_t m_treePrepareTime = 0;
+    /// blocks executed but not committed, re-proposed in a new view without executing again
+    std::map<h256, Sealing> m_executedSealings;
+    Mutex x_executedSealings;
+
+    /// verify the signatures in parallel (keep them the last members, so that the workers are
+    /// joined before the other members are destroyed)
+    /// the signature lists of the blocks are split into batches verified by this pool
+    std::shared_ptr<dev::ThreadPool> m_sigListVerifyPool;
+    /// the messages of a sender are verified by the same single-thread pool, so that they enter
+    /// m_msgQueue in the order they are received
+    std::vector<std::shared_ptr<dev::ThreadPool>> m_msgVerifyPools;
 };
 }  // namespace consensus
 }  // namespace dev
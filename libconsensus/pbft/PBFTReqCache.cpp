@@ -55,7 +55,8 @@ void PBFTReqCache::delCache(h256 const& hash)
  * @param block: block need to append sig-list
  * @param minSigSize: minimum size of the sig list
  */
-bool PBFTReqCache::generateAndSetSigList(dev::eth::Block& block, IDXTYPE const& minSigSize)
+bool PBFTReqCache::generateAndSetSigList(
+    dev::eth::Block& block, IDXTYPE const& minSigSize, bool const& _quorumOnly)
 {
     std::vector<std::pair<u256, Signature>> sig_list;
     if (m_commitCache.count(m_prepareCache.block_hash) > 0)
@@ -69,6 +70,28 @@ bool PBFTReqCache::generateAndSetSigList(dev::eth::Block& block, IDXTYPE const&
         {
             return false;
         }
+        if (_quorumOnly)
+        {
+            /// the certificate: signatures of minSigSize distinct signers ordered by index
+            std::vector<std::pair<u256, Signature>> certificate;
+            std::set<u256> signers;
+            std::sort(sig_list.begin(), sig_list.end(),
+                [](std::pair<u256, Signature> const& _a, std::pair<u256, Signature> const& _b) {
+                    return _a.first < _b.first;
+                });
+            for (auto const& sig : sig_list)
+            {
+                if (certificate.size() < minSigSize && signers.insert(sig.first).second)
+                {
+                    certificate.push_back(sig);
+                }
+            }
+            /// keep all the signatures if there are not enough distinct signers
+            if (certificate.size() == minSigSize)
+            {
+                sig_list.swap(certificate);
+            }
+        }
         /// set siglist for prepare cache
         block.setSigList(sig_list);
         return true;
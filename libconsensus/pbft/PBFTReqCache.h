@@ -186,7 +186,9 @@ public:
     /// update m_committedPrepareCache to m_rawPrepareCache before broadcast the commit-request
     inline void updateCommittedPrepare() { m_committedPrepareCache = m_rawPrepareCache; }
     /// obtain the sig-list from m_commitCache, and append the sig-list to given block
-    bool generateAndSetSigList(dev::eth::Block& block, const IDXTYPE& minSigSize);
+    /// _quorumOnly: only keep the signatures of the first minSigSize distinct signers
+    bool generateAndSetSigList(
+        dev::eth::Block& block, const IDXTYPE& minSigSize, bool const& _quorumOnly = false);
     ///  determine can trigger viewchange or not
     bool canTriggerViewChange(VIEWTYPE& minView, IDXTYPE const& minInvalidNodeNum,
         VIEWTYPE const& toView, dev::eth::BlockHeader const& highestBlock,
@@ -30,11 +30,29 @@
 #include <libdevcore/CommonJS.h>
 #include <libdevcore/Worker.h>
 #include <libethcore/CommonJS.h>
+#include <libethcore/Exceptions.h>
+#include <libexecutive/ExecutionResult.h>
 using namespace dev::eth;
 using namespace dev::db;
 using namespace dev::blockverifier;
 using namespace dev::blockchain;
 using namespace dev::p2p;
+
+namespace
+{
+/// the errors caused by the transaction itself, the transaction fails the same way on every node
+bool isTransactionError(std::exception const& _e)
+{
+    if (dynamic_cast<PermissionDenied const*>(&_e))
+    {
+        return true;
+    }
+    auto e = dynamic_cast<dev::Exception const*>(&_e);
+    return e && dev::executive::toTransactionException(*e) !=
+                    dev::executive::TransactionException::Unknown;
+}
+}  // namespace
+
 namespace dev
 {
 namespace consensus
@@ -57,6 +75,10 @@ void PBFTSealer::handleBlock()
         return;
     }
     setBlock();
+    if (m_sealing.p_execContext)
+    {
+        m_pbftEngine->notePreExecutedSealing(m_sealing);
+    }
     PBFTSEALER_LOG(INFO) << LOG_DESC("++++++++++++++++ Generating seal on")
                          << LOG_KV("blkNum", m_sealing.block.header().number())
                          << LOG_KV("tx", m_sealing.block.getTransactionSize())
@@ -79,12 +101,117 @@ void PBFTSealer::handleBlock()
 }
 void PBFTSealer::setBlock()
 {
-    m_sealing.block.header().populateFromParent(
-        m_blockChain->getBlockByNumber(m_blockChain->number())->header());
+    /// the header of the pre-executed block is fixed when the execution starts
+    if (m_sealing.p_execContext)
+    {
+        m_sealing.block.calTransactionRoot();
+        m_blockVerifier->finalizeExecutedBlock(m_sealing.block, m_sealing.p_execContext);
+        return;
+    }
+    /// the block proposed in pipelined mode is the child of the locked block
+    BlockHeader parent;
+    if (m_pbftEngine->pipelineParent(parent) &&
+        m_sealing.block.header().number() == parent.number() + 1)
+    {
+        m_sealing.block.header().populateFromParent(parent);
+    }
+    else
+    {
+        m_sealing.block.header().populateFromParent(
+            m_blockChain->getBlockByNumber(m_blockChain->number())->header());
+    }
     resetSealingHeader(m_sealing.block.header());
     m_sealing.block.calTransactionRoot();
 }
 
+/**
+ * @brief: load transactions from the transaction pool and execute them on the leader, the
+ *         transactions failed by themselves are dropped before the block is proposed
+ * @param transToFetch: max transactions to fetch
+ */
+void PBFTSealer::loadTransactions(uint64_t const& transToFetch)
+{
+    if (!m_preExecute)
+    {
+        Sealer::loadTransactions(transToFetch);
+        return;
+    }
+    auto transactions = m_txPool->topTransactions(transToFetch, m_sealing.m_transactionSet, true);
+    if (transactions.empty())
+    {
+        return;
+    }
+    if (!m_sealing.p_execContext && !startPreExecution())
+    {
+        m_sealing.block.appendTransactions(transactions);
+        return;
+    }
+    for (auto it = transactions.begin(); it != transactions.end(); it++)
+    {
+        auto const& tx = *it;
+        try
+        {
+            m_blockVerifier->executeNextTransaction(m_sealing.block, tx, m_sealing.p_execContext);
+            m_sealing.block.appendTransaction(tx);
+        }
+        catch (std::exception const& e)
+        {
+            /// other failures (storage, context) are not the fault of the transaction, the
+            /// pre-execution is given up and the engine executes the whole block
+            if (!isTransactionError(e))
+            {
+                PBFTSEALER_LOG(WARNING)
+                    << LOG_DESC("loadTransactions: abandon the pre-execution")
+                    << LOG_KV("blkNum", m_sealing.block.blockHeader().number())
+                    << LOG_KV("txHash", tx.sha3().abridged())
+                    << LOG_KV("EINFO", boost::diagnostic_information(e));
+                m_sealing.p_execContext = nullptr;
+                m_sealing.block.clearAllReceipts();
+                m_sealing.block.appendTransactions(Transactions(it, transactions.end()));
+                return;
+            }
+            /// the hash stays in m_transactionSet in case of loading it again
+            PBFTSEALER_LOG(WARNING)
+                << LOG_DESC("loadTransactions: drop the transaction failed to execute")
+                << LOG_KV("blkNum", m_sealing.block.blockHeader().number())
+                << LOG_KV("txHash", tx.sha3().abridged())
+                << LOG_KV("EINFO", boost::diagnostic_information(e));
+            m_txPool->drop(tx.sha3());
+        }
+    }
+}
+
+/// only the leader proposing the child of the highest block executes the transactions while
+/// packing, the pipelined block and the block of the next leader are executed by the engine
+bool PBFTSealer::startPreExecution()
+{
+    auto parent = m_blockChain->getBlockByNumber(m_blockChain->number());
+    if (!parent || m_sealing.block.getTransactionSize() > 0 ||
+        m_sealing.block.blockHeader().number() != parent->header().number() + 1 ||
+        !m_pbftEngine->getLeader().first ||
+        m_pbftEngine->getLeader().second != m_pbftEngine->nodeIdx())
+    {
+        return false;
+    }
+    /// the environment of the transactions depends on the header
+    m_sealing.block.header().populateFromParent(parent->header());
+    resetSealingHeader(m_sealing.block.header());
+    try
+    {
+        BlockInfo parentBlockInfo{
+            parent->header().hash(), parent->header().number(), parent->header().stateRoot()};
+        m_sealing.p_execContext = m_blockVerifier->createExecutiveContext(parentBlockInfo);
+    }
+    catch (std::exception const& e)
+    {
+        PBFTSEALER_LOG(WARNING) << LOG_DESC("startPreExecution: create executive context failed")
+                                << LOG_KV("blkNum", m_sealing.block.blockHeader().number())
+                                << LOG_KV("EINFO", boost::diagnostic_information(e));
+        m_sealing.p_execContext = nullptr;
+    }
+    return m_sealing.p_execContext != nullptr;
+}
+
 /**
  * @brief: this node can generate block or not
  * @return true: this node can generate block
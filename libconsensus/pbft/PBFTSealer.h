@@ -45,7 +45,7 @@ public:
         std::shared_ptr<dev::blockverifier::BlockVerifierInterface> _blockVerifier,
         int16_t const& _protocolId, std::string const& _baseDir, KeyPair const& _key_pair,
         h512s const& _sealerList = h512s())
-      : Sealer(_txPool, _blockChain, _blockSync)
+      : Sealer(_txPool, _blockChain, _blockSync), m_blockVerifier(_blockVerifier)
     {
         m_consensusEngine = std::make_shared<PBFTEngine>(_service, _txPool, _blockChain, _blockSync,
             _blockVerifier, _protocolId, _baseDir, _key_pair, _sealerList);
@@ -66,13 +66,24 @@ public:
         return Sealer::shouldResetSealing() &&
                (m_pbftEngine->getLeader().second == m_pbftEngine->nodeIdx());
     }
+    /// execute the transactions while packing them into the block of the leader
+    void setPreExecute(bool const& _preExecute) { m_preExecute = _preExecute; }
 
 protected:
     void handleBlock() override;
+    /// execute the transactions one by one as they are packed if pre-execution is enabled
+    void loadTransactions(uint64_t const& transToFetch) override;
     bool shouldSeal() override;
     // only the leader can generate the latest block
+    // (or the next leader once the latest block is locked in pipelined mode)
     bool shouldHandleBlock() override
     {
+        dev::eth::BlockHeader parent;
+        if (m_sealing.block.blockHeader().number() == (m_blockChain->number() + 2) &&
+            m_pbftEngine->pipelineParent(parent))
+        {
+            return m_pbftEngine->getNextLeader() == m_pbftEngine->nodeIdx();
+        }
         return m_sealing.block.blockHeader().number() == (m_blockChain->number() + 1) &&
                (m_pbftEngine->getLeader().first &&
                    m_pbftEngine->getLeader().second == m_pbftEngine->nodeIdx());
@@ -113,9 +124,13 @@ private:
     }
 
     void setBlock();
+    /// fix the header of the sealing block and create the context to execute it on
+    bool startPreExecution();
 
 protected:
     std::shared_ptr<PBFTEngine> m_pbftEngine;
+    std::shared_ptr<dev::blockverifier::BlockVerifierInterface> m_blockVerifier;
+    bool m_preExecute = false;
 };
 }  // namespace consensus
 }  // namespace dev
@@ -0,0 +1,126 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2018 fisco-dev contributors.
+ */
+
+/**
+ * @brief : adaptive view timeout of PBFT
+ * @file: TimeManager.cpp
+ */
+#include "TimeManager.h"
+#include <libdevcore/RLP.h>
+#include <algorithm>
+
+using namespace dev;
+using namespace dev::consensus;
+
+namespace
+{
+/// the 95th percentile of the latencies
+uint64_t latencyPercentile(std::deque<uint64_t> const& _latencies)
+{
+    if (_latencies.empty())
+    {
+        return 0;
+    }
+    std::vector<uint64_t> sorted(_latencies.begin(), _latencies.end());
+    size_t index = sorted.size() * 95 / 100;
+    std::nth_element(sorted.begin(), sorted.begin() + index, sorted.end());
+    return sorted[index];
+}
+}  // namespace
+
+void TimeManager::updateLatency(h512 const& _sealer, uint64_t const& _latency)
+{
+    Guard l(x_sealerStats);
+    SealerTimeStats& stats = m_sealerStats[_sealer];
+    stats.latencies.push_back(_latency);
+    if (stats.latencies.size() > c_maxLatencySamples)
+    {
+        stats.latencies.pop_front();
+    }
+    stats.percentile = latencyPercentile(stats.latencies);
+    /// the sealer works again
+    stats.timeouts = 0;
+}
+
+void TimeManager::updateTimeouts(h512 const& _sealer)
+{
+    Guard l(x_sealerStats);
+    m_sealerStats[_sealer].timeouts++;
+}
+
+unsigned TimeManager::viewTimeout(h512 const& _leader) const
+{
+    if (!m_adaptive)
+    {
+        return m_viewTimeout;
+    }
+    unsigned minTimeout = m_viewTimeout / 2;
+    unsigned maxTimeout = m_viewTimeout * 4;
+    Guard l(x_sealerStats);
+    auto it = m_sealerStats.find(_leader);
+    if (it == m_sealerStats.end())
+    {
+        return m_viewTimeout;
+    }
+    /// the leader failed repeatedly, rotate to the next leader as soon as possible
+    if (it->second.timeouts >= c_leaderSkipTimeouts)
+    {
+        return minTimeout;
+    }
+    if (it->second.latencies.size() < c_minLatencySamples)
+    {
+        return m_viewTimeout;
+    }
+    uint64_t timeout = m_intervalBlockTime + c_latencyTimeoutFactor * it->second.percentile;
+    return (unsigned)std::max((uint64_t)minTimeout, std::min((uint64_t)maxTimeout, timeout));
+}
+
+void TimeManager::encodeSealerStats(bytes& _out) const
+{
+    Guard l(x_sealerStats);
+    RLPStream s;
+    s.appendList(m_sealerStats.size());
+    for (auto const& it : m_sealerStats)
+    {
+        s.appendList(3) << it.first << it.second.timeouts;
+        s.appendList(it.second.latencies.size());
+        for (auto const& latency : it.second.latencies)
+        {
+            s << (u256)latency;
+        }
+    }
+    s.swapOut(_out);
+}
+
+void TimeManager::decodeSealerStats(bytesConstRef _data)
+{
+    RLP rlp(_data);
+    std::map<h512, SealerTimeStats> sealerStats;
+    for (auto const& item : rlp)
+    {
+        h512 sealer = item[0].toHash<h512>(RLP::VeryStrict);
+        SealerTimeStats& stats = sealerStats[sealer];
+        stats.timeouts = item[1].toInt<unsigned>();
+        for (auto const& latency : item[2])
+        {
+            stats.latencies.push_back(latency.toInt<uint64_t>());
+        }
+        stats.percentile = latencyPercentile(stats.latencies);
+    }
+    Guard l(x_sealerStats);
+    m_sealerStats.swap(sealerStats);
+}
@@ -23,10 +23,34 @@
  */
 #pragma once
 #include <libdevcore/Common.h>
+#include <libdevcore/FixedHash.h>
+#include <libdevcore/Guards.h>
+#include <deque>
+#include <map>
 namespace dev
 {
 namespace consensus
 {
+/// prepare-to-commit latencies kept for each sealer
+static size_t const c_maxLatencySamples = 64;
+/// the adaptive timeout of a sealer is used after its latencies are sampled enough times
+static size_t const c_minLatencySamples = 8;
+/// the view timeout is this multiple of the 95th percentile latency besides the block interval
+static unsigned const c_latencyTimeoutFactor = 4;
+/// the views led by the sealer timed out so many times in a row end with the shortest timeout
+static unsigned const c_leaderSkipTimeouts = 2;
+
+/// timing statistics of the blocks proposed by a sealer
+struct SealerTimeStats
+{
+    /// latest prepare-to-commit latencies in milliseconds
+    std::deque<uint64_t> latencies;
+    /// 95th percentile of the latencies
+    uint64_t percentile = 0;
+    /// the views led by the sealer timed out since its last committed block
+    unsigned timeouts = 0;
+};
+
 struct TimeManager
 {
     /// last execution finish time, only one will be used at last
@@ -40,12 +64,22 @@ struct TimeManager
     std::chrono::system_clock::time_point m_lastGarbageCollection;
     const unsigned kMaxChangeCycle = 20;
     const unsigned CollectInterval = 60;
+    /// adapt the view timeout to the latencies of the leader
+    bool m_adaptive = false;
+    /// the base timeout of the current view
+    unsigned m_currentTimeout = 0;
+    /// time and height of the latest handled prepare
+    uint64_t m_prepareTime = 0;
+    int64_t m_prepareHeight = -1;
+    std::map<h512, SealerTimeStats> m_sealerStats;
+    mutable Mutex x_sealerStats;
 
     inline void initTimerManager(unsigned view_timeout)
     {
         m_lastConsensusTime = utcTime();
         m_lastSignTime = 0;
         m_viewTimeout = view_timeout;
+        m_currentTimeout = view_timeout;
         m_changeCycle = 0;
         m_lastGarbageCollection = std::chrono::system_clock::now();
     }
@@ -66,9 +100,24 @@ struct TimeManager
     {
         auto now = utcTime();
         auto last = std::max(m_lastConsensusTime, m_lastSignTime);
-        auto interval = (uint64_t)(m_viewTimeout * std::pow(1.5, m_changeCycle));
+        auto interval = (uint64_t)(m_currentTimeout * std::pow(1.5, m_changeCycle));
         return (now - last >= interval);
     }
+
+    /// record the prepare-to-commit latency of the block proposed by the sealer
+    void updateLatency(h512 const& _sealer, uint64_t const& _latency);
+    /// record the timeout of the view led by the sealer
+    void updateTimeouts(h512 const& _sealer);
+    /// the base timeout of the view led by the given sealer
+    unsigned viewTimeout(h512 const& _leader) const;
+    std::map<h512, SealerTimeStats> sealerStats() const
+    {
+        Guard l(x_sealerStats);
+        return m_sealerStats;
+    }
+    /// encode the statistics of all the sealers to be backed up
+    void encodeSealerStats(bytes& _out) const;
+    void decodeSealerStats(bytesConstRef _data);
 };
 }  // namespace consensus
 }  // namespace dev
@@ -151,6 +151,8 @@ void RaftEngine::reportBlock(dev::eth::Block const& _block)
         {
             m_lastBlockTime = utcTime();
             m_highestBlock = m_blockChain->getBlockByNumber(m_blockChain->number())->header();
+            /// notify the followers of the committed block at once
+            m_appendPending = (m_state == EN_STATE_LEADER);
         }
     }
 
@@ -339,7 +341,7 @@ void RaftEngine::tryCommitUncommitedBlock(RaftHeartBeatResp& _resp)
             }
             else
             {
-                if (_resp.uncommitedBlockHash == h256())
+                if (_resp.uncommitedBlockHash == h256() && m_nodeNum == 1)
                 {
                     // I'm the only one in sealer list, commit block without any ack
                     if (m_waitingForCommitting)
@@ -474,6 +476,7 @@ bool RaftEngine::runAsLeaderImp(std::unordered_map<h512, unsigned>& memberHeartb
                 return true;
             }
 
+            m_memberAppend[ret.second.nodeId].ackedHash = resp.uncommitedBlockHash;
             {
                 Guard guard(m_mutex);
 
@@ -537,6 +540,7 @@ void RaftEngine::runAsLeader()
     m_lastLeaderTerm = m_term;
     m_lastHeartbeatReset = m_lastHeartbeatTime = std::chrono::system_clock::now();
     std::unordered_map<h512, unsigned> memberHeartbeatLog;
+    m_memberAppend.clear();
 
     while (isWorking() && runAsLeaderImp(memberHeartbeatLog))
     {
@@ -765,7 +769,7 @@ bool RaftEngine::checkHeartbeatTimeout()
     return interval >= m_heartbeatTimeout;
 }
 
-P2PMessage::Ptr RaftEngine::generateHeartbeat()
+P2PMessage::Ptr RaftEngine::generateHeartbeat(bool _withBlock)
 {
     RaftHeartBeat hb;
     hb.idx = m_idx;
@@ -775,7 +779,7 @@ P2PMessage::Ptr RaftEngine::generateHeartbeat()
     hb.leader = m_idx;
     {
         Guard guard(m_commitMutex);
-        if (bool(m_uncommittedBlock))
+        if (_withBlock && bool(m_uncommittedBlock))
         {
             m_uncommittedBlock.encode(hb.uncommitedBlock);
             hb.uncommitedBlockNumber = m_consensusBlockNumber;
@@ -803,24 +807,72 @@ P2PMessage::Ptr RaftEngine::generateHeartbeat()
     return heartbeatMsg;
 }
 
+/// the heartbeat is sent once the interval passed, or at once if there is a new uncommitted
+/// block or a newly committed block. The uncommitted block is only sent to the followers which
+/// have not acknowledged it, and resent if not acknowledged in the heartbeat interval
 void RaftEngine::broadcastHeartbeat()
 {
     std::chrono::system_clock::time_point nowTime = std::chrono::system_clock::now();
     auto interval =
         std::chrono::duration_cast<std::chrono::milliseconds>(nowTime - m_lastHeartbeatTime)
             .count();
-    if (interval >= m_heartbeatInterval)
+    bool intervalReached = (interval >= m_heartbeatInterval);
+    if (!intervalReached && !m_appendPending)
     {
-        m_lastHeartbeatTime = nowTime;
-        auto heartbeatMsg = generateHeartbeat();
-        broadcastMsg(heartbeatMsg);
-        clearFirstVoteCache();
-        RAFTENGINE_LOG(DEBUG) << LOG_DESC("[#broadcastHeartbeat]Heartbeat broadcasted");
+        RAFTENGINE_LOG(TRACE) << LOG_DESC("[#broadcastHeartbeat]Too fast to broadcast heartbeat");
+        return;
     }
-    else
+    m_appendPending = false;
+    m_lastHeartbeatTime = nowTime;
+
+    h256 uncommittedHash;
     {
-        RAFTENGINE_LOG(TRACE) << LOG_DESC("[#broadcastHeartbeat]Too fast to broadcast heartbeat");
+        Guard guard(m_commitMutex);
+        if (bool(m_uncommittedBlock))
+        {
+            uncommittedHash = m_uncommittedBlock.header().hash();
+        }
     }
+    P2PMessage::Ptr blockMsg;
+    P2PMessage::Ptr heartbeatMsg;
+    auto sessions = m_service->sessionInfosByProtocolID(m_protocolId);
+    m_connectedNode = sessions.size();
+    for (auto session : sessions)
+    {
+        if (getIndexBySealer(session.nodeID) < 0)
+        {
+            continue;
+        }
+        AppendState& state = m_memberAppend[session.nodeID];
+        bool sendBlock = (uncommittedHash != h256() && state.ackedHash != uncommittedHash &&
+                          (state.sentHash != uncommittedHash ||
+                              nowTime - state.sentTime >=
+                                  std::chrono::milliseconds(m_heartbeatInterval)));
+        if (sendBlock)
+        {
+            if (!blockMsg)
+            {
+                blockMsg = generateHeartbeat(true);
+            }
+            state.sentHash = uncommittedHash;
+            state.sentTime = nowTime;
+            m_service->asyncSendMessageByNodeID(session.nodeID, blockMsg, nullptr);
+        }
+        else
+        {
+            if (!heartbeatMsg)
+            {
+                heartbeatMsg = generateHeartbeat(false);
+            }
+            m_service->asyncSendMessageByNodeID(session.nodeID, heartbeatMsg, nullptr);
+        }
+    }
+    if (intervalReached)
+    {
+        clearFirstVoteCache();
+    }
+    RAFTENGINE_LOG(DEBUG) << LOG_DESC("[#broadcastHeartbeat]Heartbeat broadcasted")
+                          << LOG_KV("withBlock", bool(blockMsg));
 }
 
 P2PMessage::Ptr RaftEngine::generateVoteReq()
@@ -1060,6 +1112,9 @@ bool RaftEngine::handleHeartbeat(u256 const& _from, h512 const& _node, RaftHeart
         return false;
     }
 
+    /// the leader has committed the block replicated to this node
+    commitFollowerBlock(_hb);
+
     RaftHeartBeatResp resp;
     resp.idx = m_idx;
     resp.term = m_term;
@@ -1067,7 +1122,16 @@ bool RaftEngine::handleHeartbeat(u256 const& _from, h512 const& _node, RaftHeart
     resp.blockHash = m_highestBlock.hash();
     resp.uncommitedBlockHash = h256(0);
 
-    if (_hb.hasData())
+    if (!_hb.hasData())
+    {
+        /// acknowledge the block received before, the leader doesn't resend it
+        Guard guard(m_commitMutex);
+        if (bool(m_uncommittedBlock) && m_uncommittedBlockNumber - 1 == m_highestBlock.number())
+        {
+            resp.uncommitedBlockHash = m_uncommittedBlock.header().hash();
+        }
+    }
+    else
     {
         if (_hb.uncommitedBlockNumber - 1 == m_highestBlock.number())
         {
@@ -1137,6 +1201,60 @@ bool RaftEngine::handleHeartbeat(u256 const& _from, h512 const& _node, RaftHeart
     return stepDown;
 }
 
+void RaftEngine::commitFollowerBlock(RaftHeartBeat const& _hb)
+{
+    Block block;
+    {
+        Guard guard(m_commitMutex);
+        if (!bool(m_uncommittedBlock) || m_uncommittedBlockNumber != _hb.height ||
+            _hb.height != m_highestBlock.number() + 1 || m_followerCommitting)
+        {
+            return;
+        }
+        block = m_uncommittedBlock;
+        m_followerCommitting = true;
+    }
+    /// the heartbeat is acknowledged without waiting for the execution, so that the follower
+    /// doesn't miss the heartbeats and start an election while executing a large block
+    int64_t number = _hb.height;
+    h256 leaderHash = _hb.blockHash;
+    m_commitPool->enqueue([this, block, number, leaderHash]() {
+        executeFollowerBlock(block, number, leaderHash);
+        Guard guard(m_commitMutex);
+        m_followerCommitting = false;
+    });
+}
+
+void RaftEngine::executeFollowerBlock(
+    Block const& _block, int64_t _number, h256 const& _leaderHash)
+{
+    Sealing workingSealing;
+    try
+    {
+        execBlock(workingSealing, _block);
+        /// the block is synchronized from the leader if the execution result differs
+        if (workingSealing.block.header().hash() != _leaderHash)
+        {
+            RAFTENGINE_LOG(WARNING)
+                << LOG_DESC("[#executeFollowerBlock]Executed hash mismatch")
+                << LOG_KV("number", _number)
+                << LOG_KV("hash", workingSealing.block.header().hash().abridged())
+                << LOG_KV("leaderHash", _leaderHash.abridged());
+            return;
+        }
+        RAFTENGINE_LOG(DEBUG) << LOG_DESC("[#executeFollowerBlock]Commit replicated block")
+                              << LOG_KV("number", _number);
+        checkAndSave(workingSealing);
+        reportBlock(workingSealing.block);
+    }
+    catch (std::exception& e)
+    {
+        RAFTENGINE_LOG(WARNING) << LOG_DESC("[#executeFollowerBlock]Block execute failed")
+                                << LOG_KV("number", _number)
+                                << LOG_KV("EINFO", boost::diagnostic_information(e));
+    }
+}
+
 void RaftEngine::recoverElectTime()
 {
     m_maxElectTimeout = m_maxElectTimeoutInit;
@@ -1400,6 +1518,8 @@ bool RaftEngine::commit(Block const& _block)
         RAFTENGINE_LOG(DEBUG) << LOG_DESC("[#commit]Prepare to commit block")
                               << LOG_KV("nextHeight", m_uncommittedBlockNumber);
     }
+    /// replicate the block to the followers at once
+    m_appendPending = true;
 
     std::unique_lock<std::mutex> ul(m_commitMutex);
     m_waitingForCommitting = true;
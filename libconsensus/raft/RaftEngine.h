@@ -27,6 +27,7 @@
 #include <libblockchain/BlockChainInterface.h>
 #include <libblockverifier/BlockVerifierInterface.h>
 #include <libconsensus/ConsensusEngineBase.h>
+#include <libdevcore/ThreadPool.h>
 #include <libethcore/Block.h>
 #include <libnetwork/Common.h>
 #include <libp2p/P2PInterface.h>
@@ -69,6 +70,8 @@ public:
         m_service->registerHandlerByProtoclID(
             m_protocolId, boost::bind(&RaftEngine::onRecvRaftMessage, this, _1, _2, _3));
         m_blockSync->registerConsensusVerifyHandler([](dev::eth::Block const&) { return true; });
+        m_commitPool =
+            std::make_shared<dev::ThreadPool>("raftCommit-" + std::to_string(m_groupId), 1);
     }
 
     raft::NodeIndex getNodeIdx() const
@@ -126,7 +129,8 @@ protected:
     bool isMajorityVote(u256 const& _votes) { return _votes >= m_nodeNum - m_f; }
 
     dev::p2p::P2PMessage::Ptr generateVoteReq();
-    dev::p2p::P2PMessage::Ptr generateHeartbeat();
+    /// generate the heartbeat, which carries the uncommitted block if _withBlock is true
+    dev::p2p::P2PMessage::Ptr generateHeartbeat(bool _withBlock = true);
 
     void broadcastVoteReq();
     void broadcastHeartbeat();
@@ -151,6 +155,11 @@ protected:
     bool runAsCandidateImp(dev::consensus::VoteState& _voteState);
 
     void tryCommitUncommitedBlock(dev::consensus::RaftHeartBeatResp& _resp);
+    /// commit the replicated block on the commit thread once the leader reports it as committed
+    void commitFollowerBlock(dev::consensus::RaftHeartBeat const& _hb);
+    /// execute the replicated block and commit it if the result matches the leader's block
+    void executeFollowerBlock(
+        dev::eth::Block const& _block, int64_t _number, h256 const& _leaderHash);
     virtual bool checkHeartbeatTimeout();
     virtual bool checkElectTimeout();
     ssize_t getIndexBySealer(dev::h512 const& _nodeId);
@@ -226,6 +235,21 @@ protected:
         BlockRef(u256 _height, h256 _hash) : height(_height), block_hash(_hash) {}
     };
     std::unordered_map<h512, BlockRef> m_memberBlock;  // <node_id, BlockRef>
+
+    /// replication state of the uncommitted block on a follower
+    struct AppendState
+    {
+        /// the uncommitted block acknowledged by the follower
+        h256 ackedHash;
+        /// the uncommitted block sent to the follower and the time it was sent
+        h256 sentHash;
+        std::chrono::system_clock::time_point sentTime;
+    };
+    /// only accessed by the leader thread
+    std::unordered_map<h512, AppendState> m_memberAppend;
+    /// send the heartbeat without waiting for the heartbeat interval, set when there's a new
+    /// uncommitted block or a newly committed block
+    std::atomic_bool m_appendPending = {false};
     static const unsigned c_PopWaitSeconds = 5;
 
     dev::storage::Storage::Ptr m_storage;
@@ -241,6 +265,13 @@ protected:
     bool m_commitReady;
     bool m_waitingForCommitting;
     std::unordered_map<h256, std::unordered_set<dev::consensus::IDXTYPE>> m_commitFingerPrint;
+    /// a replicated block is being executed by m_commitPool(protected by m_commitMutex)
+    bool m_followerCommitting = false;
+
+    /// executes and commits the blocks replicated to the follower, so that the heartbeats are
+    /// handled during the execution (keep it the last member, so that the worker is joined
+    /// before the other members are destroyed)
+    std::shared_ptr<dev::ThreadPool> m_commitPool;
 
 private:
     static typename raft::NodeIndex InvalidIndex;
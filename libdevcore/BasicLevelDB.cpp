@@ -133,6 +133,19 @@ leveldb::Iterator* BasicLevelDB::NewIterator(const leveldb::ReadOptions& _option
     return m_db->NewIterator(_options);
 }
 
+const leveldb::Snapshot* BasicLevelDB::GetSnapshot()
+{
+    if (!m_db)
+        return NULL;
+    return m_db->GetSnapshot();
+}
+
+void BasicLevelDB::ReleaseSnapshot(const leveldb::Snapshot* _snapshot)
+{
+    if (m_db && _snapshot)
+        m_db->ReleaseSnapshot(_snapshot);
+}
+
 std::unique_ptr<LevelDBWriteBatch> BasicLevelDB::createWriteBatch() const
 {
     return std::unique_ptr<LevelDBWriteBatch>(new LevelDBWriteBatch());
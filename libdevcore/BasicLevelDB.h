@@ -75,6 +75,10 @@ public:
 
     virtual leveldb::Iterator* NewIterator(const leveldb::ReadOptions& _options);
 
+    /// consistent view of the db, released by ReleaseSnapshot
+    virtual const leveldb::Snapshot* GetSnapshot();
+    virtual void ReleaseSnapshot(const leveldb::Snapshot* _snapshot);
+
     virtual std::unique_ptr<LevelDBWriteBatch> createWriteBatch() const;
 
     leveldb::Status OpenStatus() { return m_openStatus; }
@@ -0,0 +1,134 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2018 fisco-dev contributors.
+ */
+
+/**
+ * @brief: io_services run by one thread each, for the sockets of the network
+ *
+ * @file IOServicePool.h
+ * @date 2019-06-26
+ */
+
+#pragma once
+#include "Common.h"
+#include "easylog.h"
+#include <boost/asio.hpp>
+#include <boost/exception/diagnostic_information.hpp>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace dev
+{
+/// The sockets are spread over the io_services by round robin, all the handshakes, reads,
+/// writes and timers of a socket run on the thread of its io_service, so a socket needs no
+/// strand while the sockets are served in parallel
+class IOServicePool
+{
+public:
+    typedef std::shared_ptr<IOServicePool> Ptr;
+
+    /// @param _size: the number of the io_services, 0 for the number of the cores
+    IOServicePool(std::string const& _threadName, size_t _size) : m_threadName(_threadName)
+    {
+        if (_size == 0)
+            _size = std::max(std::thread::hardware_concurrency(), 1u);
+        for (size_t i = 0; i < _size; ++i)
+        {
+            auto ioService = std::make_shared<boost::asio::io_service>();
+            m_ioServices.push_back(ioService);
+            m_works.push_back(std::make_shared<boost::asio::io_service::work>(*ioService));
+        }
+        m_handled.reset(new std::atomic<uint64_t>[_size]);
+        for (size_t i = 0; i < _size; ++i)
+            m_handled[i] = 0;
+    }
+    ~IOServicePool() { stop(); }
+
+    void start()
+    {
+        if (!m_threads.empty())
+            return;
+        for (size_t i = 0; i < m_ioServices.size(); ++i)
+            m_threads.emplace_back([this, i]() { run(i); });
+    }
+    void stop()
+    {
+        m_works.clear();
+        for (auto ioService : m_ioServices)
+            ioService->stop();
+        for (auto& thread : m_threads)
+            thread.join();
+        m_threads.clear();
+    }
+
+    /// the io_service for a new socket
+    std::shared_ptr<boost::asio::io_service> next()
+    {
+        return m_ioServices[m_next++ % m_ioServices.size()];
+    }
+    /// the index of the io_service in the pool, size() if it's not in the pool
+    size_t indexOf(boost::asio::io_service const& _ioService) const
+    {
+        for (size_t i = 0; i < m_ioServices.size(); ++i)
+        {
+            if (m_ioServices[i].get() == &_ioService)
+                return i;
+        }
+        return m_ioServices.size();
+    }
+    size_t size() const { return m_ioServices.size(); }
+    /// the handlers run by each thread, the load of the threads
+    std::vector<uint64_t> handledTasks() const
+    {
+        std::vector<uint64_t> handled;
+        for (size_t i = 0; i < m_ioServices.size(); ++i)
+            handled.push_back(m_handled[i]);
+        return handled;
+    }
+
+private:
+    void run(size_t _index)
+    {
+        dev::pthread_setThreadName(m_threadName + "-" + std::to_string(_index));
+        auto ioService = m_ioServices[_index];
+        while (!ioService->stopped())
+        {
+            try
+            {
+                // run the handlers one by one to count them
+                while (ioService->run_one())
+                    m_handled[_index]++;
+            }
+            catch (std::exception& e)
+            {
+                LOG(WARNING) << LOG_DESC("Exception in IOServicePool thread")
+                             << LOG_KV("thread", m_threadName) << LOG_KV("index", _index)
+                             << LOG_KV("what", boost::diagnostic_information(e));
+            }
+        }
+    }
+
+    std::string m_threadName;
+    std::vector<std::shared_ptr<boost::asio::io_service>> m_ioServices;
+    std::vector<std::shared_ptr<boost::asio::io_service::work>> m_works;
+    std::vector<std::thread> m_threads;
+    std::unique_ptr<std::atomic<uint64_t>[]> m_handled;
+    std::atomic<size_t> m_next = {0};
+};
+
+}  // namespace dev
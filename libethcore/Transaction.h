@@ -221,6 +221,7 @@ public:
         bool _contractCreation, bytesConstRef _data, EVMSchedule const& _es);
 
     void setRpcCallback(RPCCallback callBack) { m_rpcCallback = callBack; }
+    RPCCallback const& rpcCallback() const { return m_rpcCallback; }
     void tiggerRpcCallback(LocalisedTransactionReceipt::Ptr pReceipt) const;
 
 protected:
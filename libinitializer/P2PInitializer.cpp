@@ -38,6 +38,10 @@ void P2PInitializer::initConfig(boost::property_tree::ptree const& _pt)
     INITIALIZER_LOG(DEBUG) << LOG_BADGE("P2PInitializer") << LOG_DESC("initConfig");
     std::string listenIP = _pt.get<std::string>("p2p.listen_ip", "0.0.0.0");
     int listenPort = _pt.get<int>("p2p.listen_port", 30300);
+    /// the threads running the sockets of the peers, 0 for the number of the cores
+    int ioThreads = _pt.get<int>("p2p.io_threads", 0);
+    /// compress the large payloads sent to the peers enabling it too
+    bool enableCompress = _pt.get<bool>("p2p.enable_compress", false);
     try
     {
         std::map<NodeIPEndpoint, NodeID> nodes;
@@ -112,6 +116,8 @@ void P2PInitializer::initConfig(boost::property_tree::ptree const& _pt)
 
         auto asioInterface = std::make_shared<dev::network::ASIOInterface>();
         asioInterface->setIOService(std::make_shared<ba::io_service>());
+        asioInterface->setIOServicePool(
+            std::make_shared<IOServicePool>("P2PIO", std::max(ioThreads, 0)));
         asioInterface->setSSLContext(m_SSLContext);
         asioInterface->setType(dev::network::ASIOInterface::SSL);
 
@@ -130,6 +136,7 @@ void P2PInitializer::initConfig(boost::property_tree::ptree const& _pt)
         m_p2pService->setStaticNodes(nodes);
         m_p2pService->setKeyPair(m_keyPair);
         m_p2pService->setP2PMessageFactory(messageFactory);
+        m_p2pService->setEnableCompress(enableCompress);
 
         m_p2pService->start();
     }
@@ -30,6 +30,8 @@ void RPCInitializer::initConfig(boost::property_tree::ptree const& _pt)
     std::string listenIP = _pt.get<std::string>("rpc.listen_ip", "0.0.0.0");
     int listenPort = _pt.get<int>("rpc.channel_listen_port", 20200);
     int httpListenPort = _pt.get<int>("rpc.jsonrpc_listen_port", 8545);
+    /// the threads running the sockets of the sdk connections, 0 for the number of the cores
+    int channelIOThreads = _pt.get<int>("rpc.channel_io_threads", 0);
     if (!isValidPort(listenPort) || !isValidPort(httpListenPort))
     {
         ERROR_OUTPUT << LOG_BADGE("RPCInitializer")
@@ -54,6 +56,8 @@ void RPCInitializer::initConfig(boost::property_tree::ptree const& _pt)
 
         auto server = std::make_shared<dev::channel::ChannelServer>();
         server->setIOService(ioService);
+        server->setIOServicePool(std::make_shared<IOServicePool>(
+            "ChannelIO", std::max(channelIOThreads, 0)));
         server->setSSLContext(m_sslContext);
         server->setEnableSSL(true);
         server->setBind(listenIP, listenPort);
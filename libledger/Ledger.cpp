@@ -33,6 +33,7 @@
 #include <libdevcore/easylog.h>
 #include <libprecompiled/Common.h>
 #include <libsync/SyncInterface.h>
+#include <libstorage/LevelDBStorage.h>
 #include <libsync/SyncMaster.h>
 #include <libtxpool/TxPool.h>
 #include <boost/algorithm/string.hpp>
@@ -148,14 +149,70 @@ void Ledger::initTxPoolConfig(ptree const& pt)
         m_param->mutableTxPoolParam().txPoolLimit = SYNC_TX_POOL_SIZE_DEFAULT;
         Ledger_LOG(WARNING) << LOG_BADGE("txPoolLimit") << LOG_DESC("txPoolLimit invalid");
     }
+    /// priority lanes: comma separated sender addresses and lane weights
+    try
+    {
+        std::vector<std::string> items;
+        std::string senders = pt.get<std::string>("tx_pool.priority_senders", "");
+        boost::split(items, senders, boost::is_any_of(","), boost::token_compress_on);
+        for (auto& item : items)
+        {
+            boost::trim(item);
+            if (!item.empty())
+                m_param->mutableTxPoolParam().prioritySenders.push_back(dev::h160(item));
+        }
+        std::string weights = pt.get<std::string>("tx_pool.lane_weights", "");
+        boost::split(items, weights, boost::is_any_of(","), boost::token_compress_on);
+        for (auto& item : items)
+        {
+            boost::trim(item);
+            if (!item.empty())
+                m_param->mutableTxPoolParam().laneWeights.push_back(
+                    boost::lexical_cast<uint64_t>(item));
+        }
+        Ledger_LOG(DEBUG) << LOG_BADGE("initTxPoolConfig")
+                          << LOG_KV("prioritySenders",
+                                 m_param->mutableTxPoolParam().prioritySenders.size())
+                          << LOG_KV("laneWeights", weights);
+    }
+    catch (std::exception& e)
+    {
+        m_param->mutableTxPoolParam().prioritySenders.clear();
+        m_param->mutableTxPoolParam().laneWeights.clear();
+        Ledger_LOG(WARNING) << LOG_BADGE("initTxPoolConfig")
+                            << LOG_DESC("priority lanes config invalid, use default")
+                            << LOG_KV("EINFO", boost::diagnostic_information(e));
+    }
 }
 
 
 void Ledger::initConsensusIniConfig(ptree const& pt)
 {
     m_param->mutableConsensusParam().maxTTL = pt.get<uint8_t>("consensus.ttl", MAXTTL);
+    m_param->mutableConsensusParam().compactPrepare =
+        pt.get<bool>("consensus.compact_prepare", false);
+    m_param->mutableConsensusParam().commitCertificate =
+        pt.get<bool>("consensus.commit_certificate", false);
+    m_param->mutableConsensusParam().treeBroadcastWidth =
+        pt.get<unsigned>("consensus.tree_broadcast_width", 0);
+    m_param->mutableConsensusParam().pipeline = pt.get<bool>("consensus.pipeline", false);
+    m_param->mutableConsensusParam().adaptiveTimeout =
+        pt.get<bool>("consensus.adaptive_timeout", false);
+    m_param->mutableConsensusParam().preExecute = pt.get<bool>("consensus.pre_execute", false);
+    m_param->mutableConsensusParam().backupSync =
+        pt.get<std::string>("consensus.backup_sync", "none");
     Ledger_LOG(DEBUG) << LOG_BADGE("initConsensusIniConfig")
-                      << LOG_KV("maxTTL", std::to_string(m_param->mutableConsensusParam().maxTTL));
+                      << LOG_KV("maxTTL", std::to_string(m_param->mutableConsensusParam().maxTTL))
+                      << LOG_KV("compactPrepare", m_param->mutableConsensusParam().compactPrepare)
+                      << LOG_KV("commitCertificate",
+                             m_param->mutableConsensusParam().commitCertificate)
+                      << LOG_KV("treeBroadcastWidth",
+                             m_param->mutableConsensusParam().treeBroadcastWidth)
+                      << LOG_KV("pipeline", m_param->mutableConsensusParam().pipeline)
+                      << LOG_KV("adaptiveTimeout",
+                             m_param->mutableConsensusParam().adaptiveTimeout)
+                      << LOG_KV("preExecute", m_param->mutableConsensusParam().preExecute)
+                      << LOG_KV("backupSync", m_param->mutableConsensusParam().backupSync);
 }
 
 
@@ -210,6 +267,9 @@ void Ledger::initConsensusConfig(ptree const& pt)
 
 /// init sync related configurations
 /// 1. idleWaitMs: default is 30ms
+/// 2. announceTransactions: broadcast transaction hashes instead of bodies, default is false
+/// 3. snapshotInterval: blocks between the state snapshots served to the peers, default is 0
+/// 4. fastSync: download a state snapshot instead of replaying blocks, default is false
 void Ledger::initSyncConfig(ptree const& pt)
 {
     try
@@ -224,6 +284,36 @@ void Ledger::initSyncConfig(ptree const& pt)
         m_param->mutableSyncParam().idleWaitMs = SYNC_IDLE_WAIT_DEFAULT;
         Ledger_LOG(WARNING) << LOG_BADGE("initSyncConfig") << LOG_DESC("idleWaitMs invalid");
     }
+    try
+    {
+        m_param->mutableSyncParam().announceTransactions =
+            pt.get<bool>("sync.announce_txs", false);
+        Ledger_LOG(DEBUG) << LOG_BADGE("initSyncConfig")
+                          << LOG_KV("announceTransactions",
+                                 m_param->mutableSyncParam().announceTransactions);
+    }
+    catch (std::exception& e)
+    {
+        m_param->mutableSyncParam().announceTransactions = false;
+        Ledger_LOG(WARNING) << LOG_BADGE("initSyncConfig")
+                            << LOG_DESC("announceTransactions invalid");
+    }
+    try
+    {
+        m_param->mutableSyncParam().snapshotInterval =
+            pt.get<int64_t>("sync.snapshot_interval", 0);
+        m_param->mutableSyncParam().fastSync = pt.get<bool>("sync.fast_sync", false);
+        Ledger_LOG(DEBUG) << LOG_BADGE("initSyncConfig")
+                          << LOG_KV(
+                                 "snapshotInterval", m_param->mutableSyncParam().snapshotInterval)
+                          << LOG_KV("fastSync", m_param->mutableSyncParam().fastSync);
+    }
+    catch (std::exception& e)
+    {
+        m_param->mutableSyncParam().snapshotInterval = 0;
+        m_param->mutableSyncParam().fastSync = false;
+        Ledger_LOG(WARNING) << LOG_BADGE("initSyncConfig") << LOG_DESC("snapshot config invalid");
+    }
 }
 
 /// init db related configurations:
@@ -280,9 +370,23 @@ bool Ledger::initTxPool()
         Ledger_LOG(ERROR) << LOG_BADGE("initLedger") << LOG_DESC("initTxPool Failed");
         return false;
     }
-    m_txPool = std::make_shared<dev::txpool::TxPool>(
+    auto txPool = std::make_shared<dev::txpool::TxPool>(
         m_service, m_blockChain, protocol_id, m_param->mutableTxPoolParam().txPoolLimit);
+    m_txPool = txPool;
     m_txPool->setMaxBlockLimit(g_BCOSConfig.c_blockLimit);
+    txPool->setPrioritySenders(m_param->mutableTxPoolParam().prioritySenders);
+    auto const& laneWeights = m_param->mutableTxPoolParam().laneWeights;
+    if (laneWeights.size() == dev::txpool::LaneCount)
+    {
+        std::array<uint64_t, dev::txpool::LaneCount> weights;
+        std::copy(laneWeights.begin(), laneWeights.end(), weights.begin());
+        txPool->setLaneWeights(weights);
+    }
+    else if (!laneWeights.empty())
+    {
+        Ledger_LOG(WARNING) << LOG_BADGE("initTxPool") << LOG_DESC("invalid lane weights, ignore")
+                            << LOG_KV("size", laneWeights.size());
+    }
     Ledger_LOG(DEBUG) << LOG_BADGE("initLedger") << LOG_DESC("initTxPool SUCC");
     return true;
 }
@@ -369,6 +473,15 @@ std::shared_ptr<Sealer> Ledger::createPBFTSealer()
     pbftEngine->setStorage(m_dbInitializer->storage());
     pbftEngine->setOmitEmptyBlock(g_BCOSConfig.c_omitEmptyBlock);
     pbftEngine->setMaxTTL(m_param->mutableConsensusParam().maxTTL);
+    pbftEngine->setCompactPrepare(m_param->mutableConsensusParam().compactPrepare);
+    pbftEngine->setCommitCertificate(m_param->mutableConsensusParam().commitCertificate);
+    pbftEngine->setTreeBroadcastWidth(m_param->mutableConsensusParam().treeBroadcastWidth);
+    pbftEngine->setPipeline(m_param->mutableConsensusParam().pipeline);
+    pbftEngine->setAdaptiveTimeout(m_param->mutableConsensusParam().adaptiveTimeout);
+    pbftEngine->setBackupSyncPolicy(
+        PBFTBackupWAL::toSyncPolicy(m_param->mutableConsensusParam().backupSync));
+    std::dynamic_pointer_cast<PBFTSealer>(pbftSealer)->setPreExecute(
+        m_param->mutableConsensusParam().preExecute);
     return pbftSealer;
 }
 
@@ -445,8 +558,17 @@ bool Ledger::initSync()
     }
     dev::PROTOCOL_ID protocol_id = getGroupProtoclID(m_groupId, ProtocolID::BlockSync);
     dev::h256 genesisHash = m_blockChain->getBlockByNumber(int64_t(0))->headerHash();
-    m_sync = std::make_shared<SyncMaster>(m_service, m_txPool, m_blockChain, m_blockVerifier,
-        protocol_id, m_keyPair.pub(), genesisHash, m_param->mutableSyncParam().idleWaitMs);
+    auto syncMaster = std::make_shared<SyncMaster>(m_service, m_txPool, m_blockChain,
+        m_blockVerifier, protocol_id, m_keyPair.pub(), genesisHash,
+        m_param->mutableSyncParam().idleWaitMs, m_param->mutableSyncParam().announceTransactions);
+    auto storage = std::dynamic_pointer_cast<dev::storage::LevelDBStorage>(
+        m_dbInitializer->storage());
+    if (storage)
+    {
+        storage->setSnapshotInterval(m_param->mutableSyncParam().snapshotInterval);
+        syncMaster->setSnapshotStorage(storage, m_param->mutableSyncParam().fastSync);
+    }
+    m_sync = syncMaster;
     Ledger_LOG(DEBUG) << LOG_BADGE("initLedger") << LOG_DESC("initSync SUCC");
     return true;
 }
@@ -36,6 +36,10 @@ namespace ledger
 struct TxPoolParam
 {
     uint64_t txPoolLimit = SYNC_TX_POOL_SIZE_DEFAULT;
+    /// transactions from these senders are put into the priority lane
+    dev::h160s prioritySenders = dev::h160s();
+    /// weights of the system, priority-sender and normal lanes(empty means default)
+    std::vector<uint64_t> laneWeights = std::vector<uint64_t>();
 };
 struct ConsensusParam
 {
@@ -44,6 +48,20 @@ struct ConsensusParam
     dev::h512s observerList = dev::h512s();
     uint64_t maxTransactions;
     uint8_t maxTTL;
+    /// broadcast the prepare with block header and transaction hashes
+    bool compactPrepare = false;
+    /// commit the block with the signatures of exactly 2f+1 sealers
+    bool commitCertificate = false;
+    /// width of the tree disseminating the prepare, 0 means broadcast to all sealers
+    unsigned treeBroadcastWidth = 0;
+    /// propose the next block once the current block is locked by 2f+1 signatures
+    bool pipeline = false;
+    /// adapt the view timeout to the commit latencies of the leader
+    bool adaptiveTimeout = false;
+    /// execute the transactions while the leader packs them
+    bool preExecute = false;
+    /// when to fsync the PBFT backup log: none, batch or always
+    std::string backupSync = "none";
     /// unsigned intervalBlockTime;
     uint64_t minElectTime;
     uint64_t maxElectTime;
@@ -61,6 +79,12 @@ struct SyncParam
 {
     /// TODO: syncParam related
     unsigned idleWaitMs = SYNC_IDLE_WAIT_DEFAULT;
+    /// broadcast transaction hashes instead of full transactions
+    bool announceTransactions = false;
+    /// take a state snapshot every given number of blocks for the new nodes, 0 means never
+    int64_t snapshotInterval = 0;
+    /// download the snapshot of a checkpoint instead of replaying the blocks from genesis
+    bool fastSync = false;
 };
 
 struct GenesisParam
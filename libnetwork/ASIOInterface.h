@@ -22,6 +22,7 @@
  */
 #pragma once
 #include "Socket.h"
+#include <libdevcore/IOServicePool.h>
 #include <boost/asio.hpp>
 #include <boost/asio/ip/tcp.hpp>
 #include <boost/asio/ssl.hpp>
@@ -61,6 +62,13 @@ public:
         m_ioService = ioService;
     }
 
+    /// the sockets run on the pool if it's set, the acceptor and the timers run on ioService
+    virtual std::shared_ptr<dev::IOServicePool> ioServicePool() { return m_ioServicePool; }
+    virtual void setIOServicePool(std::shared_ptr<dev::IOServicePool> ioServicePool)
+    {
+        m_ioServicePool = ioServicePool;
+    }
+
     virtual std::shared_ptr<ba::ssl::context> sslContext() { return m_sslContext; }
     virtual void setSSLContext(std::shared_ptr<ba::ssl::context> sslContext)
     {
@@ -75,8 +83,9 @@ public:
 
     virtual std::shared_ptr<SocketFace> newSocket(NodeIPEndpoint nodeIPEndpoint = NodeIPEndpoint())
     {
+        auto ioService = m_ioServicePool ? m_ioServicePool->next() : m_ioService;
         std::shared_ptr<SocketFace> m_socket =
-            std::make_shared<Socket>(*m_ioService, *m_sslContext, nodeIPEndpoint);
+            std::make_shared<Socket>(*ioService, *m_sslContext, nodeIPEndpoint);
         return m_socket;
     }
 
@@ -90,6 +99,8 @@ public:
                               boost::asio::ip::address::from_string(listenHost), listenPort));
         boost::asio::socket_base::reuse_address optionReuseAddress(true);
         m_acceptor->set_option(optionReuseAddress);
+        if (m_ioServicePool)
+            m_ioServicePool->start();
     }
 
     virtual void run() { m_ioService->run(); }
@@ -104,6 +115,8 @@ public:
         }
 
         m_ioService->stop();
+        if (m_ioServicePool)
+            m_ioServicePool->stop();
     }
 
     virtual void reset()
@@ -127,11 +140,12 @@ public:
         socket->ref().async_connect(peer_endpoint, handler);
     }
 
+    /// write the buffers in order, e.g. the header and the shared payload of a message
     virtual void asyncWrite(std::shared_ptr<SocketFace> socket,
-        boost::asio::mutable_buffers_1 buffers, ReadWriteHandler handler)
+        std::vector<boost::asio::const_buffer> buffers, ReadWriteHandler handler)
     {
         auto type = m_type;
-        m_ioService->post([type, socket, buffers, handler]() {
+        socket->ref().get_io_service().post([type, socket, buffers, handler]() {
             if (socket->isConnected())
             {
                 switch (type)
@@ -224,9 +238,15 @@ public:
     }
 
     virtual void strandPost(Base_Handler handler) { m_strand->post(handler); }
+    /// run the handler on the thread of the socket
+    virtual void socketPost(std::shared_ptr<SocketFace> socket, Base_Handler handler)
+    {
+        socket->ref().get_io_service().post(handler);
+    }
 
 private:
     std::shared_ptr<ba::io_service> m_ioService;
+    std::shared_ptr<dev::IOServicePool> m_ioServicePool;
     std::shared_ptr<ba::io_service::strand> m_strand;
     std::shared_ptr<bi::tcp::acceptor> m_acceptor;
     std::shared_ptr<ba::ssl::context> m_sslContext;
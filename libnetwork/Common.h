@@ -126,6 +126,15 @@ public:
 
     virtual void encode(bytes& buffer) = 0;
     virtual ssize_t decode(const byte* buffer, size_t size) = 0;
+
+    /// encode the header into @a _header, @returns the payload written after it as is, so the
+    /// sessions sending the message share the payload instead of copying it, and the payload
+    /// mustn't be changed after sending; nullptr if the message is all encoded into @a _header
+    virtual std::shared_ptr<bytes> encodeHeader(bytes& _header)
+    {
+        encode(_header);
+        return nullptr;
+    }
 };
 
 class MessageFactory : public std::enable_shared_from_this<MessageFactory>
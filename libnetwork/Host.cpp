@@ -340,8 +340,9 @@ void Host::asyncConnect(NodeIPEndpoint const& _nodeIPEndpoint,
     std::shared_ptr<SocketFace> socket = m_asioInterface->newSocket(_nodeIPEndpoint);
 
     /// if async connect timeout, close the socket directly
+    /// the timer runs on the thread of the socket it closes
     auto connect_timer = std::make_shared<boost::asio::deadline_timer>(
-        *(m_asioInterface->ioService()), boost::posix_time::milliseconds(m_connectTimeThre));
+        socket->ref().get_io_service(), boost::posix_time::milliseconds(m_connectTimeThre));
     connect_timer->async_wait([=](const boost::system::error_code& error) {
         /// return when cancel has been called
         if (error == boost::asio::error::operation_aborted)
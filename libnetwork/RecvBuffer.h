@@ -0,0 +1,89 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2018 fisco-dev contributors.
+ */
+/**
+ * @brief : the reusable ingress buffer of the session
+ * @file: RecvBuffer.h
+ * @date: 2019-06-24
+ */
+
+#pragma once
+#include <libdevcore/Common.h>
+#include <boost/asio/buffer.hpp>
+#include <cstring>
+
+namespace dev
+{
+namespace network
+{
+/// the size of the first read, and of the buffer once the large messages are consumed
+static size_t const c_recvBufferSize = 64 * 1024;
+/// the free space below which the partial message is moved to the front before reading
+static size_t const c_minRecvSpace = 4 * 1024;
+/// the grown buffer is kept for the next large message unless it's larger than this
+static size_t const c_maxIdleRecvBufferSize = 4 * 1024 * 1024;
+
+/// The messages are decoded in place from the front of the buffer and consumed by moving an
+/// offset, the bytes are only moved when the unconsumed partial message is near the end, and the
+/// buffer is doubled when the partial message fills it
+class RecvBuffer
+{
+public:
+    RecvBuffer(size_t _capacity = c_recvBufferSize)
+      : m_buffer(_capacity), m_initialCapacity(_capacity)
+    {}
+
+    /// the free space to read into
+    boost::asio::mutable_buffers_1 prepare()
+    {
+        if (m_buffer.size() - m_end < c_minRecvSpace && m_begin > 0)
+        {
+            std::memmove(m_buffer.data(), m_buffer.data() + m_begin, m_end - m_begin);
+            m_end -= m_begin;
+            m_begin = 0;
+        }
+        if (m_buffer.size() - m_end < c_minRecvSpace)
+            m_buffer.resize(std::max(m_buffer.size() * 2, m_end + c_minRecvSpace));
+        return boost::asio::buffer(m_buffer.data() + m_end, m_buffer.size() - m_end);
+    }
+    /// @a _size bytes are read into the space returned by prepare
+    void commit(size_t _size) { m_end += _size; }
+
+    /// the received bytes not consumed
+    byte const* data() const { return m_buffer.data() + m_begin; }
+    size_t size() const { return m_end - m_begin; }
+    void consume(size_t _size)
+    {
+        m_begin += std::min(_size, size());
+        if (m_begin < m_end)
+            return;
+        m_begin = m_end = 0;
+        if (m_buffer.size() > c_maxIdleRecvBufferSize)
+            bytes(m_initialCapacity).swap(m_buffer);
+    }
+
+    size_t capacity() const { return m_buffer.size(); }
+
+private:
+    bytes m_buffer;
+    size_t m_initialCapacity;
+    /// [m_begin, m_end) are received but not consumed
+    size_t m_begin = 0;
+    size_t m_end = 0;
+};
+
+}  // namespace network
+}  // namespace dev
@@ -102,10 +102,11 @@ void Session::asyncSendMessage(Message::Ptr message, Options options, CallbackFu
     }
     SESSION_LOG(TRACE) << LOG_DESC("Session asyncSendMessage")
                        << LOG_KV("seq2Callback.size", m_seq2Callback->size());
-    std::shared_ptr<bytes> p_buffer = std::make_shared<bytes>();
-    message->encode(*p_buffer);
+    SendBuffer buffer;
+    buffer.header = std::make_shared<bytes>();
+    buffer.payload = message->encodeHeader(*buffer.header);
     message.reset();
-    send(p_buffer);
+    send(buffer);
 }
 
 bool Session::actived() const
@@ -116,7 +117,7 @@ bool Session::actived() const
     return false;
 }
 
-void Session::send(std::shared_ptr<bytes> _msg)
+void Session::send(SendBuffer const& _buffer)
 {
     if (!actived())
     {
@@ -130,13 +131,13 @@ void Session::send(std::shared_ptr<bytes> _msg)
     {
         Guard l(x_writeQueue);
 
-        m_writeQueue.push(make_pair(_msg, u256(utcTime())));
+        m_writeQueue.push(std::make_pair(_buffer, utcTime()));
     }
 
     write();
 }
 
-void Session::onWrite(boost::system::error_code ec, std::size_t, std::shared_ptr<bytes>)
+void Session::onWrite(boost::system::error_code ec, std::size_t, SendBuffer)
 {
     if (!actived())
     {
@@ -200,21 +201,41 @@ void Session::write()
 
         m_writing = true;
 
-        std::pair<std::shared_ptr<bytes>, u256> task;
-        u256 enter_time = u256(0);
-
         if (m_writeQueue.empty())
         {
             m_writing = false;
             return;
         }
 
-        task = m_writeQueue.top();
+        SendBuffer buffer = m_writeQueue.top().first;
         m_writeQueue.pop();
-
-        enter_time = task.second;
+        // copy a small message with the small messages queued behind into one buffer, so the
+        // burst costs one write and one TLS record instead of one each
+        bool gathered = buffer.payload && !buffer.payload->empty();
+        bool batched = !m_writeQueue.empty() &&
+                       buffer.size() + m_writeQueue.top().first.size() <= c_maxWriteBatchBytes;
+        if (buffer.size() < c_maxWriteBatchBytes && (gathered || batched))
+        {
+            auto batch = std::make_shared<bytes>();
+            batch->reserve(batched ? c_maxWriteBatchBytes : buffer.size());
+            buffer.appendTo(*batch);
+            size_t messages = 1;
+            while (!m_writeQueue.empty() && messages < c_maxWriteBatchMessages &&
+                   batch->size() + m_writeQueue.top().first.size() <= c_maxWriteBatchBytes)
+            {
+                m_writeQueue.top().first.appendTo(*batch);
+                m_writeQueue.pop();
+                ++messages;
+            }
+            buffer.header = batch;
+            buffer.payload.reset();
+        }
+        // only the header and the large payload shared with the other sessions are gathered, the
+        // payload is written without being copied
+        std::vector<boost::asio::const_buffer> buffers{boost::asio::buffer(*buffer.header)};
+        if (buffer.payload && !buffer.payload->empty())
+            buffers.push_back(boost::asio::buffer(*buffer.payload));
         auto session = shared_from_this();
-        auto buffer = task.first;
 
         auto server = m_server.lock();
         if (server && server->haveNetwork())
@@ -222,7 +243,7 @@ void Session::write()
             if (m_socket->isConnected())
             {
                 // asio::buffer referecne buffer, so buffer need alive before asio::buffer be used
-                server->asioInterface()->asyncWrite(m_socket, boost::asio::buffer(*buffer),
+                server->asioInterface()->asyncWrite(m_socket, buffers,
                     boost::bind(&Session::onWrite, session, boost::asio::placeholders::error,
                         boost::asio::placeholders::bytes_transferred, buffer));
             }
@@ -321,9 +342,9 @@ void Session::drop(DisconnectReason _reason)
             {
                 socket->close();
             }
-            auto shutdown_timer =
-                std::make_shared<boost::asio::deadline_timer>(*server->asioInterface()->ioService(),
-                    boost::posix_time::milliseconds(m_shutDownTimeThres));
+            auto shutdown_timer = std::make_shared<boost::asio::deadline_timer>(
+                socket->ref().get_io_service(),
+                boost::posix_time::milliseconds(m_shutDownTimeThres));
             /// async wait for shutdown
             shutdown_timer->async_wait([socket](const boost::system::error_code& error) {
                 /// drop operation has been aborted
@@ -386,8 +407,8 @@ void Session::start()
         auto server = m_server.lock();
         if (server && server->haveNetwork())
         {
-            server->asioInterface()->strandPost(
-                boost::bind(&Session::doRead, shared_from_this()));  // doRead();
+            server->asioInterface()->socketPost(
+                m_socket, boost::bind(&Session::doRead, shared_from_this()));  // doRead();
 
             m_actived = true;
         }
@@ -412,19 +433,19 @@ void Session::doRead()
                     s->drop(TCPError);
                     return;
                 }
-                s->m_data.insert(
-                    s->m_data.end(), s->m_recvBuffer, s->m_recvBuffer + bytesTransferred);
+                s->m_recvBuffer.commit(bytesTransferred);
 
                 while (true)
                 {
                     Message::Ptr message = s->m_messageFactory->buildMessage();
-                    ssize_t result = message->decode(s->m_data.data(), s->m_data.size());
+                    ssize_t result =
+                        message->decode(s->m_recvBuffer.data(), s->m_recvBuffer.size());
                     if (result > 0)
                     {
                         /// SESSION_LOG(TRACE) << "Decode success: " << result;
                         NetworkException e(P2PExceptionType::Success, "Success");
                         s->onMessage(e, message);
-                        s->m_data.erase(s->m_data.begin(), s->m_data.begin() + result);
+                        s->m_recvBuffer.consume(result);
                     }
                     else if (result == 0)
                     {
@@ -446,8 +467,7 @@ void Session::doRead()
 
         if (m_socket->isConnected())
         {
-            server->asioInterface()->asyncReadSome(
-                m_socket, boost::asio::buffer(m_recvBuffer, BUFFER_LENGTH), asyncRead);
+            server->asioInterface()->asyncReadSome(m_socket, m_recvBuffer.prepare(), asyncRead);
         }
         else
         {
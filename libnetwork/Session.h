@@ -33,6 +33,7 @@
 #include <utility>
 
 #include "Common.h"
+#include "RecvBuffer.h"
 #include "SessionFace.h"
 
 
@@ -43,6 +44,26 @@ namespace network
 class Host;
 class SocketFace;
 
+/// the small messages queued are coalesced into one write up to these limits
+static size_t const c_maxWriteBatchMessages = 64;
+static size_t const c_maxWriteBatchBytes = 64 * 1024;
+
+/// An encoded message to write, the header is encoded for the session and the payload may be
+/// shared by all the sessions multicasting the message
+struct SendBuffer
+{
+    std::shared_ptr<bytes> header;
+    std::shared_ptr<bytes> payload;
+
+    size_t size() const { return header->size() + (payload ? payload->size() : 0); }
+    void appendTo(bytes& _out) const
+    {
+        _out.insert(_out.end(), header->begin(), header->end());
+        if (payload)
+            _out.insert(_out.end(), payload->begin(), payload->end());
+    }
+};
+
 class Session : public SessionFace, public std::enable_shared_from_this<Session>
 {
 public:
@@ -50,7 +71,6 @@ public:
     virtual ~Session();
 
     typedef std::shared_ptr<Session> Ptr;
-    static const size_t BUFFER_LENGTH = 1024;
 
     virtual void start() override;
     virtual void disconnect(DisconnectReason _reason) override;
@@ -119,11 +139,10 @@ public:
     }
 
 private:
-    void send(std::shared_ptr<bytes> _msg);
+    void send(SendBuffer const& _buffer);
 
     void doRead();
-    std::vector<byte> m_data;  ///< Buffer for ingress packet data.
-    byte m_recvBuffer[BUFFER_LENGTH];
+    RecvBuffer m_recvBuffer;  ///< Buffer for ingress packet data.
 
     /// Drop the connection for the reason @a _r.
     void drop(DisconnectReason _r);
@@ -135,7 +154,7 @@ private:
 
     /// Perform a single round of the write operation. This could end up calling itself
     /// asynchronously.
-    void onWrite(boost::system::error_code ec, std::size_t length, std::shared_ptr<bytes> buffer);
+    void onWrite(boost::system::error_code ec, std::size_t length, SendBuffer buffer);
     void write();
 
     /// call by doRead() to deal with mesage
@@ -149,14 +168,14 @@ private:
     class QueueCompare
     {
     public:
-        bool operator()(const std::pair<std::shared_ptr<bytes>, u256>&,
-            const std::pair<std::shared_ptr<bytes>, u256>&) const
+        bool operator()(const std::pair<SendBuffer, uint64_t>&,
+            const std::pair<SendBuffer, uint64_t>&) const
         {
             return false;
         }
     };
 
-    boost::heap::priority_queue<std::pair<std::shared_ptr<bytes>, u256>,
+    boost::heap::priority_queue<std::pair<SendBuffer, uint64_t>,
         boost::heap::compare<QueueCompare>, boost::heap::stable<true>>
         m_writeQueue;
     bool m_writing = false;
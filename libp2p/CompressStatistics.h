@@ -0,0 +1,85 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2018 fisco-dev contributors.
+ */
+/**
+ * @brief : the compression counters of the p2p messages
+ * @file: CompressStatistics.h
+ * @date: 2019-06-27
+ */
+
+#pragma once
+#include <libdevcore/Guards.h>
+#include <libethcore/Protocol.h>
+#include <cstdlib>
+#include <map>
+
+namespace dev
+{
+namespace p2p
+{
+/// the counters of the messages of a protocol
+struct CompressCounter
+{
+    uint64_t compressedMessages = 0;
+    /// the payload bytes before and after compressing, the ratio is compressedBytes / rawBytes
+    uint64_t rawBytes = 0;
+    uint64_t compressedBytes = 0;
+    uint64_t compressMicroseconds = 0;
+    uint64_t uncompressedMessages = 0;
+    uint64_t uncompressMicroseconds = 0;
+};
+
+/// Thread-safe counters of the compressed messages by the protocol id, the requests and the
+/// responses of a protocol are counted together
+class CompressStatistics
+{
+public:
+    void onCompress(PROTOCOL_ID _protocolID, size_t _rawBytes, size_t _compressedBytes,
+        uint64_t _microseconds)
+    {
+        Guard l(x_counters);
+        CompressCounter& counter = m_counters[std::abs(_protocolID)];
+        counter.compressedMessages++;
+        counter.rawBytes += _rawBytes;
+        counter.compressedBytes += _compressedBytes;
+        counter.compressMicroseconds += _microseconds;
+    }
+    void onUncompress(PROTOCOL_ID _protocolID, uint64_t _microseconds)
+    {
+        Guard l(x_counters);
+        CompressCounter& counter = m_counters[std::abs(_protocolID)];
+        counter.uncompressedMessages++;
+        counter.uncompressMicroseconds += _microseconds;
+    }
+    std::map<PROTOCOL_ID, CompressCounter> counters() const
+    {
+        Guard l(x_counters);
+        return m_counters;
+    }
+
+    static CompressStatistics& instance()
+    {
+        static CompressStatistics statistics;
+        return statistics;
+    }
+
+private:
+    mutable Mutex x_counters;
+    std::map<PROTOCOL_ID, CompressCounter> m_counters;
+};
+
+}  // namespace p2p
+}  // namespace dev
@@ -21,25 +21,70 @@
 
 #include "P2PMessage.h"
 #include "Common.h"
+#include "CompressStatistics.h"
+#include <snappy.h>
+#include <chrono>
 
 using namespace dev;
 using namespace dev::p2p;
 
+static uint64_t microsecondsSince(std::chrono::steady_clock::time_point _start)
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - _start)
+        .count();
+}
+
 void P2PMessage::encode(bytes& buffer)
+{
+    auto payload = encodeHeader(buffer);
+    buffer.insert(buffer.end(), payload->begin(), payload->end());
+}
+
+std::shared_ptr<bytes> P2PMessage::encodeHeader(bytes& buffer)
 {
     buffer.clear();  ///< It is not allowed to be assembled outside.
-    m_length = HEADER_LENGTH + m_buffer->size();
+    std::shared_ptr<bytes> payload = m_buffer;
+    PACKET_TYPE flags = 0;
+    if (m_compress && m_buffer->size() >= COMPRESS_THRESHOLD && m_buffer->size() <= MAX_LENGTH &&
+        compressedBuffer())
+    {
+        payload = m_compressedBuffer;
+        flags = COMPRESS_FLAG;
+    }
+    m_length = HEADER_LENGTH + payload->size();
 
     uint32_t length = htonl(m_length);
     PROTOCOL_ID protocolID = htons(m_protocolID);
-    PACKET_TYPE packetType = htons(m_packetType);
+    PACKET_TYPE packetType = htons(m_packetType | flags);
     uint32_t seq = htonl(m_seq);
 
     buffer.insert(buffer.end(), (byte*)&length, (byte*)&length + sizeof(length));
     buffer.insert(buffer.end(), (byte*)&protocolID, (byte*)&protocolID + sizeof(protocolID));
     buffer.insert(buffer.end(), (byte*)&packetType, (byte*)&packetType + sizeof(packetType));
     buffer.insert(buffer.end(), (byte*)&seq, (byte*)&seq + sizeof(seq));
-    buffer.insert(buffer.end(), m_buffer->begin(), m_buffer->end());
+    return payload;
+}
+
+std::shared_ptr<bytes> P2PMessage::compressedBuffer()
+{
+    if (m_compressedFrom == m_buffer)
+        return m_compressedBuffer;
+
+    auto start = std::chrono::steady_clock::now();
+    auto compressed = std::make_shared<bytes>(snappy::MaxCompressedLength(m_buffer->size()));
+    size_t compressedLength = 0;
+    snappy::RawCompress((const char*)m_buffer->data(), m_buffer->size(),
+        (char*)compressed->data(), &compressedLength);
+    compressed->resize(compressedLength);
+    CompressStatistics::instance().onCompress(
+        m_protocolID, m_buffer->size(), compressedLength, microsecondsSince(start));
+
+    m_compressedFrom = m_buffer;
+    m_compressedBuffer.reset();
+    if (compressedLength < m_buffer->size())
+        m_compressedBuffer = compressed;
+    return m_compressedBuffer;
 }
 
 ssize_t P2PMessage::decode(const byte* buffer, size_t size)
@@ -68,6 +113,33 @@ ssize_t P2PMessage::decode(const byte* buffer, size_t size)
     m_packetType = ntohs(*((PACKET_TYPE*)&buffer[offset]));
     offset += sizeof(m_packetType);
     m_seq = ntohl(*((uint32_t*)&buffer[offset]));
+    if (m_length < HEADER_LENGTH)
+    {
+        return dev::network::PACKET_ERROR;
+    }
+    if (m_packetType & COMPRESS_FLAG)
+    {
+        m_packetType &= ~COMPRESS_FLAG;
+        auto start = std::chrono::steady_clock::now();
+        const char* compressed = (const char*)&buffer[HEADER_LENGTH];
+        size_t compressedLength = m_length - HEADER_LENGTH;
+        size_t uncompressedLength = 0;
+        /// the length is forged if it's over the limit of the compressed payloads, or the data
+        /// doesn't uncompress to it, check before allocating
+        if (!snappy::GetUncompressedLength(compressed, compressedLength, &uncompressedLength) ||
+            uncompressedLength > MAX_LENGTH ||
+            !snappy::IsValidCompressedBuffer(compressed, compressedLength))
+        {
+            return dev::network::PACKET_ERROR;
+        }
+        m_buffer->resize(uncompressedLength);
+        if (!snappy::RawUncompress(compressed, compressedLength, (char*)m_buffer->data()))
+        {
+            return dev::network::PACKET_ERROR;
+        }
+        CompressStatistics::instance().onUncompress(m_protocolID, microsecondsSince(start));
+        return m_length;
+    }
     ///< TODO: assign to std::move
     m_buffer->assign(&buffer[HEADER_LENGTH], &buffer[HEADER_LENGTH] + m_length - HEADER_LENGTH);
 
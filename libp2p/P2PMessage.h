@@ -37,6 +37,11 @@ public:
 
     const static size_t HEADER_LENGTH = 12;
     const static size_t MAX_LENGTH = 1024 * 1024;  ///< The maximum length of data is 1M.
+    /// the bit of the packet type marking the payload compressed by snappy
+    const static PACKET_TYPE COMPRESS_FLAG = 0x8000;
+    /// the payloads smaller than this are not worth compressing, and the ones larger than
+    /// MAX_LENGTH are sent as is, so no compressed payload uncompresses to more than MAX_LENGTH
+    const static size_t COMPRESS_THRESHOLD = 1024;
 
     P2PMessage() { m_buffer = std::make_shared<bytes>(); }
 
@@ -60,6 +65,10 @@ public:
         m_buffer = _buffer;
     }
 
+    /// compress the payload when encoding if it's large enough, set if the peer supports it
+    virtual bool compress() { return m_compress; }
+    virtual void setCompress(bool _compress) { m_compress = _compress; }
+
     virtual bool isRequestPacket() override { return (m_protocolID > 0); }
     virtual PROTOCOL_ID getResponceProtocolID()
     {
@@ -70,6 +79,7 @@ public:
     }
 
     virtual void encode(bytes& buffer) override;
+    virtual std::shared_ptr<bytes> encodeHeader(bytes& _header) override;
 
     /// < If the decoding is successful, the length of the decoded data is returned; otherwise, 0 is
     /// returned.
@@ -81,19 +91,32 @@ public:
     virtual ssize_t decodeAMOPBuffer(std::shared_ptr<bytes> buffer, std::string& topic);
 
 private:
+    /// the compressed payload, nullptr if it's not smaller, computed once for all the sessions
+    std::shared_ptr<bytes> compressedBuffer();
+
     uint32_t m_length = 0;            ///< m_length = HEADER_LENGTH + length(m_buffer)
     PROTOCOL_ID m_protocolID = 0;     ///< message type, the first two bytes of information, when
                                       ///< greater than 0 is the ID of the request package.
     PACKET_TYPE m_packetType = 0;     ///< message sub type, the second two bytes of information
     uint32_t m_seq = 0;               ///< the message identify
     std::shared_ptr<bytes> m_buffer;  ///< message data
+    bool m_compress = false;
+    std::shared_ptr<bytes> m_compressedFrom;
+    std::shared_ptr<bytes> m_compressedBuffer;
 };
 
 enum AMOPPacketType
 {
     SendTopicSeq = 1,
     RequestTopics = 2,
-    SendTopics = 3
+    SendTopics = 3,
+    SendCapabilities = 4
+};
+
+/// the bits of the capabilities a node sends to the peer once connected
+enum P2PCapability
+{
+    SnappyCompress = 0x01
 };
 
 class P2PMessageFactory : public dev::network::MessageFactory
@@ -37,10 +37,26 @@ void P2PSession::start()
         m_run = true;
 
         m_session->start();
+        sendCapabilities();
         heartBeat();
     }
 }
 
+void P2PSession::sendCapabilities()
+{
+    auto service = m_service.lock();
+    if (!service || !service->enableCompress())
+        return;
+    /// the nodes not knowing the packet type ignore it, and never get compressed payloads
+    auto message =
+        std::dynamic_pointer_cast<P2PMessage>(service->p2pMessageFactory()->buildMessage());
+    message->setProtocolID(dev::eth::ProtocolID::Topic);
+    message->setPacketType(AMOPPacketType::SendCapabilities);
+    message->setBuffer(std::make_shared<bytes>(1, P2PCapability::SnappyCompress));
+    message->setLength(P2PMessage::HEADER_LENGTH + message->buffer()->size());
+    m_session->asyncSendMessage(message);
+}
+
 void P2PSession::stop(dev::network::DisconnectReason reason)
 {
     if (m_run)
@@ -215,6 +231,15 @@ void P2PSession::onTopicMessage(P2PMessage::Ptr message)
 
                 break;
             }
+            case AMOPPacketType::SendCapabilities:
+            {
+                auto buffer = message->buffer();
+                m_peerCompress = !buffer->empty() && ((*buffer)[0] & P2PCapability::SnappyCompress);
+                SESSION_LOG(DEBUG) << LOG_DESC("Receive peer capabilities")
+                                   << LOG_KV("nodeID", m_nodeID.abridged())
+                                   << LOG_KV("compress", m_peerCompress);
+                break;
+            }
             default:
             {
                 SESSION_LOG(ERROR) << LOG_DESC("Unknown topic packet type")
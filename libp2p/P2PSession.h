@@ -24,6 +24,7 @@
 #include <libnetwork/Common.h>
 #include <libnetwork/SessionFace.h>
 #include <libp2p/Common.h>
+#include <atomic>
 #include <memory>
 
 namespace dev
@@ -67,6 +68,9 @@ public:
 
     virtual void onTopicMessage(std::shared_ptr<P2PMessage> message);
 
+    /// the peer can uncompress the payloads, learnt from its capabilities
+    virtual bool peerCompress() { return m_peerCompress; }
+
     virtual void setTopics(uint32_t seq, std::shared_ptr<std::set<std::string> > topics)
     {
         std::lock_guard<std::mutex> lock(x_topic);
@@ -75,6 +79,9 @@ public:
     }
 
 private:
+    /// tell the peer the capabilities enabled, e.g. the compression
+    void sendCapabilities();
+
     dev::network::SessionFace::Ptr m_session;
     NodeID m_nodeID;
 
@@ -84,6 +91,7 @@ private:
     std::weak_ptr<Service> m_service;
     std::shared_ptr<boost::asio::deadline_timer> m_timer;
     bool m_run = false;
+    std::atomic<bool> m_peerCompress = {false};
 
     const uint32_t HEARTBEAT_INTERVEL = 5000;
 };
@@ -21,6 +21,7 @@
 
 #include "Service.h"
 #include "Common.h"
+#include "CompressStatistics.h"
 #include "P2PMessage.h"
 #include <libdevcore/Common.h>
 #include <libdevcore/CommonJS.h>
@@ -135,6 +136,24 @@ void Service::heartBeat()
         SERVICE_LOG(INFO) << LOG_DESC("heartBeat connected count")
                           << LOG_KV("size", m_sessions.size());
     }
+    for (auto const& it : CompressStatistics::instance().counters())
+    {
+        CompressCounter const& counter = it.second;
+        SERVICE_LOG(INFO) << LOG_DESC("heartBeat compress") << LOG_KV("protocolID", it.first)
+                          << LOG_KV("compressed", counter.compressedMessages)
+                          << LOG_KV("rawBytes", counter.rawBytes)
+                          << LOG_KV("compressedBytes", counter.compressedBytes)
+                          << LOG_KV("compressUs", counter.compressMicroseconds)
+                          << LOG_KV("uncompressed", counter.uncompressedMessages)
+                          << LOG_KV("uncompressUs", counter.uncompressMicroseconds);
+    }
+    auto ioThreadsLoad = this->ioThreadsLoad();
+    for (size_t i = 0; i < ioThreadsLoad.size(); ++i)
+    {
+        SERVICE_LOG(INFO) << LOG_DESC("heartBeat io thread load") << LOG_KV("thread", i)
+                          << LOG_KV("connections", ioThreadsLoad[i].first)
+                          << LOG_KV("handled", ioThreadsLoad[i].second);
+    }
 
     auto self = std::weak_ptr<Service>(shared_from_this());
     m_timer = m_host->asioInterface()->newTimer(CHECK_INTERVEL);
@@ -390,6 +409,7 @@ void Service::asyncSendMessageByNodeID(NodeID nodeID, P2PMessage::Ptr message,
                 message->setSeq(m_p2pMessageFactory->newSeq());
             }
             auto session = it->second;
+            message->setCompress(m_enableCompress && session->peerCompress());
             if (callback)
             {
                 session->session()->asyncSendMessage(message, options,
@@ -763,3 +783,25 @@ bool Service::isConnected(NodeID const& nodeID) const
     }
     return false;
 }
+
+std::vector<std::pair<size_t, uint64_t>> Service::ioThreadsLoad() const
+{
+    std::vector<std::pair<size_t, uint64_t>> load;
+    auto pool = m_host->asioInterface()->ioServicePool();
+    if (!pool)
+        return load;
+    for (auto handled : pool->handledTasks())
+        load.push_back(std::make_pair(0, handled));
+
+    RecursiveGuard l(x_sessions);
+    for (auto const& it : m_sessions)
+    {
+        auto session = it.second->session();
+        if (!session || !session->socket())
+            continue;
+        size_t index = pool->indexOf(session->socket()->ref().get_io_service());
+        if (index < load.size())
+            load[index].first++;
+    }
+    return load;
+}
@@ -95,6 +95,9 @@ public:
 
     bool isConnected(NodeID const& nodeID) const override;
 
+    /// the connections and the handlers run of each io thread, empty without the io thread pool
+    std::vector<std::pair<size_t, uint64_t>> ioThreadsLoad() const;
+
     virtual h512s getNodeListByGroupID(GROUP_ID groupID) override
     {
         return m_groupID2NodeList[groupID];
@@ -138,6 +141,10 @@ public:
         m_p2pMessageFactory = _p2pMessageFactory;
     }
 
+    /// compress the large payloads sent to the peers enabling it too
+    virtual bool enableCompress() const { return m_enableCompress; }
+    virtual void setEnableCompress(bool _enableCompress) { m_enableCompress = _enableCompress; }
+
     virtual KeyPair keyPair() { return m_alias; }
     virtual void setKeyPair(KeyPair keyPair) { m_alias = keyPair; }
     void updateStaticNodes(
@@ -179,6 +186,7 @@ private:
     std::shared_ptr<boost::asio::deadline_timer> m_timer;
 
     bool m_run = false;
+    bool m_enableCompress = false;
 };
 
 }  // namespace p2p
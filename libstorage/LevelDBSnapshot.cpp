@@ -0,0 +1,212 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2018 fisco-dev contributors.
+ */
+/** @file LevelDBSnapshot.cpp
+ *  @date 20190610
+ */
+
+#include "LevelDBSnapshot.h"
+#include "Common.h"
+#include "StorageException.h"
+#include <libdevcore/RLP.h>
+#include <libdevcore/easylog.h>
+#include <libdevcrypto/Hash.h>
+#include <json/json.h>
+#include <sstream>
+
+using namespace dev;
+using namespace dev::storage;
+
+namespace
+{
+bytes encodePairs(std::vector<std::pair<std::string, std::string>> const& _pairs)
+{
+    RLPStream s;
+    s.appendList(_pairs.size());
+    for (auto const& pair : _pairs)
+    {
+        s.appendList(2) << pair.first << pair.second;
+    }
+    return s.out();
+}
+
+/// the blocks are kept with an empty signature list, which differs between the sealers, so that
+/// every node cuts the same chunks from the same state
+std::string normalizeValue(std::string const& _key, std::string const& _value)
+{
+    static std::string const c_blockPrefix = std::string(SYS_HASH_2_BLOCK) + "_";
+    if (_key.compare(0, c_blockPrefix.size(), c_blockPrefix) != 0)
+    {
+        return _value;
+    }
+    try
+    {
+        std::stringstream ssIn;
+        ssIn << _value;
+        Json::Value entry;
+        ssIn >> entry;
+        for (auto& value : entry["values"])
+        {
+            bytes blockData = fromHex(value[SYS_VALUE].asString());
+            RLP block(blockData);
+            if (!block.isList() || block.itemCount() != 5)
+            {
+                return _value;
+            }
+            RLPStream s;
+            s.appendList(5);
+            for (size_t i = 0; i < 4; ++i)
+            {
+                s.appendRaw(block[i].data());
+            }
+            s.appendList(0);
+            value[SYS_VALUE] = toHexPrefixed(s.out());
+        }
+        std::stringstream ssOut;
+        ssOut << entry;
+        return ssOut.str();
+    }
+    catch (std::exception const&)
+    {
+        return _value;
+    }
+}
+}  // namespace
+
+LevelDBSnapshot::LevelDBSnapshot(
+    std::shared_ptr<dev::db::BasicLevelDB> _db, int64_t _number, h256 const& _blockHash)
+  : m_db(_db), m_snapshot(_db->GetSnapshot()), m_number(_number), m_blockHash(_blockHash)
+{}
+
+LevelDBSnapshot::~LevelDBSnapshot()
+{
+    m_db->ReleaseSnapshot(m_snapshot);
+}
+
+std::vector<h256> LevelDBSnapshot::chunkHashes()
+{
+    Guard l(x_chunks);
+    if (!m_chunksCut)
+    {
+        cutChunks();
+        m_chunksCut = true;
+    }
+    return m_chunkHashes;
+}
+
+h256 LevelDBSnapshot::root()
+{
+    chunkHashes();
+    Guard l(x_chunks);
+    return m_root;
+}
+
+bytes LevelDBSnapshot::chunk(size_t _index)
+{
+    std::string beginKey;
+    std::string endKey;
+    {
+        Guard l(x_chunks);
+        if (!m_chunksCut || _index >= m_chunkBeginKeys.size())
+        {
+            return bytes();
+        }
+        beginKey = m_chunkBeginKeys[_index];
+        if (_index + 1 < m_chunkBeginKeys.size())
+        {
+            endKey = m_chunkBeginKeys[_index + 1];
+        }
+    }
+    return encodeChunk(beginKey, endKey);
+}
+
+/// the values are read by Get instead of the iterator, which returns the encrypted values of the
+/// encrypted leveldb
+void LevelDBSnapshot::cutChunks()
+{
+    leveldb::ReadOptions options;
+    options.snapshot = m_snapshot;
+    options.fill_cache = false;
+    std::unique_ptr<leveldb::Iterator> it(m_db->NewIterator(options));
+    if (!it)
+    {
+        BOOST_THROW_EXCEPTION(StorageException(-1, "Cut snapshot failed: leveldb not opened"));
+    }
+    std::vector<std::pair<std::string, std::string>> pairs;
+    size_t chunkSize = 0;
+    auto finishChunk = [&]() {
+        m_chunkBeginKeys.push_back(pairs.front().first);
+        m_chunkHashes.push_back(sha3(encodePairs(pairs)));
+        pairs.clear();
+        chunkSize = 0;
+    };
+    for (it->SeekToFirst(); it->Valid(); it->Next())
+    {
+        std::string key = it->key().ToString();
+        std::string value;
+        auto s = m_db->Get(options, leveldb::Slice(key), &value);
+        if (!s.ok())
+        {
+            BOOST_THROW_EXCEPTION(StorageException(-1, "Cut snapshot failed:" + s.ToString()));
+        }
+        value = normalizeValue(key, value);
+        chunkSize += key.size() + value.size();
+        pairs.emplace_back(std::move(key), std::move(value));
+        if (chunkSize >= c_snapshotChunkSize)
+        {
+            finishChunk();
+        }
+    }
+    if (!pairs.empty())
+    {
+        finishChunk();
+    }
+    RLPStream s;
+    s << m_chunkHashes;
+    m_root = sha3(s.out());
+    STORAGE_LEVELDB_LOG(INFO) << LOG_DESC("Cut snapshot into chunks")
+                              << LOG_KV("number", m_number)
+                              << LOG_KV("chunks", m_chunkHashes.size());
+}
+
+bytes LevelDBSnapshot::encodeChunk(std::string const& _beginKey, std::string const& _endKey)
+{
+    leveldb::ReadOptions options;
+    options.snapshot = m_snapshot;
+    options.fill_cache = false;
+    std::unique_ptr<leveldb::Iterator> it(m_db->NewIterator(options));
+    if (!it)
+    {
+        return bytes();
+    }
+    std::vector<std::pair<std::string, std::string>> pairs;
+    for (it->Seek(leveldb::Slice(_beginKey)); it->Valid(); it->Next())
+    {
+        std::string key = it->key().ToString();
+        if (!_endKey.empty() && key >= _endKey)
+        {
+            break;
+        }
+        std::string value;
+        if (!m_db->Get(options, leveldb::Slice(key), &value).ok())
+        {
+            return bytes();
+        }
+        value = normalizeValue(key, value);
+        pairs.emplace_back(std::move(key), std::move(value));
+    }
+    return encodePairs(pairs);
+}
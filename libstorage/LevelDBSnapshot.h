@@ -0,0 +1,78 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2018 fisco-dev contributors.
+ */
+/** @file LevelDBSnapshot.h
+ *  @brief consistent view of all the tables in leveldb at a checkpoint block, cut into chunks
+ *         to be downloaded by the new nodes
+ *  @date 20190610
+ */
+#pragma once
+
+#include <leveldb/db.h>
+#include <libdevcore/BasicLevelDB.h>
+#include <libdevcore/FixedHash.h>
+#include <libdevcore/Guards.h>
+
+namespace dev
+{
+namespace storage
+{
+/// bytes of the key-value pairs in a chunk, one value may exceed it
+static size_t const c_snapshotChunkSize = 256 * 1024;
+/// the older snapshot is kept for the nodes still downloading it
+static size_t const c_keptSnapshots = 2;
+
+class LevelDBSnapshot
+{
+public:
+    typedef std::shared_ptr<LevelDBSnapshot> Ptr;
+
+    /// must be created right after the block is written, before the next one
+    LevelDBSnapshot(
+        std::shared_ptr<dev::db::BasicLevelDB> _db, int64_t _number, h256 const& _blockHash);
+    ~LevelDBSnapshot();
+
+    int64_t number() const { return m_number; }
+    h256 const& blockHash() const { return m_blockHash; }
+
+    /// the hashes of the chunks, the snapshot is cut into chunks the first time it's called, the
+    /// stored blocks are cut without their signature lists so that all the nodes agree on them
+    std::vector<h256> chunkHashes();
+    /// sha3 of the RLP list of the chunk hashes
+    h256 root();
+    /// RLP list of the [key, value] pairs of the chunk, empty if the index is out of range
+    bytes chunk(size_t _index);
+
+private:
+    void cutChunks();
+    /// encode the pairs from the begin key (included) to the end key (excluded, empty means
+    /// the last key)
+    bytes encodeChunk(std::string const& _beginKey, std::string const& _endKey);
+
+    std::shared_ptr<dev::db::BasicLevelDB> m_db;
+    const leveldb::Snapshot* m_snapshot;
+    int64_t m_number;
+    h256 m_blockHash;
+
+    Mutex x_chunks;
+    bool m_chunksCut = false;
+    std::vector<std::string> m_chunkBeginKeys;
+    std::vector<h256> m_chunkHashes;
+    h256 m_root;
+};
+
+}  // namespace storage
+}  // namespace dev
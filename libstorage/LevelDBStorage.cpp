@@ -20,15 +20,20 @@
  */
 
 #include "LevelDBStorage.h"
+#include "Common.h"
 #include "Table.h"
 #include <leveldb/db.h>
 #include <leveldb/write_batch.h>
+#include <libdevcore/RLP.h>
 #include <libdevcore/easylog.h>
 #include <memory>
 
 using namespace dev;
 using namespace dev::storage;
 
+/// written with the first snapshot chunk and removed when the import is confirmed
+static std::string const c_snapshotImportKey = "_snapshot_import_";
+
 Entries::Ptr LevelDBStorage::select(h256, int, const std::string& table, const std::string& key)
 {
     try
@@ -91,6 +96,11 @@ size_t LevelDBStorage::commit(
 {
     try
     {
+        if (m_snapshotImporting)
+        {
+            BOOST_THROW_EXCEPTION(
+                StorageException(-1, "Commit leveldb refused: snapshot import in progress"));
+        }
         std::shared_ptr<dev::db::LevelDBWriteBatch> batch = m_db->createWriteBatch();
         size_t total = 0;
         for (auto& it : datas)
@@ -139,6 +149,17 @@ size_t LevelDBStorage::commit(
 
             BOOST_THROW_EXCEPTION(StorageException(-1, "Commit leveldb exception:" + s.ToString()));
         }
+        /// the snapshot is taken before the next block is committed
+        if (m_snapshotInterval > 0 && num > 0 && num % m_snapshotInterval == 0)
+        {
+            auto snapshot = std::make_shared<LevelDBSnapshot>(m_db, num, hash);
+            WriteGuard sl(x_snapshot);
+            m_snapshots.push_back(snapshot);
+            if (m_snapshots.size() > c_keptSnapshots)
+            {
+                m_snapshots.pop_front();
+            }
+        }
 
         return total;
     }
@@ -160,4 +181,105 @@ bool LevelDBStorage::onlyDirty()
 void LevelDBStorage::setDB(std::shared_ptr<dev::db::BasicLevelDB> db)
 {
     m_db = db;
+    std::string value;
+    m_snapshotImporting =
+        m_db->Get(leveldb::ReadOptions(), leveldb::Slice(c_snapshotImportKey), &value).ok();
+    if (m_snapshotImporting)
+    {
+        STORAGE_LEVELDB_LOG(WARNING)
+            << LOG_DESC("The snapshot import is not finished, no block is committed until then");
+    }
+}
+
+LevelDBSnapshot::Ptr LevelDBStorage::snapshot(int64_t _number) const
+{
+    ReadGuard l(x_snapshot);
+    if (m_snapshots.empty())
+    {
+        return nullptr;
+    }
+    if (_number < 0)
+    {
+        return m_snapshots.back();
+    }
+    for (auto const& snapshot : m_snapshots)
+    {
+        if (snapshot->number() == _number)
+        {
+            return snapshot;
+        }
+    }
+    return nullptr;
+}
+
+void LevelDBStorage::importSnapshotChunk(bytesConstRef _chunk)
+{
+    std::string currentStatePrefix = std::string(SYS_CURRENT_STATE) + "_";
+    std::shared_ptr<dev::db::LevelDBWriteBatch> batch = m_db->createWriteBatch();
+    RLP pairs(_chunk);
+    for (auto const& pair : pairs)
+    {
+        auto key = pair[0].toString();
+        auto value = pair[1].toString();
+        if (key.compare(0, currentStatePrefix.size(), currentStatePrefix) == 0)
+        {
+            Guard l(x_deferredPairs);
+            m_deferredPairs.emplace_back(std::move(key), std::move(value));
+            continue;
+        }
+        batch->insertSlice(leveldb::Slice(key), leveldb::Slice(value));
+    }
+    /// the marker is written with the pairs, no chunk is in the db without it
+    batch->insertSlice(leveldb::Slice(c_snapshotImportKey), leveldb::Slice("1"));
+    WriteGuard l(m_remoteDBMutex);
+    auto s = m_db->Write(leveldb::WriteOptions(), &(batch->writeBatch()));
+    if (!s.ok())
+    {
+        BOOST_THROW_EXCEPTION(StorageException(-1, "Import snapshot exception:" + s.ToString()));
+    }
+    m_snapshotImporting = true;
+}
+
+void LevelDBStorage::finishSnapshotImport()
+{
+    std::shared_ptr<dev::db::LevelDBWriteBatch> batch = m_db->createWriteBatch();
+    {
+        Guard l(x_deferredPairs);
+        for (auto const& pair : m_deferredPairs)
+        {
+            batch->insertSlice(leveldb::Slice(pair.first), leveldb::Slice(pair.second));
+        }
+        m_deferredPairs.clear();
+    }
+    leveldb::WriteOptions writeOptions;
+    writeOptions.sync = true;
+    WriteGuard l(m_remoteDBMutex);
+    auto s = m_db->Write(writeOptions, &(batch->writeBatch()));
+    if (!s.ok())
+    {
+        BOOST_THROW_EXCEPTION(StorageException(-1, "Import snapshot exception:" + s.ToString()));
+    }
+    STORAGE_LEVELDB_LOG(INFO) << LOG_DESC("Snapshot imported");
+}
+
+void LevelDBStorage::confirmSnapshotImport()
+{
+    leveldb::WriteOptions writeOptions;
+    writeOptions.sync = true;
+    WriteGuard l(m_remoteDBMutex);
+    auto s = m_db->Delete(writeOptions, leveldb::Slice(c_snapshotImportKey));
+    if (!s.ok())
+    {
+        BOOST_THROW_EXCEPTION(StorageException(-1, "Import snapshot exception:" + s.ToString()));
+    }
+    m_snapshotImporting = false;
+    STORAGE_LEVELDB_LOG(INFO) << LOG_DESC("Snapshot import confirmed");
+}
+
+void LevelDBStorage::discardSnapshotImport()
+{
+    Guard l(x_deferredPairs);
+    STORAGE_LEVELDB_LOG(INFO) << LOG_DESC("Discard snapshot import")
+                              << LOG_KV("deferredPairs", m_deferredPairs.size());
+    m_deferredPairs.clear();
 }
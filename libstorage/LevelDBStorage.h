@@ -20,6 +20,7 @@
  */
 #pragma once
 
+#include "LevelDBSnapshot.h"
 #include "Storage.h"
 #include "StorageException.h"
 #include "Table.h"
@@ -28,6 +29,8 @@
 #include <libdevcore/BasicLevelDB.h>
 #include <libdevcore/FixedHash.h>
 #include <libdevcore/Guards.h>
+#include <atomic>
+#include <deque>
 
 namespace dev
 {
@@ -48,9 +51,34 @@ public:
 
     void setDB(std::shared_ptr<dev::db::BasicLevelDB> db);
 
+    /// take a snapshot after committing every given number of blocks, 0 means never
+    void setSnapshotInterval(int64_t _interval) { m_snapshotInterval = _interval; }
+    /// the snapshot of the given checkpoint, the latest one if the number is negative, null if
+    /// it's not kept
+    LevelDBSnapshot::Ptr snapshot(int64_t _number = -1) const;
+    /// write the [key, value] pairs of a verified snapshot chunk, the current number is written
+    /// by finishSnapshotImport after all the chunks in case of being read before
+    void importSnapshotChunk(bytesConstRef _chunk);
+    void finishSnapshotImport();
+    /// drop the current state pairs of the chunks imported, when the import starts over
+    void discardSnapshotImport();
+    /// the imported snapshot is checked against the trusted manifest, blocks can be committed
+    void confirmSnapshotImport();
+    /// chunks have been written but the import is not confirmed, even before a restart, the
+    /// blocks are refused until a snapshot is imported since the state is incomplete
+    bool snapshotImporting() const { return m_snapshotImporting; }
+
 private:
     std::shared_ptr<dev::db::BasicLevelDB> m_db;
     dev::SharedMutex m_remoteDBMutex;
+
+    int64_t m_snapshotInterval = 0;
+    mutable dev::SharedMutex x_snapshot;
+    std::deque<LevelDBSnapshot::Ptr> m_snapshots;
+    /// the pairs of the current state table waiting for all the chunks imported
+    Mutex x_deferredPairs;
+    std::vector<std::pair<std::string, std::string>> m_deferredPairs;
+    std::atomic<bool> m_snapshotImporting = {false};
 };
 
 }  // namespace storage
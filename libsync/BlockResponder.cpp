@@ -0,0 +1,197 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2018 fisco-dev contributors.
+ */
+/**
+ * @brief : serve the headers and blocks requested by the peers
+ * @file: BlockResponder.cpp
+ * @date: 2019-06-20
+ */
+
+#include "BlockResponder.h"
+#include "SyncMsgEngine.h"
+#include "SyncMsgPacket.h"
+
+using namespace std;
+using namespace dev;
+using namespace dev::eth;
+using namespace dev::sync;
+using namespace dev::p2p;
+
+static size_t const c_maxPayload = dev::p2p::P2PMessage::MAX_LENGTH - 2048;
+
+BlockResponder::BlockResponder(std::shared_ptr<dev::p2p::P2PInterface> _service,
+    std::shared_ptr<dev::blockchain::BlockChainInterface> _blockChain,
+    std::shared_ptr<SyncMasterStatus> _syncStatus, PROTOCOL_ID const& _protocolId,
+    NodeID const& _nodeId)
+  : m_service(_service),
+    m_blockChain(_blockChain),
+    m_syncStatus(_syncStatus),
+    m_protocolId(_protocolId),
+    m_nodeId(_nodeId)
+{
+    m_groupId = dev::eth::getGroupAndProtocol(m_protocolId).first;
+    m_respondPool = std::make_shared<dev::ThreadPool>(
+        "SyncRespond-" + std::to_string(m_groupId), c_syncRespondThreadNum);
+}
+
+void BlockResponder::respond(std::shared_ptr<SyncPeerStatus> _peer)
+{
+    if (_peer->reqQueue.empty() && _peer->headersReqQueue.empty())
+        return;
+    if (_peer->respondBandwidth.exceeded(utcTime()))
+        return;
+    bool responding = false;
+    if (!_peer->responding.compare_exchange_strong(responding, true))
+        return;
+    m_respondPool->enqueue([this, _peer]() { serve(_peer); });
+}
+
+void BlockResponder::maintain()
+{
+    m_syncStatus->foreachPeer([&](std::shared_ptr<SyncPeerStatus> _p) {
+        respond(_p);
+        return true;
+    });
+}
+
+void BlockResponder::serve(std::shared_ptr<SyncPeerStatus> _peer)
+{
+    uint64_t timeout = utcTime() + c_respondDownloadRequestTimeout;
+    respondHeaders(_peer);
+    if (respondBlocks(_peer, timeout))
+    {
+        _peer->responding = false;
+        return;
+    }
+    if (_peer->respondBandwidth.exceeded(utcTime()))
+    {
+        // served again by maintain in the next second
+        m_throttledTimes++;
+        SYNC_LOG(DEBUG) << LOG_BADGE("Download") << LOG_BADGE("Request")
+                        << LOG_DESC("Stop responding for peer bandwidth")
+                        << LOG_KV("peer", _peer->nodeId.abridged());
+        _peer->responding = false;
+        return;
+    }
+    // the rest requests are served after the other peers waiting
+    m_respondPool->enqueue([this, _peer]() { serve(_peer); });
+}
+
+void BlockResponder::respondHeaders(std::shared_ptr<SyncPeerStatus> _p)
+{
+    DownloadRequestQueue& reqQueue = _p->headersReqQueue;
+    if (reqQueue.empty())
+        return;
+
+    reqQueue.disablePush();
+    DownloadRequest req = reqQueue.topAndPop();
+    while (!reqQueue.empty())
+        reqQueue.topAndPop();  // the peer requests the headers one range at a time
+    reqQueue.enablePush();
+
+    // headers are small, send them in one packet, the header and the signature list are
+    // cut from the stored block bytes
+    std::vector<bytes> blockRLPs =
+        m_blockChain->getBlockRLPsByNumber(req.fromNumber, min(req.size, c_maxRequestHeaders));
+    std::vector<bytes> headerRLPs;
+    size_t packetSize = 0;
+    for (auto const& blockRLP : blockRLPs)
+    {
+        RLP block(blockRLP);
+        RLPStream s;
+        s.appendList(2).appendRaw(block[0].data()).appendRaw(block[4].data());
+        if (packetSize + s.out().size() > c_maxPayload)
+            break;
+        packetSize += s.out().size();
+        headerRLPs.push_back(s.out());
+    }
+    if (headerRLPs.empty())
+        return;
+
+    SyncHeadersPacket packet;
+    packet.encode(headerRLPs);
+    m_service->asyncSendMessageByNodeID(
+        _p->nodeId, packet.toMessage(m_protocolId), CallbackFuncWithSession(), Options());
+    m_respondedRequests++;
+    SYNC_LOG(DEBUG) << LOG_BADGE("Download") << LOG_BADGE("Request") << LOG_DESC("Send headers")
+                    << LOG_KV("from", req.fromNumber)
+                    << LOG_KV("to", req.fromNumber + headerRLPs.size() - 1)
+                    << LOG_KV("peer", _p->nodeId.abridged());
+}
+
+bool BlockResponder::respondBlocks(std::shared_ptr<SyncPeerStatus> _p, uint64_t _timeout)
+{
+    DownloadRequestQueue& reqQueue = _p->reqQueue;
+    DownloadBlocksContainer blockContainer(m_service, m_protocolId, _p->nodeId);
+    while (!reqQueue.empty())
+    {
+        if (utcTime() > _timeout || _p->respondBandwidth.exceeded(utcTime()))
+            return false;
+
+        reqQueue.disablePush();  // drop push at this time
+        DownloadRequest req = reqQueue.topAndPop();
+        reqQueue.enablePush();
+        int64_t number = req.fromNumber;
+        int64_t numberLimit = req.fromNumber + req.size;
+
+        // Send the stored block bytes at sequence, without decoding them
+        while (number < numberLimit && utcTime() <= _timeout &&
+               !_p->respondBandwidth.exceeded(utcTime()))
+        {
+            int64_t size = min(numberLimit - number, c_maxRequestBlocks);
+            std::vector<bytes> blockRLPs = m_blockChain->getBlockRLPsByNumber(number, size);
+            size_t blocksBytes = 0;
+            for (auto& blockRLP : blockRLPs)
+            {
+                blocksBytes += blockRLP.size();
+                blockContainer.batchAndSend(std::move(blockRLP));
+            }
+            _p->respondBandwidth.add(blocksBytes, utcTime());
+            m_respondedBlocks += blockRLPs.size();
+            m_respondedBytes += blocksBytes;
+            number += blockRLPs.size();
+            if ((int64_t)blockRLPs.size() < size)
+            {
+                // the peer will request the blocks this node doesn't have from others
+                SYNC_LOG(TRACE) << LOG_BADGE("Download") << LOG_BADGE("Request")
+                                << LOG_DESC("Get block for node failed")
+                                << LOG_KV("reason", "block is null") << LOG_KV("number", number)
+                                << LOG_KV("nodeId", _p->nodeId.abridged());
+                numberLimit = number;
+                break;
+            }
+        }
+
+        if (req.fromNumber < number)
+            SYNC_LOG(DEBUG) << LOG_BADGE("Download") << LOG_BADGE("Request")
+                            << LOG_BADGE("BlockSync") << LOG_DESC("Send blocks")
+                            << LOG_KV("from", req.fromNumber) << LOG_KV("to", number - 1)
+                            << LOG_KV("peer", _p->nodeId.abridged());
+
+        if (number < numberLimit)  // This respond not reach the end due to timeout
+        {
+            // write back the rest request range
+            SYNC_LOG(DEBUG) << LOG_BADGE("Download") << LOG_BADGE("Request")
+                            << LOG_DESC("Push unsent requests back to reqQueue")
+                            << LOG_KV("from", number) << LOG_KV("to", numberLimit - 1)
+                            << LOG_KV("peer", _p->nodeId.abridged());
+            reqQueue.push(number, numberLimit - number);
+            return false;
+        }
+        m_respondedRequests++;
+    }
+    return true;
+}
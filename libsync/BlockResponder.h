@@ -0,0 +1,81 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2018 fisco-dev contributors.
+ */
+/**
+ * @brief : serve the headers and blocks requested by the peers
+ * @file: BlockResponder.h
+ * @date: 2019-06-20
+ */
+
+#pragma once
+#include "Common.h"
+#include "SyncStatus.h"
+#include <libblockchain/BlockChainInterface.h>
+#include <libdevcore/ThreadPool.h>
+#include <libp2p/P2PInterface.h>
+#include <atomic>
+
+namespace dev
+{
+namespace sync
+{
+/// The requests are served on a pool instead of the sync thread, a peer is served by one task
+/// at a time for at most c_respondDownloadRequestTimeout, then queued behind the other peers
+class BlockResponder
+{
+public:
+    typedef std::shared_ptr<BlockResponder> Ptr;
+
+    BlockResponder(std::shared_ptr<dev::p2p::P2PInterface> _service,
+        std::shared_ptr<dev::blockchain::BlockChainInterface> _blockChain,
+        std::shared_ptr<SyncMasterStatus> _syncStatus, PROTOCOL_ID const& _protocolId,
+        NodeID const& _nodeId);
+
+    /// serve the requests of the peer if it's not being served or over its bandwidth
+    void respond(std::shared_ptr<SyncPeerStatus> _peer);
+    /// serve the peers with requests left, e.g. the ones over the bandwidth last second
+    void maintain();
+
+    uint64_t respondedRequests() const { return m_respondedRequests; }
+    uint64_t respondedBlocks() const { return m_respondedBlocks; }
+    uint64_t respondedBytes() const { return m_respondedBytes; }
+    /// times a peer is stopped serving for its bandwidth
+    uint64_t throttledTimes() const { return m_throttledTimes; }
+
+private:
+    void serve(std::shared_ptr<SyncPeerStatus> _peer);
+    void respondHeaders(std::shared_ptr<SyncPeerStatus> _peer);
+    /// @returns false if the blocks are not all sent in time
+    bool respondBlocks(std::shared_ptr<SyncPeerStatus> _peer, uint64_t _timeout);
+
+    std::shared_ptr<dev::p2p::P2PInterface> m_service;
+    std::shared_ptr<dev::blockchain::BlockChainInterface> m_blockChain;
+    std::shared_ptr<SyncMasterStatus> m_syncStatus;
+    PROTOCOL_ID m_protocolId;
+    GROUP_ID m_groupId;
+    NodeID m_nodeId;
+
+    std::atomic<uint64_t> m_respondedRequests = {0};
+    std::atomic<uint64_t> m_respondedBlocks = {0};
+    std::atomic<uint64_t> m_respondedBytes = {0};
+    std::atomic<uint64_t> m_throttledTimes = {0};
+
+    /// destroyed first to join the tasks using the members above
+    dev::ThreadPool::Ptr m_respondPool;
+};
+
+}  // namespace sync
+}  // namespace dev
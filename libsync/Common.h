@@ -42,24 +42,65 @@ namespace dev
 namespace sync
 {
 DEV_SIMPLE_EXCEPTION(SyncVerifyHandlerNotSet);
-// Every c_downloadingRequestTimeout request:
-// c_maxRequestBlocks(each peer) * c_maxRequestShards(peer num) = blocks
+// the initial number of blocks requested from a peer, adapted to its throughput later
 static int64_t const c_maxRequestBlocks = 32;
-static size_t const c_maxRequestShards = 4;
-static uint64_t const c_downloadingRequestTimeout =
-    c_maxRequestBlocks * 1000;  // ms: assume that we have 1s timeout for each block
+// a peer is requested for the blocks it's measured to send in c_bodyRequestTargetTime
+static uint64_t const c_bodyRequestTargetTime = 1000;  // ms
+static int64_t const c_maxBodyRequestWindow = 1024;
+static uint64_t const c_minBodyRequestTimeout = 5000;  // ms
+// bytes of the blocks requested but not imported yet
+static uint64_t const c_downloadingMemoryBudget = 256 * 1024 * 1024;
+
+// headers requested in one ReqHeadersPacket
+static int64_t const c_maxRequestHeaders = 256;
+// verified headers kept ahead of the highest block
+static int64_t const c_maxHeadersAhead = 8192;
+static uint64_t const c_headersRequestTimeout = 5000;  // ms
 
 static size_t const c_maxDownloadingBlockQueueSize =
     c_maxRequestBlocks * 128;  // maybe less than 128 is ok
-static size_t const c_maxDownloadingBlockQueueBufferSize = c_maxRequestShards * 8;
+// block packets received between two flushes, each one is at most 1MB
+static size_t const c_maxDownloadingBlockQueueBufferSize = 256;
 
 static size_t const c_maxReceivedDownloadRequestPerPeer = 8;
+// a peer is served for at most this time before the other peers waiting
 static uint64_t const c_respondDownloadRequestTimeout = 200;  // ms
+// threads serving the headers and blocks requested by the peers
+static size_t const c_syncRespondThreadNum = 2;
+// bytes of blocks sent to a peer per second
+static uint64_t const c_maxRespondBytesPerPeer = 16 * 1024 * 1024;
 
 static unsigned const c_syncPacketIDBase = 1;
 
 static uint64_t const c_maintainBlocksTimeout = 5000;  // ms
 
+// threads decoding the downloaded blocks and checking their consensus signatures
+static size_t const c_syncVerifyThreadNum = 4;
+// consecutive downloaded blocks verified ahead of execution
+static size_t const c_maxVerifyingBlocks = 32;
+
+// transaction hashes announced in one TxsHashesPacket
+static size_t const c_maxAnnounceTransactions = 1000;
+// a transaction requested from a peer will not be requested again before timeout
+static uint64_t const c_reqTransactionsTimeout = 1000;  // ms
+static size_t const c_maxRequestedTransactions = 102400;
+// the transactions announced to a peer are announced again if the peer disconnects within this
+// time, the announcement may be lost in the dropped session
+static uint64_t const c_announceTransactionsLostTime = 5000;  // ms
+
+// the number in a ReqSnapshotManifestPacket asking for the latest snapshot, the checkpoints
+// start from block 1
+static int64_t const c_latestSnapshotNumber = 0;
+// chunk hashes in one SnapshotManifestPacket
+static size_t const c_maxManifestChunkHashes = 8192;
+// snapshot chunks requested from a peer at the same time
+static size_t const c_maxSnapshotRequestsPerPeer = 4;
+static uint64_t const c_snapshotRequestTimeout = 10000;  // ms
+// give up the snapshot sync if no manifest or chunk is received for so long
+static uint64_t const c_snapshotStallTimeout = 60000;  // ms
+// threads reading the snapshot chunks requested by the peers
+static size_t const c_snapshotServeThreadNum = 2;
+
 using NodeList = std::set<dev::p2p::NodeID>;
 using NodeID = dev::p2p::NodeID;
 using NodeIDs = std::vector<dev::p2p::NodeID>;
@@ -76,6 +117,14 @@ enum SyncPacketType : byte
     TransactionsPacket = 0x01,
     BlocksPacket = 0x02,
     ReqBlocskPacket = 0x03,
+    TxsHashesPacket = 0x04,
+    ReqTxsPacket = 0x05,
+    ReqSnapshotManifestPacket = 0x06,
+    SnapshotManifestPacket = 0x07,
+    ReqSnapshotChunkPacket = 0x08,
+    SnapshotChunkPacket = 0x09,
+    ReqHeadersPacket = 0x0a,
+    HeadersPacket = 0x0b,
     PacketCount
 };
 
@@ -83,6 +132,7 @@ enum class SyncState
 {
     Idle,         ///< Initial chain sync complete. Waiting for new packets
     Downloading,  ///< Downloading blocks
+    Snapshot,     ///< Downloading the state snapshot of a checkpoint
     Size          /// Must be kept last
 };
 
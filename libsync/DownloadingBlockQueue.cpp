@@ -23,6 +23,7 @@
 #include "DownloadingBlockQueue.h"
 #include "Common.h"
 #include <libdevcore/easylog.h>
+#include <future>
 
 using namespace std;
 using namespace dev;
@@ -128,17 +129,21 @@ void DownloadingBlockQueue::flushBufferToQueue()
         m_buffer = make_shared<ShardPtrVec>();  // m_buffer point to a new vector
     }
 
-    // pop buffer into queue
-    WriteGuard l(x_blocks);
-
+    // collect the blocks of the shards the queue can hold
+    size_t queueSize;
+    {
+        ReadGuard l(x_blocks);
+        queueSize = m_blocks.size();
+    }
+    std::vector<bytesConstRef> blocksRLP;
     for (ShardPtr blocksShard : *localBuffer)
     {
-        if (m_blocks.size() >= c_maxDownloadingBlockQueueSize)  // TODO not to use size to control
-                                                                // insert
+        // TODO not to use size to control insert
+        if (queueSize + blocksRLP.size() >= c_maxDownloadingBlockQueueSize)
         {
             SYNC_LOG(TRACE) << LOG_BADGE("Download") << LOG_BADGE("BlockSync")
                             << LOG_DESC("DownloadingBlockQueueBuffer is full")
-                            << LOG_KV("queueSize", m_blocks.size());
+                            << LOG_KV("queueSize", queueSize + blocksRLP.size());
 
             break;
         }
@@ -147,35 +152,73 @@ void DownloadingBlockQueue::flushBufferToQueue()
                         << LOG_DESC("Decoding block buffer")
                         << LOG_KV("blocksShardSize", blocksShard->blocksBytes.size());
 
-
         RLP const& rlps = RLP(ref(blocksShard->blocksBytes));
-        unsigned itemCount = rlps.itemCount();
-        size_t successCnt = 0;
-        for (unsigned i = 0; i < itemCount; ++i)
+        for (unsigned i = 0; i < rlps.itemCount(); ++i)
+        {
+            blocksRLP.push_back(rlps[i].data());
+        }
+    }
+
+    // decode the blocks out of the lock, the shards are alive with localBuffer
+    BlockPtrVec blocks = decodeBlocks(blocksRLP);
+
+    // pop buffer into queue
+    size_t successCnt = 0;
+    WriteGuard l(x_blocks);
+    for (auto const& block : blocks)
+    {
+        if (block && isNewerBlock(block))
+        {
+            successCnt++;
+            m_blocks.push(block);
+        }
+    }
+
+    if (!blocksRLP.empty())
+    {
+        SYNC_LOG(TRACE) << LOG_BADGE("Download") << LOG_BADGE("BlockSync")
+                        << LOG_DESC("Flush buffer to block queue") << LOG_KV("import", successCnt)
+                        << LOG_KV("rcv", blocksRLP.size())
+                        << LOG_KV("downloadBlockQueue", m_blocks.size());
+    }
+}
+
+/// decoding a block recovers the senders of its transactions, which dominates the time of
+/// flushing, so the blocks are decoded in batches on the decode pool and the calling thread
+BlockPtrVec DownloadingBlockQueue::decodeBlocks(std::vector<bytesConstRef> const& _blocksRLP)
+{
+    BlockPtrVec blocks(_blocksRLP.size());
+    auto decodeBatch = [&_blocksRLP, &blocks, this](size_t _begin, size_t _end) {
+        for (size_t i = _begin; i < _end; i++)
         {
             try
             {
-                shared_ptr<Block> block = make_shared<Block>(rlps[i].toBytes());
-                if (isNewerBlock(block))
-                {
-                    successCnt++;
-                    m_blocks.push(block);
-                }
+                blocks[i] = make_shared<Block>(_blocksRLP[i].toBytes());
             }
             catch (std::exception& e)
             {
                 SYNC_LOG(WARNING) << LOG_BADGE("Download") << LOG_BADGE("BlockSync")
                                   << LOG_DESC("Invalid block RLP") << LOG_KV("reason", e.what())
-                                  << LOG_KV("RLPDataSize", rlps.data().size());
-                continue;
+                                  << LOG_KV("RLPDataSize", _blocksRLP[i].size());
             }
         }
-
-        SYNC_LOG(TRACE) << LOG_BADGE("Download") << LOG_BADGE("BlockSync")
-                        << LOG_DESC("Flush buffer to block queue") << LOG_KV("import", successCnt)
-                        << LOG_KV("rcv", itemCount)
-                        << LOG_KV("downloadBlockQueue", m_blocks.size());
+    };
+    size_t batchNum = m_decodePool ? c_syncVerifyThreadNum + 1 : 1;
+    size_t batchSize = std::max((size_t)1, (_blocksRLP.size() + batchNum - 1) / batchNum);
+    std::vector<std::future<void>> results;
+    for (size_t begin = batchSize; m_decodePool && begin < _blocksRLP.size(); begin += batchSize)
+    {
+        auto task = std::make_shared<std::packaged_task<void()>>(
+            std::bind(decodeBatch, begin, std::min(begin + batchSize, _blocksRLP.size())));
+        results.push_back(task->get_future());
+        m_decodePool->enqueue([task]() { (*task)(); });
+    }
+    decodeBatch(0, std::min(batchSize, _blocksRLP.size()));
+    for (auto& result : results)
+    {
+        result.wait();
     }
+    return blocks;
 }
 
 void DownloadingBlockQueue::clearFullQueueIfNotHas(int64_t _blockNumber)
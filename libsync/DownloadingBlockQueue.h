@@ -24,6 +24,7 @@
 #include "Common.h"
 #include <libblockchain/BlockChainInterface.h>
 #include <libdevcore/Guards.h>
+#include <libdevcore/ThreadPool.h>
 #include <libethcore/Block.h>
 #include <climits>
 #include <queue>
@@ -106,6 +107,12 @@ public:
 
     void clearFullQueueIfNotHas(int64_t _blockNumber);
 
+    /// decode the blocks and recover the senders of their transactions on the pool
+    void setDecodePool(std::shared_ptr<dev::ThreadPool> _decodePool)
+    {
+        m_decodePool = _decodePool;
+    }
+
 private:
     std::shared_ptr<dev::blockchain::BlockChainInterface> m_blockChain;
     PROTOCOL_ID m_protocolId;
@@ -117,9 +124,12 @@ private:
 
     mutable SharedMutex x_blocks;
     mutable SharedMutex x_buffer;
+    std::shared_ptr<dev::ThreadPool> m_decodePool;
 
 private:
     bool isNewerBlock(std::shared_ptr<dev::eth::Block> _block);
+    /// decode the block RLPs, the invalid ones are left null
+    BlockPtrVec decodeBlocks(std::vector<bytesConstRef> const& _blocksRLP);
 };
 
 }  // namespace sync
@@ -0,0 +1,199 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2018 fisco-dev contributors.
+ */
+/**
+ * @brief : the verified headers of the blocks to be downloaded
+ * @file: DownloadingHeaderChain.cpp
+ * @date: 2019-06-17
+ */
+
+#include "DownloadingHeaderChain.h"
+#include <libdevcore/easylog.h>
+#include <future>
+
+using namespace std;
+using namespace dev;
+using namespace dev::eth;
+using namespace dev::sync;
+
+/// only one headers request is in flight, the others are late or unsolicited
+static size_t const c_maxBufferedHeadersPackets = 16;
+
+void DownloadingHeaderChain::push(NodeID const& _peer, RLP const& _rlps)
+{
+    {
+        Guard l(x_buffer);
+        if (m_buffer.size() >= c_maxBufferedHeadersPackets)
+        {
+            SYNC_LOG(TRACE) << LOG_BADGE("Download") << LOG_BADGE("Headers")
+                            << LOG_DESC("Drop headers packet for buffer full")
+                            << LOG_KV("peer", _peer.abridged());
+            return;
+        }
+        m_buffer.emplace_back(_peer, _rlps.data().toBytes());
+    }
+    m_received = true;
+}
+
+size_t DownloadingHeaderChain::verify()
+{
+    prune();
+    std::deque<std::pair<NodeID, bytes>> buffer;
+    {
+        Guard l(x_buffer);
+        buffer.swap(m_buffer);
+    }
+    size_t verified = 0;
+    for (auto const& packet : buffer)
+    {
+        verified += verifyPacket(packet.first, packet.second);
+    }
+    return verified;
+}
+
+size_t DownloadingHeaderChain::verifyPacket(NodeID const& _peer, bytes const& _packet)
+{
+    int64_t currentNumber = m_blockChain->number();
+    int64_t number = highest();
+    h256 parentHash =
+        m_hashes.empty() ? m_blockChain->numberHash(number) : m_hashes.rbegin()->second;
+
+    // the headers must follow the highest verified one
+    BlockPtrVec headers;
+    try
+    {
+        RLP const rlps(_packet);
+        for (size_t i = 0; i < rlps.itemCount(); i++)
+        {
+            if (number - currentNumber >= c_maxHeadersAhead)
+                break;
+            RLP const& item = rlps[i];
+            BlockHeader header(item[0].data(), HeaderData);
+            if (header.number() <= number)
+                continue;
+            if (header.number() != number + 1 || header.parentHash() != parentHash)
+            {
+                SYNC_LOG(DEBUG) << LOG_BADGE("Download") << LOG_BADGE("Headers")
+                                << LOG_DESC("Ignore inconsecutive header")
+                                << LOG_KV("number", header.number())
+                                << LOG_KV("expectedNumber", number + 1)
+                                << LOG_KV("peer", _peer.abridged());
+                break;
+            }
+            auto block = make_shared<Block>();
+            block->setBlockHeader(header);
+            block->setSigList(item[1].toVector<std::pair<u256, Signature>>());
+            headers.push_back(block);
+            number = header.number();
+            parentHash = header.hash();
+        }
+    }
+    catch (std::exception& e)
+    {
+        SYNC_LOG(WARNING) << LOG_BADGE("Download") << LOG_BADGE("Headers")
+                          << LOG_DESC("Invalid headers packet") << LOG_KV("reason", e.what())
+                          << LOG_KV("peer", _peer.abridged());
+    }
+    if (headers.empty())
+        return 0;
+
+    // check the signatures in parallel
+    std::vector<std::future<bool>> results;
+    for (auto const& header : headers)
+    {
+        auto task = std::make_shared<std::packaged_task<bool()>>(
+            [this, header]() { return !fp_isConsensusOk || fp_isConsensusOk(*header); });
+        results.push_back(task->get_future());
+        if (m_verifyPool)
+            m_verifyPool->enqueue([task]() { (*task)(); });
+        else
+            (*task)();
+    }
+    size_t verified = 0;
+    bool rejected = false;
+    for (size_t i = 0; i < headers.size(); i++)
+    {
+        bool ok = results[i].get();
+        if (rejected || !ok)
+        {
+            rejected = true;
+            continue;
+        }
+        m_hashes[headers[i]->header().number()] = headers[i]->header().hash();
+        verified++;
+    }
+    if (rejected)
+    {
+        m_rejected = true;
+        SYNC_LOG(WARNING) << LOG_BADGE("Download") << LOG_BADGE("Headers")
+                          << LOG_DESC("Header consensus check failed")
+                          << LOG_KV("number", headers[verified]->header().number())
+                          << LOG_KV("peer", _peer.abridged());
+    }
+    SYNC_LOG(DEBUG) << LOG_BADGE("Download") << LOG_BADGE("Headers")
+                    << LOG_DESC("Verify headers") << LOG_KV("verified", verified)
+                    << LOG_KV("received", headers.size()) << LOG_KV("highest", highest())
+                    << LOG_KV("peer", _peer.abridged());
+    return verified;
+}
+
+void DownloadingHeaderChain::prune()
+{
+    h512s sealers = m_blockChain->sealerList();
+    if (sealers != m_sealers)
+    {
+        if (!m_hashes.empty())
+            SYNC_LOG(DEBUG) << LOG_BADGE("Download") << LOG_BADGE("Headers")
+                            << LOG_DESC("Sealers changed, drop verified headers")
+                            << LOG_KV("headers", m_hashes.size());
+        m_hashes.clear();
+        m_sealers = sealers;
+    }
+    m_hashes.erase(m_hashes.begin(), m_hashes.upper_bound(m_blockChain->number()));
+    if (m_hashes.empty())
+        m_rejected = false;
+}
+
+int64_t DownloadingHeaderChain::highest()
+{
+    int64_t number = m_blockChain->number();
+    if (m_hashes.empty())
+        return number;
+    return max(number, m_hashes.rbegin()->first);
+}
+
+h256 DownloadingHeaderChain::verifiedHash(int64_t _number) const
+{
+    auto it = m_hashes.find(_number);
+    if (it == m_hashes.end())
+        return h256();
+    return it->second;
+}
+
+bool DownloadingHeaderChain::waiting()
+{
+    return m_rejected && m_blockChain->number() < highest();
+}
+
+void DownloadingHeaderChain::clear()
+{
+    {
+        Guard l(x_buffer);
+        m_buffer.clear();
+    }
+    m_hashes.clear();
+    m_rejected = false;
+}
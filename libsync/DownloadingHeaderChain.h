@@ -0,0 +1,104 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2018 fisco-dev contributors.
+ */
+/**
+ * @brief : the verified headers of the blocks to be downloaded
+ * @file: DownloadingHeaderChain.h
+ * @date: 2019-06-17
+ */
+
+#pragma once
+#include "Common.h"
+#include <libblockchain/BlockChainInterface.h>
+#include <libdevcore/FixedHash.h>
+#include <libdevcore/Guards.h>
+#include <libdevcore/ThreadPool.h>
+#include <libethcore/Block.h>
+#include <atomic>
+#include <deque>
+#include <map>
+
+namespace dev
+{
+namespace sync
+{
+/// The headers are downloaded ahead of the block bodies, a header is verified if it follows the
+/// highest verified one and carries enough signatures of the current sealers, then the bodies
+/// downloaded from any peer only have to match the verified hashes
+class DownloadingHeaderChain
+{
+public:
+    DownloadingHeaderChain(std::shared_ptr<dev::blockchain::BlockChainInterface> _blockChain,
+        PROTOCOL_ID _protocolId, NodeID const& _nodeId)
+      : m_blockChain(_blockChain), m_protocolId(_protocolId), m_nodeId(_nodeId)
+    {
+        m_groupId = dev::eth::getGroupAndProtocol(m_protocolId).first;
+    }
+
+    /// check the signatures of the headers on the pool
+    void setVerifyPool(std::shared_ptr<dev::ThreadPool> _verifyPool)
+    {
+        m_verifyPool = _verifyPool;
+    }
+    void setConsensusVerifyHandler(std::function<bool(dev::eth::Block const&)> _handler)
+    {
+        fp_isConsensusOk = _handler;
+    }
+
+    /// push a headers packet received from the peer, called by the network thread
+    void push(NodeID const& _peer, RLP const& _rlps);
+    /// @returns true if any headers packet is pushed since the last call
+    bool takeReceived() { return m_received.exchange(false); }
+
+    /// The methods below are called by the sync thread
+    /// verify the pushed headers, @returns the number of the headers verified
+    size_t verify();
+    /// drop the headers of the imported blocks, and all of them if the sealers changed since
+    /// they were verified
+    void prune();
+    /// the highest verified number, or the block number if no header is verified
+    int64_t highest();
+    /// the verified hash of the block, empty if the header is not verified
+    h256 verifiedHash(int64_t _number) const;
+    /// some headers failed to verify, wait for the blocks before them to be imported
+    bool waiting();
+    size_t size() const { return m_hashes.size(); }
+    void clear();
+
+private:
+    size_t verifyPacket(NodeID const& _peer, bytes const& _packet);
+
+    std::shared_ptr<dev::blockchain::BlockChainInterface> m_blockChain;
+    PROTOCOL_ID m_protocolId;
+    GROUP_ID m_groupId;
+    NodeID m_nodeId;
+    std::shared_ptr<dev::ThreadPool> m_verifyPool;
+    std::function<bool(dev::eth::Block const&)> fp_isConsensusOk = nullptr;
+
+    /// headers packets pushed by the network thread
+    Mutex x_buffer;
+    std::deque<std::pair<NodeID, bytes>> m_buffer;
+    std::atomic<bool> m_received = {false};
+
+    /// number => hash of the verified headers above the block number
+    std::map<int64_t, h256> m_hashes;
+    /// the sealers the headers are verified with
+    h512s m_sealers;
+    bool m_rejected = false;
+};
+
+}  // namespace sync
+}  // namespace dev
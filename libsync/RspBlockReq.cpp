@@ -97,3 +97,26 @@ bool DownloadRequestQueue::empty()
 {
     return m_reqQueue.empty();
 }
+
+bool RespondBandwidth::exceeded(uint64_t _now)
+{
+    Guard l(x_bytes);
+    roll(_now);
+    return m_bytes >= c_maxRespondBytesPerPeer;
+}
+
+void RespondBandwidth::add(size_t _bytes, uint64_t _now)
+{
+    Guard l(x_bytes);
+    roll(_now);
+    m_bytes += _bytes;
+}
+
+void RespondBandwidth::roll(uint64_t _now)
+{
+    if (_now / 1000 != m_second)
+    {
+        m_second = _now / 1000;
+        m_bytes = 0;
+    }
+}
@@ -51,6 +51,22 @@ struct RequestQueueCmp
     }
 };
 
+/// bytes sent to a peer in the current second
+class RespondBandwidth
+{
+public:
+    /// @returns true if c_maxRespondBytesPerPeer is sent in this second
+    bool exceeded(uint64_t _now);
+    void add(size_t _bytes, uint64_t _now);
+
+private:
+    void roll(uint64_t _now);
+
+    Mutex x_bytes;
+    uint64_t m_second = 0;
+    uint64_t m_bytes = 0;
+};
+
 class DownloadRequestQueue
 {
 public:
@@ -0,0 +1,449 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2018 fisco-dev contributors.
+ */
+
+/**
+ * @brief : download the state snapshot of a checkpoint from the peers
+ * @file: SnapshotSync.cpp
+ * @date: 2019-06-12
+ */
+
+#include "SnapshotSync.h"
+#include "SyncMsgPacket.h"
+#include <libdevcrypto/Hash.h>
+
+using namespace std;
+using namespace dev;
+using namespace dev::sync;
+using namespace dev::p2p;
+
+SnapshotSync::SnapshotSync(std::shared_ptr<dev::p2p::P2PInterface> _service,
+    std::shared_ptr<dev::blockchain::BlockChainInterface> _blockChain,
+    dev::storage::LevelDBStorage::Ptr _storage, PROTOCOL_ID const& _protocolId,
+    NodeID const& _nodeId)
+  : m_service(_service),
+    m_blockChain(_blockChain),
+    m_storage(_storage),
+    m_protocolId(_protocolId),
+    m_nodeId(_nodeId)
+{
+    m_groupId = dev::eth::getGroupAndProtocol(m_protocolId).first;
+    m_manifest.number = 0;
+    m_manifest.chunks = 0;
+    m_anyImported = m_storage && m_storage->snapshotImporting();
+}
+
+void SnapshotSync::onManifest(NodeID const& _peer, int64_t _number, h256 const& _blockHash,
+    h256 const& _root, unsigned _chunks, unsigned _from, std::vector<h256> const& _hashes)
+{
+    if (m_phase != Phase::Manifest || _number <= 0 || _chunks == 0 || _hashes.empty())
+    {
+        return;
+    }
+    Manifest manifest;
+    manifest.number = _number;
+    manifest.blockHash = _blockHash;
+    manifest.root = _root;
+    manifest.chunks = _chunks;
+    {
+        Guard l(x_state);
+        m_lastProgressTime = utcTime();
+        if (!m_chosen)
+        {
+            /// only the sealers vote, and none of them replaces the first page of another
+            h512s sealers = m_blockChain->sealerList();
+            if (_from != 0 || std::find(sealers.begin(), sealers.end(), _peer) == sealers.end())
+            {
+                return;
+            }
+            m_votes[manifest].insert(_peer);
+            m_firstPages[manifest][_peer] = _hashes;
+        }
+        else if (!(manifest < m_manifest) && !(m_manifest < manifest) &&
+                 _from == m_chunkHashes.size() && m_providers.count(_peer))
+        {
+            m_chunkHashes.insert(m_chunkHashes.end(), _hashes.begin(), _hashes.end());
+            m_pagePeers.insert(_peer);
+            m_lastRequestTime = 0;
+        }
+    }
+    SYNC_LOG(DEBUG) << LOG_BADGE("Snapshot") << LOG_DESC("Receive snapshot manifest")
+                    << LOG_KV("peer", _peer.abridged()) << LOG_KV("number", _number)
+                    << LOG_KV("root", _root.abridged()) << LOG_KV("chunks", _chunks)
+                    << LOG_KV("from", _from) << LOG_KV("hashes", _hashes.size());
+    notify();
+}
+
+void SnapshotSync::onChunk(
+    NodeID const& _peer, int64_t _number, unsigned _index, bytesConstRef _chunk)
+{
+    h256 expectedHash;
+    {
+        Guard l(x_state);
+        if (m_phase != Phase::Chunks || _number != m_manifest.number ||
+            _index >= m_chunkHashes.size() || m_receivedChunks[_index])
+        {
+            return;
+        }
+        expectedHash = m_chunkHashes[_index];
+    }
+    /// hash the chunk on the network thread, the sync thread only writes them
+    bool valid = (sha3(_chunk) == expectedHash);
+    {
+        Guard l(x_state);
+        if (m_phase != Phase::Chunks || _number != m_manifest.number || m_receivedChunks[_index])
+        {
+            return;
+        }
+        auto it = m_requested.find(_index);
+        if (!valid)
+        {
+            /// ask another peer for the chunk, and never ask the peer again
+            if (it != m_requested.end() && it->second.first == _peer)
+            {
+                m_requested.erase(it);
+                m_retryChunks.push_back(_index);
+            }
+            m_providers.erase(_peer);
+        }
+        else
+        {
+            if (it != m_requested.end())
+            {
+                m_requested.erase(it);
+            }
+            m_receivedChunks[_index] = true;
+            m_verifiedChunks.emplace_back(_index, _chunk.toBytes());
+            m_lastProgressTime = utcTime();
+        }
+    }
+    if (!valid)
+    {
+        SYNC_LOG(WARNING) << LOG_BADGE("Snapshot") << LOG_DESC("Receive invalid snapshot chunk")
+                          << LOG_KV("peer", _peer.abridged()) << LOG_KV("index", _index)
+                          << LOG_KV("size", _chunk.size());
+        return;
+    }
+    notify();
+}
+
+bool SnapshotSync::maintain(NodeIDs const& _peers)
+{
+    uint64_t now = utcTime();
+    uint64_t lastProgressTime;
+    {
+        Guard l(x_state);
+        if (m_lastProgressTime == 0)
+        {
+            m_lastProgressTime = now;
+        }
+        lastProgressTime = m_lastProgressTime;
+    }
+    if (m_phase == Phase::Manifest)
+    {
+        maintainManifest(_peers, now);
+    }
+    if (m_phase == Phase::Chunks)
+    {
+        importVerifiedChunks();
+        if (m_importedChunks == m_manifest.chunks)
+        {
+            finishImport();
+            return m_phase == Phase::Finished;
+        }
+        maintainChunks(_peers, now);
+    }
+    if (m_phase != Phase::Finished && now > lastProgressTime + c_snapshotStallTimeout)
+    {
+        if (!m_anyImported)
+        {
+            SYNC_LOG(WARNING) << LOG_BADGE("Snapshot")
+                              << LOG_DESC("No snapshot downloaded, sync the blocks instead");
+            m_phase = Phase::Failed;
+        }
+        else
+        {
+            SYNC_LOG(WARNING) << LOG_BADGE("Snapshot")
+                              << LOG_DESC("Snapshot download stalled, choose the manifest again")
+                              << LOG_KV("imported", m_importedChunks);
+            restart();
+        }
+    }
+    return m_phase == Phase::Finished || m_phase == Phase::Failed;
+}
+
+void SnapshotSync::maintainManifest(NodeIDs const& _peers, uint64_t _now)
+{
+    Guard l(x_state);
+    if (!m_chosen)
+    {
+        /// the sealers of the genesis block, and f + 1 of them must agree
+        h512s sealers = m_blockChain->sealerList();
+        size_t quorum = (sealers.size() + 2) / 3;
+        for (auto it = m_votes.rbegin(); it != m_votes.rend() && !sealers.empty(); ++it)
+        {
+            size_t votes = 0;
+            for (auto const& peer : it->second)
+            {
+                if (std::find(sealers.begin(), sealers.end(), peer) != sealers.end())
+                {
+                    votes++;
+                }
+            }
+            if (votes < quorum || m_firstPages[it->first].empty())
+            {
+                continue;
+            }
+            m_chosen = true;
+            m_manifest = it->first;
+            m_providers = it->second;
+            /// the first page of any sealer voted, the others are tried if it's invalid
+            auto const& firstPage = *m_firstPages[it->first].begin();
+            m_chunkHashes = firstPage.second;
+            m_pagePeers = NodeList{firstPage.first};
+            m_lastRequestTime = 0;
+            SYNC_LOG(INFO) << LOG_BADGE("Snapshot") << LOG_DESC("Choose snapshot manifest")
+                           << LOG_KV("number", m_manifest.number)
+                           << LOG_KV("blockHash", m_manifest.blockHash.abridged())
+                           << LOG_KV("chunks", m_manifest.chunks) << LOG_KV("votes", votes);
+            break;
+        }
+    }
+    if (!m_chosen)
+    {
+        if (_now - m_lastRequestTime < c_snapshotRequestTimeout)
+        {
+            return;
+        }
+        m_lastRequestTime = _now;
+        SyncReqSnapshotManifestPacket packet;
+        packet.encode(c_latestSnapshotNumber, 0);
+        auto msg = packet.toMessage(m_protocolId);
+        for (auto const& peer : _peers)
+        {
+            m_service->asyncSendMessageByNodeID(peer, msg, CallbackFuncWithSession(), Options());
+        }
+        return;
+    }
+    if (m_chunkHashes.size() < m_manifest.chunks)
+    {
+        if (_now - m_lastRequestTime < c_snapshotRequestTimeout)
+        {
+            return;
+        }
+        /// the pages are requested one by one from the providers in turn
+        NodeIDs providers;
+        for (auto const& peer : _peers)
+        {
+            if (m_providers.count(peer))
+            {
+                providers.push_back(peer);
+            }
+        }
+        if (providers.empty())
+        {
+            return;
+        }
+        m_lastRequestTime = _now;
+        SyncReqSnapshotManifestPacket packet;
+        packet.encode(m_manifest.number, m_chunkHashes.size());
+        auto const& peer = providers[m_chunkHashes.size() / c_maxManifestChunkHashes %
+                                     providers.size()];
+        m_service->asyncSendMessageByNodeID(
+            peer, packet.toMessage(m_protocolId), CallbackFuncWithSession(), Options());
+        return;
+    }
+    RLPStream s;
+    s << m_chunkHashes;
+    if (m_chunkHashes.size() != m_manifest.chunks || sha3(s.out()) != m_manifest.root)
+    {
+        SYNC_LOG(WARNING) << LOG_BADGE("Snapshot") << LOG_DESC("Invalid snapshot chunk hashes")
+                          << LOG_KV("number", m_manifest.number)
+                          << LOG_KV("hashes", m_chunkHashes.size())
+                          << LOG_KV("pagePeers", m_pagePeers.size());
+        /// only the votes of the peers sent the pages are dropped, the manifest is chosen again
+        /// with the first page of another sealer if it still has enough votes
+        for (auto const& peer : m_pagePeers)
+        {
+            m_votes[m_manifest].erase(peer);
+            m_firstPages[m_manifest].erase(peer);
+        }
+        if (m_votes[m_manifest].empty())
+        {
+            m_votes.erase(m_manifest);
+            m_firstPages.erase(m_manifest);
+        }
+        m_chosen = false;
+        m_chunkHashes.clear();
+        m_pagePeers.clear();
+        return;
+    }
+    m_requested.clear();
+    m_retryChunks.clear();
+    m_nextChunk = 0;
+    m_receivedChunks.assign(m_manifest.chunks, false);
+    m_verifiedChunks.clear();
+    m_phase = Phase::Chunks;
+    SYNC_LOG(INFO) << LOG_BADGE("Snapshot") << LOG_DESC("Start downloading snapshot chunks")
+                   << LOG_KV("number", m_manifest.number) << LOG_KV("chunks", m_manifest.chunks)
+                   << LOG_KV("providers", m_providers.size());
+}
+
+void SnapshotSync::maintainChunks(NodeIDs const& _peers, uint64_t _now)
+{
+    Guard l(x_state);
+    for (auto it = m_requested.begin(); it != m_requested.end();)
+    {
+        if (_now - it->second.second > c_snapshotRequestTimeout)
+        {
+            m_retryChunks.push_back(it->first);
+            it = m_requested.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+    std::map<NodeID, size_t> requesting;
+    for (auto const& peer : _peers)
+    {
+        if (m_providers.count(peer))
+        {
+            requesting[peer] = 0;
+        }
+    }
+    if (requesting.empty())
+    {
+        SYNC_LOG(DEBUG) << LOG_BADGE("Snapshot") << LOG_DESC("No peer serves the snapshot");
+        return;
+    }
+    for (auto const& request : m_requested)
+    {
+        auto it = requesting.find(request.second.first);
+        if (it != requesting.end())
+        {
+            it->second++;
+        }
+    }
+    /// spread the chunks over the providers, each serves several of them at the same time
+    bool assigned = true;
+    while (assigned)
+    {
+        assigned = false;
+        for (auto& peer : requesting)
+        {
+            if (peer.second >= c_maxSnapshotRequestsPerPeer)
+            {
+                continue;
+            }
+            unsigned index;
+            if (!m_retryChunks.empty())
+            {
+                index = m_retryChunks.front();
+                m_retryChunks.pop_front();
+            }
+            else if (m_nextChunk < m_manifest.chunks)
+            {
+                index = m_nextChunk++;
+            }
+            else
+            {
+                return;
+            }
+            if (m_receivedChunks[index])
+            {
+                assigned = true;
+                continue;
+            }
+            SyncReqSnapshotChunkPacket packet;
+            packet.encode(m_manifest.number, index);
+            m_service->asyncSendMessageByNodeID(
+                peer.first, packet.toMessage(m_protocolId), CallbackFuncWithSession(), Options());
+            m_requested[index] = std::make_pair(peer.first, _now);
+            peer.second++;
+            assigned = true;
+        }
+    }
+}
+
+void SnapshotSync::importVerifiedChunks()
+{
+    while (true)
+    {
+        std::deque<std::pair<unsigned, bytes>> chunks;
+        {
+            Guard l(x_state);
+            chunks.swap(m_verifiedChunks);
+        }
+        if (chunks.empty())
+        {
+            return;
+        }
+        for (auto const& chunk : chunks)
+        {
+            m_storage->importSnapshotChunk(ref(chunk.second));
+            m_anyImported = true;
+            m_importedChunks++;
+        }
+        SYNC_LOG(DEBUG) << LOG_BADGE("Snapshot") << LOG_DESC("Import snapshot chunks")
+                        << LOG_KV("imported", m_importedChunks)
+                        << LOG_KV("chunks", m_manifest.chunks);
+    }
+}
+
+void SnapshotSync::finishImport()
+{
+    m_storage->finishSnapshotImport();
+    m_blockChain->reloadFromStorage();
+    int64_t number = m_blockChain->number();
+    h256 blockHash = m_blockChain->numberHash(number);
+    if (number != m_manifest.number || blockHash != m_manifest.blockHash)
+    {
+        /// the blocks can't be synced on top of the imported chunks, import another snapshot
+        SYNC_LOG(ERROR) << LOG_BADGE("Snapshot")
+                        << LOG_DESC("The imported snapshot mismatches the manifest, import again")
+                        << LOG_KV("number", number) << LOG_KV("blockHash", blockHash.abridged())
+                        << LOG_KV("manifestNumber", m_manifest.number)
+                        << LOG_KV("manifestBlockHash", m_manifest.blockHash.abridged());
+        restart();
+        return;
+    }
+    m_storage->confirmSnapshotImport();
+    m_phase = Phase::Finished;
+    SYNC_LOG(INFO) << LOG_BADGE("Snapshot") << LOG_DESC("Snapshot sync finished")
+                   << LOG_KV("number", number) << LOG_KV("chunks", m_manifest.chunks);
+}
+
+void SnapshotSync::restart()
+{
+    Guard l(x_state);
+    m_votes.clear();
+    m_firstPages.clear();
+    m_chosen = false;
+    m_providers.clear();
+    m_chunkHashes.clear();
+    m_pagePeers.clear();
+    m_requested.clear();
+    m_retryChunks.clear();
+    m_receivedChunks.clear();
+    m_verifiedChunks.clear();
+    /// the current state of the chunks imported must not be written with the next snapshot
+    m_storage->discardSnapshotImport();
+    m_importedChunks = 0;
+    m_lastRequestTime = 0;
+    m_lastProgressTime = utcTime();
+    m_phase = Phase::Manifest;
+}
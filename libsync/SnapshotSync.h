@@ -0,0 +1,145 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2018 fisco-dev contributors.
+ */
+
+/**
+ * @brief : download the state snapshot of a checkpoint from the peers
+ * @file: SnapshotSync.h
+ * @date: 2019-06-12
+ */
+
+#pragma once
+#include "Common.h"
+#include <libblockchain/BlockChainInterface.h>
+#include <libdevcore/FixedHash.h>
+#include <libdevcore/Guards.h>
+#include <libp2p/P2PInterface.h>
+#include <libstorage/LevelDBStorage.h>
+#include <atomic>
+#include <deque>
+#include <map>
+#include <tuple>
+
+namespace dev
+{
+namespace sync
+{
+/// The dbHash and stateRoot of a block only cover the changes of the block, the manifest of a
+/// snapshot is trusted if f + 1 sealers send the same one, and every chunk is checked against the
+/// hash in the trusted manifest
+class SnapshotSync
+{
+public:
+    typedef std::shared_ptr<SnapshotSync> Ptr;
+
+    SnapshotSync(std::shared_ptr<dev::p2p::P2PInterface> _service,
+        std::shared_ptr<dev::blockchain::BlockChainInterface> _blockChain,
+        dev::storage::LevelDBStorage::Ptr _storage, PROTOCOL_ID const& _protocolId,
+        NodeID const& _nodeId);
+
+    /// called when a manifest or chunk is received, to wake up the sync thread
+    void setNotifier(std::function<void()> const& _notifier) { m_notifier = _notifier; }
+
+    /// a page of the chunk hashes of the snapshot from the peer
+    void onManifest(NodeID const& _peer, int64_t _number, h256 const& _blockHash,
+        h256 const& _root, unsigned _chunks, unsigned _from, std::vector<h256> const& _hashes);
+    void onChunk(NodeID const& _peer, int64_t _number, unsigned _index, bytesConstRef _chunk);
+
+    /// request the manifests and chunks from the peers and import the verified chunks
+    /// @returns true if the snapshot sync is over, no matter it succeeded or not
+    bool maintain(NodeIDs const& _peers);
+
+    bool succeeded() const { return m_phase == Phase::Finished; }
+    size_t importedChunks() const { return m_importedChunks; }
+    /// chunks of an unfinished import are in the storage, maybe written before a restart, the
+    /// blocks can't be synced on top of them so the snapshot sync never gives up
+    bool anyImported() const { return m_anyImported; }
+
+private:
+    enum class Phase
+    {
+        Manifest,  ///< Collecting the manifests and the chunk hashes
+        Chunks,    ///< Downloading the chunks
+        Finished,
+        Failed
+    };
+
+    struct Manifest
+    {
+        int64_t number;
+        h256 blockHash;
+        h256 root;
+        unsigned chunks;
+        bool operator<(Manifest const& _m) const
+        {
+            return std::tie(number, blockHash, root, chunks) <
+                   std::tie(_m.number, _m.blockHash, _m.root, _m.chunks);
+        }
+    };
+
+    /// choose the highest manifest sent by enough sealers and download its chunk hashes
+    void maintainManifest(NodeIDs const& _peers, uint64_t _now);
+    void maintainChunks(NodeIDs const& _peers, uint64_t _now);
+    void importVerifiedChunks();
+    /// write the current state and check the imported block against the manifest
+    void finishImport();
+    /// forget the manifests, the imported chunks will be overwritten by a complete snapshot
+    void restart();
+    void notify()
+    {
+        if (m_notifier)
+        {
+            m_notifier();
+        }
+    }
+
+    std::shared_ptr<dev::p2p::P2PInterface> m_service;
+    std::shared_ptr<dev::blockchain::BlockChainInterface> m_blockChain;
+    dev::storage::LevelDBStorage::Ptr m_storage;
+    PROTOCOL_ID m_protocolId;
+    GROUP_ID m_groupId;
+    NodeID m_nodeId;
+    std::function<void()> m_notifier;
+
+    mutable Mutex x_state;
+    std::atomic<Phase> m_phase = {Phase::Manifest};
+    /// manifests => the sealers sent them, and the first page of the chunk hashes of each sealer
+    std::map<Manifest, NodeList> m_votes;
+    std::map<Manifest, std::map<NodeID, std::vector<h256>>> m_firstPages;
+    bool m_chosen = false;
+    Manifest m_manifest;
+    /// peers serving the chosen manifest
+    NodeList m_providers;
+    std::vector<h256> m_chunkHashes;
+    /// peers sent the pages of m_chunkHashes, their votes are dropped if the hashes are invalid
+    NodeList m_pagePeers;
+    uint64_t m_lastRequestTime = 0;
+    uint64_t m_lastProgressTime = 0;
+
+    /// chunk index => the peer requested and the request time
+    std::map<unsigned, std::pair<NodeID, uint64_t>> m_requested;
+    std::deque<unsigned> m_retryChunks;
+    unsigned m_nextChunk = 0;
+    std::vector<bool> m_receivedChunks;
+    std::deque<std::pair<unsigned, bytes>> m_verifiedChunks;
+
+    /// the chunks are imported by the sync thread
+    std::atomic<size_t> m_importedChunks = {0};
+    bool m_anyImported = false;
+};
+
+}  // namespace sync
+}  // namespace dev
@@ -22,6 +22,7 @@
 
 #include "SyncMaster.h"
 #include <libblockchain/BlockChainInterface.h>
+#include <future>
 
 using namespace std;
 using namespace dev;
@@ -84,6 +85,19 @@ string const SyncMaster::syncInfo() const
     // m_syncStatus->knownHighestNumber)); syncInfo.push_back(json_spirit::Pair("knownLatestHash",
     // toHex(m_syncStatus->knownLatestHash)));
     syncInfo.push_back(json_spirit::Pair("txPoolSize", std::to_string(m_txPool->pendingSize())));
+    syncInfo.push_back(json_spirit::Pair("catchUpBlocks", (uint64_t)m_catchUpBlocks));
+    syncInfo.push_back(json_spirit::Pair("catchUpBlocksPerSecond", catchUpBlocksPerSecond()));
+    if (m_snapshotSync)
+        syncInfo.push_back(json_spirit::Pair(
+            "snapshotChunks", (uint64_t)m_snapshotSync->importedChunks()));
+
+    json_spirit::Object responderInfo;
+    responderInfo.push_back(
+        json_spirit::Pair("requests", m_blockResponder->respondedRequests()));
+    responderInfo.push_back(json_spirit::Pair("blocks", m_blockResponder->respondedBlocks()));
+    responderInfo.push_back(json_spirit::Pair("bytes", m_blockResponder->respondedBytes()));
+    responderInfo.push_back(json_spirit::Pair("throttled", m_blockResponder->throttledTimes()));
+    syncInfo.push_back(json_spirit::Pair("blockResponder", responderInfo));
 
     json_spirit::Array peersInfo;
     m_syncStatus->foreachPeer([&](shared_ptr<SyncPeerStatus> _p) {
@@ -103,6 +117,32 @@ string const SyncMaster::syncInfo() const
     return statusStr;
 }
 
+double SyncMaster::catchUpBlocksPerSecond() const
+{
+    uint64_t beginTime = m_catchUpBeginTime;
+    uint64_t endTime = isSyncing() ? utcTime() : (uint64_t)m_catchUpEndTime;
+    if (beginTime == 0 || endTime <= beginTime)
+    {
+        return 0;
+    }
+    return (double)m_catchUpBlocks * 1000 / (endTime - beginTime);
+}
+
+void SyncMaster::setSnapshotStorage(dev::storage::LevelDBStorage::Ptr _storage, bool _fastSync)
+{
+    m_snapshotPool = std::make_shared<dev::ThreadPool>(
+        "SnapshotServe-" + std::to_string(m_groupId), c_snapshotServeThreadNum);
+    m_msgEngine->setSnapshotStorage(_storage, m_snapshotPool);
+    /// an unfinished import is resumed even if fast sync is disabled since
+    if (_fastSync || _storage->snapshotImporting())
+    {
+        m_snapshotSync = std::make_shared<SnapshotSync>(
+            m_service, m_blockChain, _storage, m_protocolId, m_nodeId);
+        m_snapshotSync->setNotifier([&]() { m_signalled.notify_all(); });
+        m_msgEngine->setSnapshotSync(m_snapshotSync);
+    }
+}
+
 void SyncMaster::start()
 {
     if (!fp_isConsensusOk)
@@ -111,6 +151,13 @@ void SyncMaster::start()
         BOOST_THROW_EXCEPTION(SyncVerifyHandlerNotSet());
     }
 
+    /// only the nodes without any block or with an unfinished import download the snapshot
+    if (m_snapshotSync && (m_blockChain->number() == 0 || m_snapshotSync->anyImported()))
+    {
+        SYNC_LOG(INFO) << LOG_BADGE("Snapshot") << LOG_DESC("Start fast sync from snapshot");
+        m_syncStatus->state = SyncState::Snapshot;
+    }
+
     startWorking();
 }
 
@@ -131,8 +178,11 @@ void SyncMaster::doWork()
     // Always do
     maintainPeersConnection();
     maintainDownloadingQueueBuffer();
-    maintainPeersStatus();
+    if (m_syncStatus->state != SyncState::Snapshot)
+        maintainPeersStatus();
     maintainBlocks();
+    // the requests are served on the responder pool, even if this node is syncing
+    maintainBlockRequest();
 
     // Idle do
     if (!isSyncing())
@@ -143,8 +193,6 @@ void SyncMaster::doWork()
             m_newTransactions = false;
             maintainTransactions();
         }
-
-        maintainBlockRequest();
     }
 
     // Not Idle do
@@ -156,6 +204,8 @@ void SyncMaster::doWork()
             if (finished)
                 noteDownloadingFinish();
         }
+        else if (m_syncStatus->state == SyncState::Snapshot)
+            maintainSnapshot();
     }
 }
 
@@ -195,7 +245,12 @@ void SyncMaster::maintainTransactions()
 
     SYNC_LOG(TRACE) << LOG_BADGE("Tx") << LOG_DESC("Transaction need to send ")
                     << LOG_KV("txs", txSize) << LOG_KV("totalTxs", pendingSize);
-    UpgradableGuard l(m_txPool->xtransactionKnownBy());
+    if (m_announceTransactions)
+    {
+        announceTransactions(ts);
+        return;
+    }
+    /// known-by records are kept as per-peer bitmaps in the txpool, no lock is needed here
     for (size_t i = 0; i < ts.size(); ++i)
     {
         auto const& t = ts[i];
@@ -209,7 +264,6 @@ void SyncMaster::maintainTransactions()
         });
         if (0 == peers.size())
             return;
-        UpgradeGuard ul(l);
         m_txPool->setTransactionIsKnownBy(t.sha3(), m_nodeId);
         for (auto const& p : peers)
         {
@@ -241,6 +295,81 @@ void SyncMaster::maintainTransactions()
     });
 }
 
+/// broadcast hashes of the transactions to the sealers who don't know them,
+/// the sealers request bodies of the missing transactions with ReqTxsPacket
+void SyncMaster::announceTransactions(Transactions const& _ts)
+{
+    unordered_map<NodeID, std::vector<h256>> peerTxHashes;
+    for (auto const& t : _ts)
+    {
+        h256 txHash = t.sha3();
+        m_txPool->setTransactionIsKnownBy(txHash, m_nodeId);
+        m_syncStatus->foreachPeer([&](shared_ptr<SyncPeerStatus> _p) {
+            if (_p->isSealer && m_service->isConnected(_p->nodeId) &&
+                !m_txPool->isTransactionKnownBy(txHash, _p->nodeId))
+            {
+                peerTxHashes[_p->nodeId].push_back(txHash);
+                m_txPool->setTransactionIsKnownBy(txHash, _p->nodeId);
+            }
+            return true;
+        });
+    }
+
+    uint64_t currentTime = utcTime();
+    for (auto const& it : peerTxHashes)
+    {
+        auto const& txHashes = it.second;
+        /// the peer is marked as knowing the transactions until it disconnects before
+        /// c_announceTransactionsLostTime
+        m_announcedTxs[it.first].push_back(std::make_pair(currentTime, txHashes));
+        for (size_t offset = 0; offset < txHashes.size(); offset += c_maxAnnounceTransactions)
+        {
+            size_t end = min(offset + c_maxAnnounceTransactions, txHashes.size());
+            SyncTxsHashesPacket packet;
+            packet.encode(std::vector<h256>(txHashes.begin() + offset, txHashes.begin() + end));
+            auto msg = packet.toMessage(m_protocolId);
+            m_service->asyncSendMessageByNodeID(it.first, msg, CallbackFuncWithSession(), Options());
+            SYNC_LOG(DEBUG) << LOG_BADGE("Tx") << LOG_DESC("Announce transaction hashes to peer")
+                            << LOG_KV("txNum", end - offset)
+                            << LOG_KV("toNodeId", it.first.abridged())
+                            << LOG_KV("messageSize(B)", msg->buffer()->size());
+        }
+    }
+}
+
+/// the announcements in the session of a disconnected peer may be lost, reset the transactions
+/// as not broadcasted so that they are announced again to the peers that don't know them
+void SyncMaster::maintainAnnouncedTransactions(std::set<NodeID> const& _activePeers)
+{
+    uint64_t currentTime = utcTime();
+    for (auto it = m_announcedTxs.begin(); it != m_announcedTxs.end();)
+    {
+        auto& batches = it->second;
+        while (!batches.empty() &&
+               currentTime - batches.front().first > c_announceTransactionsLostTime)
+            batches.pop_front();
+        if (!batches.empty() && !_activePeers.count(it->first))
+        {
+            size_t lostTxs = 0;
+            for (auto const& batch : batches)
+            {
+                m_txPool->resetTransactionsKnownBy(batch.second, it->first);
+                m_txPool->resetTransactionsKnownBy(batch.second, m_nodeId);
+                lostTxs += batch.second.size();
+            }
+            m_newTransactions = true;
+            SYNC_LOG(DEBUG) << LOG_BADGE("Tx")
+                            << LOG_DESC("Announce again the transactions to disconnected peer")
+                            << LOG_KV("txNum", lostTxs) << LOG_KV("peer", it->first.abridged());
+            batches.clear();
+        }
+        if (batches.empty())
+            it = m_announcedTxs.erase(it);
+        else
+            ++it;
+    }
+}
+
 void SyncMaster::maintainBlocks()
 {
     if (!m_newBlocks && utcTime() <= m_maintainBlocksTimeout)
@@ -310,86 +439,159 @@ void SyncMaster::maintainPeersStatus()
         }
     }
 
-    // Skip downloading if last if not timeout
-
-    uint64_t currentTime = utcTime();
-    if (currentTime - m_lastDownloadingRequestTime < c_downloadingRequestTimeout)
-    {
-        SYNC_LOG(DEBUG) << LOG_BADGE("Download") << LOG_DESC("Waiting for peers' blocks")
-                        << LOG_KV("currentNumber", currentNumber)
-                        << LOG_KV("maxRequestNumber", m_maxRequestNumber)
-                        << LOG_KV("maxPeerNumber", maxPeerNumber);
-        return;  // no need to sync
-    }
-    m_lastDownloadingRequestTime = currentTime;
-
     // Start download
     noteDownloadingBegin();
+    maintainHeaderRequest(maxPeerNumber);
+    maintainBodyRequests(maxPeerNumber);
+}
 
-    // Choose to use min number in blockqueue or max peer number
-    int64_t maxRequestNumber = maxPeerNumber;
-    BlockPtr topBlock = m_syncStatus->bq().top();
-    if (nullptr != topBlock)
-    {
-        int64_t minNumberInQueue = topBlock->header().number();
-        maxRequestNumber = min(maxPeerNumber, minNumberInQueue - 1);
-    }
-    if (currentNumber >= maxRequestNumber)
-    {
-        SYNC_LOG(TRACE) << LOG_BADGE("Download")
-                        << LOG_DESC("No need to sync when blocks are already in queue")
-                        << LOG_KV("currentNumber", currentNumber)
-                        << LOG_KV("maxRequestNumber", maxRequestNumber);
-        return;  // no need to send request block packet
-    }
+void SyncMaster::maintainHeaderRequest(int64_t _maxPeerNumber)
+{
+    DownloadingHeaderChain& headerChain = m_syncStatus->headerChain();
+    headerChain.verify();
+    if (headerChain.takeReceived())
+        m_headersRequestTime = 0;
+
+    int64_t from = headerChain.highest() + 1;
+    if (from > _maxPeerNumber || headerChain.waiting() ||
+        from - m_blockChain->number() > c_maxHeadersAhead)
+        return;
+    uint64_t currentTime = utcTime();
+    if (currentTime - m_headersRequestTime < c_headersRequestTimeout)
+        return;  // waiting for the headers requested
 
-    // Sharding by c_maxRequestBlocks to request blocks
-    size_t shardNumber =
-        (maxRequestNumber - currentNumber + c_maxRequestBlocks - 1) / c_maxRequestBlocks;
-    size_t shard = 0;
+    m_syncStatus->foreachPeerRandom([&](std::shared_ptr<SyncPeerStatus> _p) {
+        if (_p->number < from || _p->bodyOnly(currentTime))
+            return true;  // exit, to next peer
 
-    m_maxRequestNumber = 0;  // each request turn has new m_maxRequestNumber
-    while (shard < shardNumber && shard < c_maxRequestShards)
-    {
-        bool thisTurnFound = false;
-        m_syncStatus->foreachPeerRandom([&](std::shared_ptr<SyncPeerStatus> _p) {
-            // shard: [from, to]
-            int64_t from = currentNumber + 1 + shard * c_maxRequestBlocks;
-            int64_t to = min(from + c_maxRequestBlocks - 1, maxRequestNumber);
-            if (_p->number < to)
-                return true;  // exit, to next peer
-
-            // found a peer
-            thisTurnFound = true;
-            SyncReqBlockPacket packet;
-            unsigned size = to - from + 1;
-            packet.encode(from, size);
-            m_service->asyncSendMessageByNodeID(
-                _p->nodeId, packet.toMessage(m_protocolId), CallbackFuncWithSession(), Options());
+        unsigned size = min(c_maxRequestHeaders, _p->number - from + 1);
+        SyncReqHeadersPacket packet;
+        packet.encode(from, size);
+        m_service->asyncSendMessageByNodeID(
+            _p->nodeId, packet.toMessage(m_protocolId), CallbackFuncWithSession(), Options());
+        m_headersRequestTime = currentTime;
+        if (_p->headersRequestTime == 0)
+            _p->headersRequestTime = currentTime;
+
+        SYNC_LOG(DEBUG) << LOG_BADGE("Download") << LOG_BADGE("Request")
+                        << LOG_DESC("Request headers") << LOG_KV("from", from)
+                        << LOG_KV("to", from + size - 1) << LOG_KV("peer", _p->nodeId.abridged());
+        return false;
+    });
+}
 
-            // update max request number
-            m_maxRequestNumber = max(m_maxRequestNumber, to);
+void SyncMaster::maintainBodyRequests(int64_t _maxPeerNumber)
+{
+    int64_t currentNumber = m_blockChain->number();
+    uint64_t currentTime = utcTime();
 
+    // take back the ranges the slow peers haven't sent
+    bool requesting = false;
+    size_t totalBlockSize = 0;
+    size_t measuredPeers = 0;
+    m_syncStatus->foreachPeer([&](shared_ptr<SyncPeerStatus> _p) {
+        int64_t from = 0;
+        int64_t size = 0;
+        if (_p->downloadWindow.checkTimeout(currentTime, from, size))
+        {
+            m_retryRanges.emplace_back(from, size);
             SYNC_LOG(DEBUG) << LOG_BADGE("Download") << LOG_BADGE("Request")
-                            << LOG_DESC("Request blocks") << LOG_KV("frm", from) << LOG_KV("to", to)
+                            << LOG_DESC("Request blocks timeout") << LOG_KV("from", from)
+                            << LOG_KV("to", from + size - 1)
+                            << LOG_KV("window", _p->downloadWindow.window())
                             << LOG_KV("peer", _p->nodeId.abridged());
+        }
+        requesting = requesting || !_p->downloadWindow.idle();
+        if (_p->downloadWindow.blockSize() > 0)
+        {
+            totalBlockSize += _p->downloadWindow.blockSize();
+            measuredPeers++;
+        }
+        return true;
+    });
 
-            ++shard;  // shard move
+    // the blocks requested are lost or dropped if none is coming and the next one isn't queued
+    BlockPtr topBlock = m_syncStatus->bq().top();
+    if (!requesting && m_retryRanges.empty() &&
+        (!topBlock || topBlock->header().number() != currentNumber + 1))
+        m_nextRequestNumber = currentNumber + 1;
+    m_nextRequestNumber = max(m_nextRequestNumber, currentNumber + 1);
+
+    // the blocks downloaded but not imported are limited by the memory budget
+    int64_t maxBlocks = c_maxDownloadingBlockQueueSize;
+    if (measuredPeers > 0)
+    {
+        int64_t budgetBlocks = c_downloadingMemoryBudget / max(totalBlockSize / measuredPeers,
+                                                               (size_t)1);
+        maxBlocks = min(maxBlocks, max(budgetBlocks, (int64_t)1));
+    }
+    // only the blocks of the verified headers are requested, except from the older peers serving
+    // no headers
+    int64_t maxRequestNumber = min(_maxPeerNumber, currentNumber + maxBlocks);
+    int64_t maxVerifiedNumber = min(maxRequestNumber, m_syncStatus->headerChain().highest());
 
-            return shard < shardNumber && shard < c_maxRequestShards;
-        });
+    m_syncStatus->foreachPeerRandom([&](std::shared_ptr<SyncPeerStatus> _p) {
+        if (!_p->downloadWindow.idle())
+            return true;  // exit, to next peer
 
-        if (!thisTurnFound)
+        int64_t window = _p->downloadWindow.window();
+        int64_t from = 0;
+        int64_t size = 0;
+        if (!popRetryRange(_p->number, window, from, size))
         {
-            int64_t from = currentNumber + shard * c_maxRequestBlocks;
-            int64_t to = min(from + c_maxRequestBlocks - 1, maxRequestNumber);
+            int64_t maxNumber = _p->bodyOnly(currentTime) ? maxRequestNumber : maxVerifiedNumber;
+            from = m_nextRequestNumber;
+            size = min(window, min(maxNumber, _p->number) - from + 1);
+            if (size <= 0)
+                return true;
+            m_nextRequestNumber += size;
+        }
+
+        SyncReqBlockPacket packet;
+        packet.encode(from, size);
+        m_service->asyncSendMessageByNodeID(
+            _p->nodeId, packet.toMessage(m_protocolId), CallbackFuncWithSession(), Options());
+        _p->downloadWindow.request(from, size, currentTime);
+
+        SYNC_LOG(DEBUG) << LOG_BADGE("Download") << LOG_BADGE("Request")
+                        << LOG_DESC("Request blocks") << LOG_KV("frm", from)
+                        << LOG_KV("to", from + size - 1) << LOG_KV("window", window)
+                        << LOG_KV("throughput", _p->downloadWindow.throughput())
+                        << LOG_KV("peer", _p->nodeId.abridged());
+        return true;
+    });
+}
 
-            SYNC_LOG(WARNING) << LOG_BADGE("Download") << LOG_BADGE("Request")
-                              << LOG_DESC("Couldn't find any peers to request blocks")
-                              << LOG_KV("from", from) << LOG_KV("to", to);
-            break;
+bool SyncMaster::popRetryRange(
+    int64_t _peerNumber, int64_t _window, int64_t& _from, int64_t& _size)
+{
+    int64_t currentNumber = m_blockChain->number();
+    for (auto it = m_retryRanges.begin(); it != m_retryRanges.end();)
+    {
+        int64_t from = max(it->first, currentNumber + 1);
+        int64_t to = it->first + it->second - 1;
+        if (from > to)
+        {
+            it = m_retryRanges.erase(it);  // imported already
+            continue;
+        }
+        if (_peerNumber < to)
+        {
+            ++it;
+            continue;
+        }
+        _from = from;
+        _size = min(_window, to - from + 1);
+        if (_from + _size > to)
+            m_retryRanges.erase(it);
+        else
+        {
+            it->first = _from + _size;
+            it->second = to - it->first + 1;
         }
+        return true;
     }
+    return false;
 }
 
 bool SyncMaster::maintainDownloadingQueue()
@@ -398,68 +600,58 @@ bool SyncMaster::maintainDownloadingQueue()
     if (currentNumber >= m_syncStatus->knownHighestNumber)
         return true;
 
-    DownloadingBlockQueue& bq = m_syncStatus->bq();
-
-    // pop block in sequence and ignore block which number is lower than currentNumber +1
-    BlockPtr topBlock = bq.top();
-    while (topBlock != nullptr && topBlock->header().number() <= (m_blockChain->number() + 1))
+    // check the consecutive blocks against the verified headers or their consensus signatures
+    // in parallel, then execute and commit them in order, the blocks behind are checked while
+    // the sync thread executes
+    DownloadingHeaderChain& headerChain = m_syncStatus->headerChain();
+    BlockPtrVec blocks = popConsecutiveBlocks();
+    while (!blocks.empty())
     {
-        try
+        headerChain.prune();
+        h512s sealers = m_blockChain->sealerList();
+        std::vector<std::future<BlockCheck>> results;
+        for (auto const& block : blocks)
+        {
+            h256 verifiedHash = headerChain.verifiedHash(block->header().number());
+            auto task = std::make_shared<std::packaged_task<BlockCheck()>>(
+                std::bind(&SyncMaster::checkDownloadedBlock, this, block, verifiedHash));
+            results.push_back(task->get_future());
+            m_verifyPool->enqueue([task]() { (*task)(); });
+        }
+        for (size_t i = 0; i < blocks.size(); i++)
         {
-            if (isNewBlock(topBlock))
+            // a check throwing fails the block like a mismatch, the sync thread must survive it
+            BlockCheck check = BlockCheck::Invalid;
+            try
             {
-                auto parentBlock =
-                    m_blockChain->getBlockByNumber(topBlock->blockHeader().number() - 1);
-                BlockInfo parentBlockInfo{parentBlock->header().hash(),
-                    parentBlock->header().number(), parentBlock->header().stateRoot()};
-                ExecutiveContext::Ptr exeCtx =
-                    m_blockVerifier->executeBlock(*topBlock, parentBlockInfo);
-                CommitResult ret = m_blockChain->commitBlock(*topBlock, exeCtx);
-                if (ret == CommitResult::OK)
-                {
-                    m_txPool->dropBlockTrans(*topBlock);
-                    SYNC_LOG(DEBUG) << LOG_BADGE("Download") << LOG_BADGE("BlockSync")
-                                    << LOG_DESC("Download block commit")
-                                    << LOG_KV("number", topBlock->header().number())
-                                    << LOG_KV("txs", topBlock->transactions().size())
-                                    << LOG_KV("hash", topBlock->headerHash().abridged());
-                }
-                else
-                {
-                    SYNC_LOG(TRACE) << LOG_BADGE("Download") << LOG_BADGE("BlockSync")
-                                    << LOG_DESC("Block commit failed")
-                                    << LOG_KV("number", topBlock->header().number())
-                                    << LOG_KV("txs", topBlock->transactions().size())
-                                    << LOG_KV("hash", topBlock->headerHash().abridged());
-                }
+                check = results[i].get();
             }
-            else
+            catch (std::exception const& e)
             {
-                SYNC_LOG(DEBUG) << LOG_BADGE("Download") << LOG_BADGE("BlockSync")
-                                << LOG_DESC("Block of queue top is not new block")
-                                << LOG_KV("number", topBlock->header().number())
-                                << LOG_KV("txs", topBlock->transactions().size())
-                                << LOG_KV("hash", topBlock->headerHash().abridged());
+                SYNC_LOG(WARNING) << LOG_BADGE("Download") << LOG_BADGE("BlockSync")
+                                  << LOG_DESC("Check downloaded block failed")
+                                  << LOG_KV("number", blocks[i]->header().number())
+                                  << LOG_KV("errorInfo", e.what());
             }
+            if (check == BlockCheck::Invalid)
+            {
+                // the blocks behind can't be imported without this one, request them again
+                int64_t number = blocks[i]->header().number();
+                m_retryRanges.emplace_back(number, blocks.size() - i);
+                SYNC_LOG(WARNING) << LOG_BADGE("Download") << LOG_BADGE("BlockSync")
+                                  << LOG_DESC("Drop block failing the verification")
+                                  << LOG_KV("number", number)
+                                  << LOG_KV("hash", blocks[i]->headerHash().abridged());
+                break;
+            }
+            /// the sealers of the blocks behind change with the block importing the sealers
+            bool verified = check == BlockCheck::Verified && m_blockChain->sealerList() == sealers;
+            importDownloadedBlock(blocks[i], verified);
         }
-        catch (exception& e)
-        {
-            SYNC_LOG(ERROR) << LOG_BADGE("Download") << LOG_BADGE("BlockSync")
-                            << LOG_DESC("Block of queue top is not a valid block")
-                            << LOG_KV("number", topBlock->header().number())
-                            << LOG_KV("txs", topBlock->transactions().size())
-                            << LOG_KV("hash", topBlock->headerHash().abridged());
-        }
-
-        bq.pop();
-        topBlock = bq.top();
+        blocks = popConsecutiveBlocks();
     }
 
-
     currentNumber = m_blockChain->number();
-    // has this request turn finished ?
-    if (currentNumber >= m_maxRequestNumber)
-        m_lastDownloadingRequestTime = 0;  // reset it to trigger request immediately
 
     // has download finished ?
     if (currentNumber >= m_syncStatus->knownHighestNumber)
@@ -483,6 +675,34 @@ bool SyncMaster::maintainDownloadingQueue()
     return false;
 }
 
+SyncMaster::BlockCheck SyncMaster::checkDownloadedBlock(BlockPtr _block, h256 const& _verifiedHash)
+{
+    if (!_verifiedHash)
+    {
+        bool verified = !fp_isConsensusOk || fp_isConsensusOk(*_block);
+        return verified ? BlockCheck::Verified : BlockCheck::Unverified;
+    }
+    if (_block->headerHash() != _verifiedHash)
+        return BlockCheck::Invalid;
+    // the transactions must be the ones the verified header commits to
+    h256 txsRoot = _block->header().transactionsRoot();
+    _block->calTransactionRoot();
+    if (_block->header().transactionsRoot() != txsRoot)
+        return BlockCheck::Invalid;
+    return BlockCheck::Verified;
+}
+
+void SyncMaster::maintainSnapshot()
+{
+    if (!m_snapshotSync->maintain(m_syncStatus->peers()))
+        return;
+    /// sync the blocks after the checkpoint, or all the blocks if the snapshot sync failed
+    m_syncStatus->state = SyncState::Idle;
+    SYNC_LOG(INFO) << LOG_BADGE("Snapshot") << LOG_DESC("Snapshot sync over")
+                   << LOG_KV("succeeded", m_snapshotSync->succeeded())
+                   << LOG_KV("number", m_blockChain->number());
+}
+
 void SyncMaster::maintainPeersConnection()
 {
     // Get active peers
@@ -492,6 +712,12 @@ void SyncMaster::maintainPeersConnection()
     {
         activePeers.insert(session.nodeID);
     }
+    // Release the known-by records of the disconnected peers for reuse, keep the record of myself
+    // which marks the broadcasted transactions
+    maintainAnnouncedTransactions(activePeers);
+    set<NodeID> knownByPeers = activePeers;
+    knownByPeers.insert(m_nodeId);
+    m_txPool->removeInactivePeers(knownByPeers);
 
     // Get sealers and observer
     NodeIDs sealers = m_blockChain->sealerList();
@@ -580,72 +806,88 @@ void SyncMaster::maintainDownloadingQueueBuffer()
 
 void SyncMaster::maintainBlockRequest()
 {
-    uint64_t timeout = utcTime() + c_respondDownloadRequestTimeout;
-    m_syncStatus->foreachPeerRandom([&](std::shared_ptr<SyncPeerStatus> _p) {
-        DownloadRequestQueue& reqQueue = _p->reqQueue;
-        if (reqQueue.empty())
-            return true;  // no need to respeond
-
-        // Just select one peer per maintain
-        reqQueue.disablePush();  // drop push at this time
-        DownloadBlocksContainer blockContainer(m_service, m_protocolId, _p->nodeId);
+    m_blockResponder->maintain();
+}
 
-        while (!reqQueue.empty() && utcTime() <= timeout)
+BlockPtrVec SyncMaster::popConsecutiveBlocks()
+{
+    DownloadingBlockQueue& bq = m_syncStatus->bq();
+    BlockPtrVec blocks;
+    int64_t nextNumber = m_blockChain->number() + 1;
+    // pop block in sequence and ignore block which number is lower than the expected one
+    BlockPtr topBlock = bq.top();
+    while (topBlock != nullptr && topBlock->header().number() <= nextNumber &&
+           blocks.size() < c_maxVerifyingBlocks)
+    {
+        if (topBlock->header().number() == nextNumber)
+        {
+            blocks.push_back(topBlock);
+            nextNumber++;
+        }
+        else
         {
-            DownloadRequest req = reqQueue.topAndPop();
-            int64_t number = req.fromNumber;
-            int64_t numberLimit = req.fromNumber + req.size;
+            SYNC_LOG(DEBUG) << LOG_BADGE("Download") << LOG_BADGE("BlockSync")
+                            << LOG_DESC("Block of queue top is not new block")
+                            << LOG_KV("number", topBlock->header().number())
+                            << LOG_KV("txs", topBlock->transactions().size())
+                            << LOG_KV("hash", topBlock->headerHash().abridged());
+        }
+        bq.pop();
+        topBlock = bq.top();
+    }
+    return blocks;
+}
 
-            // Send block at sequence
-            for (; number < numberLimit && utcTime() <= timeout; number++)
+void SyncMaster::importDownloadedBlock(BlockPtr _block, bool _consensusVerified)
+{
+    try
+    {
+        if (isNewBlock(_block, _consensusVerified))
+        {
+            auto parentBlock = m_blockChain->getBlockByNumber(_block->blockHeader().number() - 1);
+            BlockInfo parentBlockInfo{parentBlock->header().hash(), parentBlock->header().number(),
+                parentBlock->header().stateRoot()};
+            ExecutiveContext::Ptr exeCtx = m_blockVerifier->executeBlock(*_block, parentBlockInfo);
+            CommitResult ret = m_blockChain->commitBlock(*_block, exeCtx);
+            if (ret == CommitResult::OK)
             {
-                shared_ptr<Block> block = m_blockChain->getBlockByNumber(number);
-                if (!block)
-                {
-                    SYNC_LOG(TRACE) << LOG_BADGE("Download") << LOG_BADGE("Request")
-                                    << LOG_DESC("Get block for node failed")
-                                    << LOG_KV("reason", "block is null") << LOG_KV("number", number)
-                                    << LOG_KV("nodeId", _p->nodeId.abridged());
-                    break;
-                }
-                else if (block->header().number() != number)
-                {
-                    SYNC_LOG(TRACE)
-                        << LOG_BADGE("Download") << LOG_BADGE("Request")
-                        << LOG_DESC("Get block for node failed")
-                        << LOG_KV("reason", "number incorrect") << LOG_KV("number", number)
-                        << LOG_KV("nodeId", _p->nodeId.abridged());
-                    break;
-                }
-
-                blockContainer.batchAndSend(block);
+                m_catchUpBlocks++;
+                m_txPool->dropBlockTrans(*_block);
+                SYNC_LOG(DEBUG) << LOG_BADGE("Download") << LOG_BADGE("BlockSync")
+                                << LOG_DESC("Download block commit")
+                                << LOG_KV("number", _block->header().number())
+                                << LOG_KV("txs", _block->transactions().size())
+                                << LOG_KV("hash", _block->headerHash().abridged());
             }
-
-            if (req.fromNumber < number)
-                SYNC_LOG(DEBUG) << LOG_BADGE("Download") << LOG_BADGE("Request")
-                                << LOG_BADGE("BlockSync") << LOG_DESC("Send blocks")
-                                << LOG_KV("from", req.fromNumber) << LOG_KV("to", number - 1)
-                                << LOG_KV("peer", _p->nodeId.abridged());
-
-            if (number < numberLimit)  // This respond not reach the end due to timeout
+            else
             {
-                // write back the rest request range
-                reqQueue.enablePush();
-                SYNC_LOG(DEBUG) << LOG_BADGE("Download") << LOG_BADGE("Request")
-                                << LOG_DESC("Push unsent requests back to reqQueue")
-                                << LOG_KV("from", number) << LOG_KV("to", numberLimit - 1)
-                                << LOG_KV("peer", _p->nodeId.abridged());
-                reqQueue.push(number, numberLimit - number);
-                return false;
+                SYNC_LOG(TRACE) << LOG_BADGE("Download") << LOG_BADGE("BlockSync")
+                                << LOG_DESC("Block commit failed")
+                                << LOG_KV("number", _block->header().number())
+                                << LOG_KV("txs", _block->transactions().size())
+                                << LOG_KV("hash", _block->headerHash().abridged());
             }
         }
-
-        reqQueue.enablePush();
-        return false;
-    });
+        else
+        {
+            SYNC_LOG(DEBUG) << LOG_BADGE("Download") << LOG_BADGE("BlockSync")
+                            << LOG_DESC("Block of queue top is not new block")
+                            << LOG_KV("number", _block->header().number())
+                            << LOG_KV("txs", _block->transactions().size())
+                            << LOG_KV("hash", _block->headerHash().abridged());
+        }
+    }
+    catch (exception& e)
+    {
+        SYNC_LOG(ERROR) << LOG_BADGE("Download") << LOG_BADGE("BlockSync")
+                        << LOG_DESC("Block of queue top is not a valid block")
+                        << LOG_KV("number", _block->header().number())
+                        << LOG_KV("txs", _block->transactions().size())
+                        << LOG_KV("hash", _block->headerHash().abridged());
+    }
 }
 
-bool SyncMaster::isNewBlock(BlockPtr _block)
+bool SyncMaster::isNewBlock(BlockPtr _block, bool _consensusVerified)
 {
     if (_block == nullptr)
         return false;
@@ -673,8 +915,8 @@ bool SyncMaster::isNewBlock(BlockPtr _block)
         return false;
     }
 
-    // check block sealerlist sig
-    if (fp_isConsensusOk && !(fp_isConsensusOk)(*_block))
+    // check block sealerlist sig, unless it has been checked with the current sealers
+    if (!_consensusVerified && fp_isConsensusOk && !(fp_isConsensusOk)(*_block))
     {
         SYNC_LOG(ERROR) << LOG_BADGE("Download") << LOG_BADGE("BlockSync")
                         << LOG_DESC("Ignore illegal block")
@@ -21,8 +21,10 @@
  */
 
 #pragma once
+#include "BlockResponder.h"
 #include "Common.h"
 #include "RspBlockReq.h"
+#include "SnapshotSync.h"
 #include "SyncInterface.h"
 #include "SyncMsgEngine.h"
 #include "SyncStatus.h"
@@ -30,6 +32,7 @@
 #include <libblockchain/BlockChainInterface.h>
 #include <libblockverifier/BlockVerifierInterface.h>
 #include <libdevcore/FixedHash.h>
+#include <libdevcore/ThreadPool.h>
 #include <libdevcore/Worker.h>
 #include <libethcore/Common.h>
 #include <libethcore/Exceptions.h>
@@ -37,6 +40,8 @@
 #include <libnetwork/Session.h>
 #include <libp2p/P2PInterface.h>
 #include <libtxpool/TxPoolInterface.h>
+#include <atomic>
+#include <deque>
 #include <vector>
 
 
@@ -52,7 +57,7 @@ public:
         std::shared_ptr<dev::blockchain::BlockChainInterface> _blockChain,
         std::shared_ptr<dev::blockverifier::BlockVerifierInterface> _blockVerifier,
         PROTOCOL_ID const& _protocolId, NodeID const& _nodeId, h256 const& _genesisHash,
-        unsigned _idleWaitMs = 200)
+        unsigned _idleWaitMs = 200, bool _announceTransactions = false)
       : SyncInterface(),
         Worker("SyncMaster-" + std::to_string(_protocolId), _idleWaitMs),
         m_service(_service),
@@ -61,17 +66,26 @@ public:
         m_blockVerifier(_blockVerifier),
         m_protocolId(_protocolId),
         m_nodeId(_nodeId),
-        m_genesisHash(_genesisHash)
+        m_genesisHash(_genesisHash),
+        m_announceTransactions(_announceTransactions)
     {
         m_syncStatus =
             std::make_shared<SyncMasterStatus>(_blockChain, _protocolId, _genesisHash, _nodeId);
         m_msgEngine = std::make_shared<SyncMsgEngine>(
             _service, _txPool, _blockChain, m_syncStatus, _protocolId, _nodeId, _genesisHash);
+        m_blockResponder = std::make_shared<BlockResponder>(
+            _service, _blockChain, m_syncStatus, _protocolId, _nodeId);
+        m_msgEngine->setBlockResponder(m_blockResponder);
 
         // signal registration
         m_tqReady = m_txPool->onReady([&]() { this->noteNewTransactions(); });
         m_blockSubmitted = m_blockChain->onReady([&](int64_t) { this->noteNewBlocks(); });
         m_groupId = dev::eth::getGroupAndProtocol(m_protocolId).first;
+        /// decode and verify the downloaded blocks ahead of the sync thread executing them
+        m_verifyPool = std::make_shared<dev::ThreadPool>(
+            "SyncVerify-" + std::to_string(m_groupId), c_syncVerifyThreadNum);
+        m_syncStatus->bq().setDecodePool(m_verifyPool);
+        m_syncStatus->headerChain().setVerifyPool(m_verifyPool);
     }
 
     virtual ~SyncMaster() { stop(); };
@@ -101,6 +115,7 @@ public:
         std::function<bool(dev::eth::Block const&)> _handler) override
     {
         fp_isConsensusOk = _handler;
+        m_syncStatus->headerChain().setConsensusVerifyHandler(_handler);
     };
 
     void noteNewTransactions()
@@ -118,15 +133,30 @@ public:
     void noteDownloadingBegin()
     {
         if (m_syncStatus->state == SyncState::Idle)
+        {
             m_syncStatus->state = SyncState::Downloading;
+            m_catchUpBeginTime = utcTime();
+            m_catchUpEndTime = 0;
+            m_catchUpBlocks = 0;
+        }
     }
 
     void noteDownloadingFinish()
     {
         if (m_syncStatus->state == SyncState::Downloading)
+        {
             m_syncStatus->state = SyncState::Idle;
+            m_catchUpEndTime = utcTime();
+        }
     }
 
+    /// blocks imported per second by the current catch-up, or the last one if not syncing
+    double catchUpBlocksPerSecond() const;
+
+    /// serve the snapshots taken by the storage, and download the snapshot of a checkpoint
+    /// instead of replaying the blocks from genesis if fast sync is enabled
+    void setSnapshotStorage(dev::storage::LevelDBStorage::Ptr _storage, bool _fastSync);
+
     int64_t protocolId() { return m_protocolId; }
 
     NodeID nodeId() { return m_nodeId; }
@@ -150,15 +180,24 @@ private:
     std::shared_ptr<SyncMasterStatus> m_syncStatus;
     /// Message handler of p2p
     std::shared_ptr<SyncMsgEngine> m_msgEngine;
+    /// serve the headers and blocks requested by the peers
+    BlockResponder::Ptr m_blockResponder;
 
     // Internal data
     PROTOCOL_ID m_protocolId;
     GROUP_ID m_groupId;
     NodeID m_nodeId;  ///< Nodeid of this node
     h256 m_genesisHash;
+    /// broadcast transaction hashes and let peers request the bodies they lack
+    bool m_announceTransactions = false;
+    /// the transaction hashes recently announced to each peer with the announcing time
+    std::map<NodeID, std::deque<std::pair<uint64_t, std::vector<h256>>>> m_announcedTxs;
 
-    int64_t m_maxRequestNumber = 0;
-    uint64_t m_lastDownloadingRequestTime = 0;
+    /// the next block not requested yet, and the ranges to request again
+    int64_t m_nextRequestNumber = 0;
+    std::deque<std::pair<int64_t, int64_t>> m_retryRanges;
+    /// the time of the headers request in flight, 0 if none
+    uint64_t m_headersRequestTime = 0;
     int64_t m_currentSealingNumber = 0;
 
     // Internal coding variable
@@ -184,17 +223,52 @@ private:
     // verify handler to check downloading block
     std::function<bool(dev::eth::Block const&)> fp_isConsensusOk = nullptr;
 
+    /// thread pool decoding the downloaded blocks and checking their consensus signatures
+    std::shared_ptr<dev::ThreadPool> m_verifyPool;
+    /// statistics of the catch-up
+    std::atomic<uint64_t> m_catchUpBeginTime = {0};
+    std::atomic<uint64_t> m_catchUpEndTime = {0};
+    std::atomic<uint64_t> m_catchUpBlocks = {0};
+
+    /// thread pool reading the snapshot chunks requested by the peers
+    std::shared_ptr<dev::ThreadPool> m_snapshotPool;
+    /// downloading the snapshot if the node starts from genesis with fast sync enabled
+    SnapshotSync::Ptr m_snapshotSync;
+
 public:
     void maintainTransactions();
+    void announceTransactions(dev::eth::Transactions const& _ts);
+    /// forget the transactions announced to the disconnected peers, so they are announced again
+    void maintainAnnouncedTransactions(std::set<NodeID> const& _activePeers);
     void maintainBlocks();
     void maintainPeersStatus();
     bool maintainDownloadingQueue();  /// return true if downloading finish
+    void maintainSnapshot();
     void maintainDownloadingQueueBuffer();
     void maintainPeersConnection();
     void maintainBlockRequest();
 
 private:
-    bool isNewBlock(BlockPtr _block);
+    enum class BlockCheck
+    {
+        Verified,    ///< Matches the verified header, or has enough signatures of the sealers
+        Unverified,  ///< Checked again by isNewBlock before importing
+        Invalid      ///< Doesn't match the verified header
+    };
+
+    /// request the headers following the highest verified one from a peer
+    void maintainHeaderRequest(int64_t _maxPeerNumber);
+    /// request the blocks of the verified headers from the idle peers, and any blocks from the
+    /// older peers serving no headers
+    void maintainBodyRequests(int64_t _maxPeerNumber);
+    /// take a range of at most _window blocks the peer has from the retry ranges
+    bool popRetryRange(int64_t _peerNumber, int64_t _window, int64_t& _from, int64_t& _size);
+    BlockCheck checkDownloadedBlock(BlockPtr _block, h256 const& _verifiedHash);
+    bool isNewBlock(BlockPtr _block, bool _consensusVerified = false);
+    /// pop the consecutive blocks following the highest block from the downloading queue
+    BlockPtrVec popConsecutiveBlocks();
+    /// import the block verified ahead if the sealers haven't changed since the verification
+    void importDownloadedBlock(BlockPtr _block, bool _consensusVerified);
     void printSyncInfo();
 };
 
@@ -103,6 +103,30 @@ bool SyncMsgEngine::interpret(SyncMsgPacket const& _packet)
         case ReqBlocskPacket:
             onPeerRequestBlocks(_packet);
             break;
+        case ReqHeadersPacket:
+            onPeerRequestHeaders(_packet);
+            break;
+        case HeadersPacket:
+            onPeerHeaders(_packet);
+            break;
+        case TxsHashesPacket:
+            onPeerTxsHashes(_packet);
+            break;
+        case ReqTxsPacket:
+            onPeerRequestTxs(_packet);
+            break;
+        case ReqSnapshotManifestPacket:
+            onPeerRequestSnapshotManifest(_packet);
+            break;
+        case SnapshotManifestPacket:
+            onPeerSnapshotManifest(_packet);
+            break;
+        case ReqSnapshotChunkPacket:
+            onPeerRequestSnapshotChunk(_packet);
+            break;
+        case SnapshotChunkPacket:
+            onPeerSnapshotChunk(_packet);
+            break;
         default:
             return false;
         }
@@ -171,7 +195,7 @@ void SyncMsgEngine::onPeerStatus(SyncMsgPacket const& _packet)
 
 void SyncMsgEngine::onPeerTransactions(SyncMsgPacket const& _packet)
 {
-    if (m_syncStatus->state == SyncState::Downloading)
+    if (m_syncStatus->state != SyncState::Idle)
     {
         SYNC_LOG(TRACE) << LOG_BADGE("Tx")
                         << LOG_DESC("Drop peer transactions when dowloading blocks")
@@ -220,9 +244,16 @@ void SyncMsgEngine::onPeerTransactions(SyncMsgPacket const& _packet)
                               << LOG_KV("rlp", toHex(rlps[i].toBytes()));
             continue;
         }
-        if (knownTxHash.size() > 0)
+    }
+    if (knownTxHash.size() > 0)
+    {
+        m_txPool->setTransactionsAreKnownBy(knownTxHash, _packet.nodeId);
+        /// the requested transactions have been received
+        Guard l(x_requestedTxs);
+        if (m_requestedTxs.size() > 0)
         {
-            m_txPool->setTransactionsAreKnownBy(knownTxHash, _packet.nodeId);
+            for (auto const& txHash : knownTxHash)
+                m_requestedTxs.erase(txHash);
         }
     }
 
@@ -241,6 +272,9 @@ void SyncMsgEngine::onPeerBlocks(SyncMsgPacket const& _packet)
                     << LOG_KV("packetSize(B)", rlps.data().size());
 
     m_syncStatus->bq().push(rlps);
+    auto peerStatus = m_syncStatus->peerStatus(_packet.nodeId);
+    if (peerStatus)
+        peerStatus->downloadWindow.onBlocks(rlps.itemCount(), rlps.data().size(), utcTime());
 }
 
 void SyncMsgEngine::onPeerRequestBlocks(SyncMsgPacket const& _packet)
@@ -266,13 +300,268 @@ void SyncMsgEngine::onPeerRequestBlocks(SyncMsgPacket const& _packet)
 
     auto peerStatus = m_syncStatus->peerStatus(_packet.nodeId);
     if (peerStatus != nullptr && peerStatus)
+    {
         peerStatus->reqQueue.push(from, (int64_t)size);
+        if (m_blockResponder)
+            m_blockResponder->respond(peerStatus);
+    }
+}
+
+void SyncMsgEngine::onPeerRequestHeaders(SyncMsgPacket const& _packet)
+{
+    RLP const& rlp = _packet.rlp();
+
+    if (rlp.itemCount() != 2)
+    {
+        SYNC_LOG(TRACE) << LOG_BADGE("Download") << LOG_BADGE("Request")
+                        << LOG_DESC("Receive invalid request headers packet format")
+                        << LOG_KV("peer", _packet.nodeId.abridged());
+        return;
+    }
+
+    int64_t from = rlp[0].toInt<int64_t>();
+    unsigned size = min(rlp[1].toInt<unsigned>(), (unsigned)c_maxRequestHeaders);
+
+    SYNC_LOG(TRACE) << LOG_BADGE("Download") << LOG_BADGE("Request")
+                    << LOG_DESC("Receive headers request")
+                    << LOG_KV("peer", _packet.nodeId.abridged()) << LOG_KV("from", from)
+                    << LOG_KV("to", from + size - 1);
+
+    auto peerStatus = m_syncStatus->peerStatus(_packet.nodeId);
+    if (peerStatus)
+    {
+        peerStatus->headersReqQueue.push(from, (int64_t)size);
+        if (m_blockResponder)
+            m_blockResponder->respond(peerStatus);
+    }
+}
+
+void SyncMsgEngine::onPeerHeaders(SyncMsgPacket const& _packet)
+{
+    RLP const& rlps = _packet.rlp();
+
+    SYNC_LOG(DEBUG) << LOG_BADGE("Download") << LOG_BADGE("Headers")
+                    << LOG_DESC("Receive peer headers packet")
+                    << LOG_KV("headers", rlps.itemCount())
+                    << LOG_KV("peer", _packet.nodeId.abridged());
+
+    auto peerStatus = m_syncStatus->peerStatus(_packet.nodeId);
+    if (peerStatus)
+        peerStatus->headersServed = true;
+    m_syncStatus->headerChain().push(_packet.nodeId, rlps);
+}
+
+void SyncMsgEngine::onPeerTxsHashes(SyncMsgPacket const& _packet)
+{
+    if (m_syncStatus->state != SyncState::Idle)
+    {
+        SYNC_LOG(TRACE) << LOG_BADGE("Tx")
+                        << LOG_DESC("Drop peer transaction hashes when dowloading blocks")
+                        << LOG_KV("fromNodeId", _packet.nodeId.abridged());
+        return;
+    }
+
+    RLP const& rlp = _packet.rlp();
+    if (rlp.itemCount() != 1)
+    {
+        SYNC_LOG(TRACE) << LOG_BADGE("Tx") << LOG_DESC("Receive invalid txs hashes packet format")
+                        << LOG_KV("peer", _packet.nodeId.abridged());
+        return;
+    }
+
+    std::vector<h256> txHashes = rlp[0].toVector<h256>();
+    std::vector<h256> knownTxHashes;
+    std::vector<h256> reqTxHashes;
+    uint64_t currentTime = utcTime();
+    {
+        Guard l(x_requestedTxs);
+        if (m_requestedTxs.size() > c_maxRequestedTransactions)
+            m_requestedTxs.clear();
+        for (auto const& txHash : txHashes)
+        {
+            if (m_txPool->isTransactionInPool(txHash))
+            {
+                knownTxHashes.push_back(txHash);
+                continue;
+            }
+            /// the transaction has been requested from other peer and not timeout
+            auto p = m_requestedTxs.find(txHash);
+            if (p != m_requestedTxs.end() && currentTime - p->second < c_reqTransactionsTimeout)
+                continue;
+            m_requestedTxs[txHash] = currentTime;
+            reqTxHashes.push_back(txHash);
+        }
+    }
+    if (knownTxHashes.size() > 0)
+        m_txPool->setTransactionsAreKnownBy(knownTxHashes, _packet.nodeId);
+
+    SYNC_LOG(DEBUG) << LOG_BADGE("Tx") << LOG_DESC("Receive peer transaction hashes")
+                    << LOG_KV("rcv", txHashes.size()) << LOG_KV("request", reqTxHashes.size())
+                    << LOG_KV("peer", _packet.nodeId.abridged());
+    if (reqTxHashes.size() == 0)
+        return;
+
+    SyncReqTxsPacket packet;
+    packet.encode(reqTxHashes);
+    m_service->asyncSendMessageByNodeID(
+        _packet.nodeId, packet.toMessage(m_protocolId), CallbackFuncWithSession(), Options());
+}
+
+void SyncMsgEngine::onPeerRequestTxs(SyncMsgPacket const& _packet)
+{
+    RLP const& rlp = _packet.rlp();
+    if (rlp.itemCount() != 1)
+    {
+        SYNC_LOG(TRACE) << LOG_BADGE("Tx") << LOG_DESC("Receive invalid request txs packet format")
+                        << LOG_KV("peer", _packet.nodeId.abridged());
+        return;
+    }
+
+    std::vector<h256> txHashes = rlp[0].toVector<h256>();
+    /// a request never takes more than an announcement of the hashes
+    if (txHashes.size() > c_maxAnnounceTransactions)
+        txHashes.resize(c_maxAnnounceTransactions);
+    Transactions txs = m_txPool->transactionsByHash(txHashes);
+    SYNC_LOG(DEBUG) << LOG_BADGE("Tx") << LOG_DESC("Receive peer transactions request")
+                    << LOG_KV("request", txHashes.size()) << LOG_KV("found", txs.size())
+                    << LOG_KV("peer", _packet.nodeId.abridged());
+
+    /// the transactions are sent in packets below the message limit
+    bytes txRLPs;
+    size_t txsSize = 0;
+    auto sendTransactions = [&]() {
+        if (txsSize == 0)
+            return;
+        SyncTransactionsPacket packet;
+        packet.encode(txsSize, txRLPs);
+        m_service->asyncSendMessageByNodeID(
+            _packet.nodeId, packet.toMessage(m_protocolId), CallbackFuncWithSession(), Options());
+        txRLPs.clear();
+        txsSize = 0;
+    };
+    for (auto const& tx : txs)
+    {
+        bytes txRLP = tx.rlp();
+        if (txRLPs.size() + txRLP.size() > c_maxPayload)
+            sendTransactions();
+        txRLPs += txRLP;
+        txsSize++;
+    }
+    sendTransactions();
+}
+
+void SyncMsgEngine::onPeerRequestSnapshotManifest(SyncMsgPacket const& _packet)
+{
+    RLP const& rlp = _packet.rlp();
+    if (rlp.itemCount() != 2 || !m_snapshotStorage)
+    {
+        SYNC_LOG(TRACE) << LOG_BADGE("Snapshot")
+                        << LOG_DESC("Ignore request snapshot manifest packet")
+                        << LOG_KV("peer", _packet.nodeId.abridged());
+        return;
+    }
+    int64_t number = rlp[0].toInt<int64_t>();
+    unsigned from = rlp[1].toInt<unsigned>();
+    if (number == c_latestSnapshotNumber)
+    {
+        number = -1;
+    }
+    auto storage = m_snapshotStorage;
+    auto service = m_service;
+    auto protocolId = m_protocolId;
+    NodeID peer = _packet.nodeId;
+    /// the snapshot is cut into chunks the first time, which reads all the data
+    m_snapshotPool->enqueue([storage, service, protocolId, peer, number, from]() {
+        auto snapshot = storage->snapshot(number);
+        if (!snapshot)
+        {
+            return;
+        }
+        std::vector<h256> chunkHashes = snapshot->chunkHashes();
+        if (from >= chunkHashes.size())
+        {
+            return;
+        }
+        size_t to = std::min(chunkHashes.size(), from + c_maxManifestChunkHashes);
+        SyncSnapshotManifestPacket packet;
+        packet.encode(snapshot->number(), snapshot->blockHash(), snapshot->root(),
+            chunkHashes.size(), from,
+            std::vector<h256>(chunkHashes.begin() + from, chunkHashes.begin() + to));
+        service->asyncSendMessageByNodeID(
+            peer, packet.toMessage(protocolId), CallbackFuncWithSession(), Options());
+    });
+}
+
+void SyncMsgEngine::onPeerSnapshotManifest(SyncMsgPacket const& _packet)
+{
+    RLP const& rlp = _packet.rlp();
+    if (rlp.itemCount() != 6 || !m_snapshotSync)
+    {
+        SYNC_LOG(TRACE) << LOG_BADGE("Snapshot") << LOG_DESC("Ignore snapshot manifest packet")
+                        << LOG_KV("peer", _packet.nodeId.abridged());
+        return;
+    }
+    m_snapshotSync->onManifest(_packet.nodeId, rlp[0].toInt<int64_t>(), rlp[1].toHash<h256>(),
+        rlp[2].toHash<h256>(), rlp[3].toInt<unsigned>(), rlp[4].toInt<unsigned>(),
+        rlp[5].toVector<h256>());
+}
+
+void SyncMsgEngine::onPeerRequestSnapshotChunk(SyncMsgPacket const& _packet)
+{
+    RLP const& rlp = _packet.rlp();
+    if (rlp.itemCount() != 2 || !m_snapshotStorage)
+    {
+        SYNC_LOG(TRACE) << LOG_BADGE("Snapshot") << LOG_DESC("Ignore request snapshot chunk packet")
+                        << LOG_KV("peer", _packet.nodeId.abridged());
+        return;
+    }
+    int64_t number = rlp[0].toInt<int64_t>();
+    unsigned index = rlp[1].toInt<unsigned>();
+    auto snapshot = m_snapshotStorage->snapshot(number);
+    if (!snapshot)
+    {
+        SYNC_LOG(DEBUG) << LOG_BADGE("Snapshot") << LOG_DESC("Requested snapshot not kept")
+                        << LOG_KV("number", number) << LOG_KV("peer", _packet.nodeId.abridged());
+        return;
+    }
+    auto service = m_service;
+    auto protocolId = m_protocolId;
+    NodeID peer = _packet.nodeId;
+    m_snapshotPool->enqueue([snapshot, service, protocolId, peer, number, index]() {
+        bytes chunk = snapshot->chunk(index);
+        if (chunk.empty() || chunk.size() > c_maxPayload)
+        {
+            return;
+        }
+        SyncSnapshotChunkPacket packet;
+        packet.encode(number, index, chunk);
+        service->asyncSendMessageByNodeID(
+            peer, packet.toMessage(protocolId), CallbackFuncWithSession(), Options());
+    });
+}
+
+void SyncMsgEngine::onPeerSnapshotChunk(SyncMsgPacket const& _packet)
+{
+    RLP const& rlp = _packet.rlp();
+    if (rlp.itemCount() != 3 || !m_snapshotSync)
+    {
+        SYNC_LOG(TRACE) << LOG_BADGE("Snapshot") << LOG_DESC("Ignore snapshot chunk packet")
+                        << LOG_KV("peer", _packet.nodeId.abridged());
+        return;
+    }
+    m_snapshotSync->onChunk(_packet.nodeId, rlp[0].toInt<int64_t>(), rlp[1].toInt<unsigned>(),
+        rlp[2].toBytesConstRef());
 }
 
 void DownloadBlocksContainer::batchAndSend(BlockPtr _block)
+{
+    batchAndSend(_block->rlp());
+}
+
+void DownloadBlocksContainer::batchAndSend(bytes&& _blockRLP)
 {
     // TODO: thread safe
-    bytes blockRLP = _block->rlp();
+    bytes blockRLP = std::move(_blockRLP);
 
     if (blockRLP.size() > c_maxPayload)
     {
@@ -285,8 +574,8 @@ void DownloadBlocksContainer::batchAndSend(BlockPtr _block)
         clearBatchAndSend();
 
     // emplace back block in batch
-    m_blockRLPsBatch.emplace_back(blockRLP);
     m_currentBatchSize += blockRLP.size();
+    m_blockRLPsBatch.emplace_back(std::move(blockRLP));
 }
 
 void DownloadBlocksContainer::clearBatchAndSend()
@@ -21,18 +21,22 @@
  */
 
 #pragma once
+#include "BlockResponder.h"
 #include "Common.h"
 #include "RspBlockReq.h"
+#include "SnapshotSync.h"
 #include "SyncMsgPacket.h"
 #include "SyncStatus.h"
 #include <libblockchain/BlockChainInterface.h>
 #include <libdevcore/FixedHash.h>
+#include <libdevcore/ThreadPool.h>
 #include <libdevcore/Worker.h>
 #include <libethcore/Exceptions.h>
 #include <libnetwork/Common.h>
 #include <libnetwork/Session.h>
 #include <libp2p/P2PInterface.h>
 #include <libp2p/P2PMessage.h>
+#include <libstorage/LevelDBStorage.h>
 #include <libtxpool/TxPoolInterface.h>
 
 namespace dev
@@ -63,6 +67,20 @@ public:
     void messageHandler(dev::p2p::NetworkException _e,
         std::shared_ptr<dev::p2p::P2PSession> _session, dev::p2p::P2PMessage::Ptr _msg);
 
+    /// serve the snapshots of the storage, the chunks are read by the pool
+    void setSnapshotStorage(dev::storage::LevelDBStorage::Ptr _storage, dev::ThreadPool::Ptr _pool)
+    {
+        m_snapshotStorage = _storage;
+        m_snapshotPool = _pool;
+    }
+    /// serve the headers and blocks requested as soon as the requests are received
+    void setBlockResponder(BlockResponder::Ptr _blockResponder)
+    {
+        m_blockResponder = _blockResponder;
+    }
+    /// receive the manifests and chunks of the snapshot being downloaded
+    void setSnapshotSync(SnapshotSync::Ptr _snapshotSync) { m_snapshotSync = _snapshotSync; }
+
 public:
     bool needCheckPacketInGroup = true;
 
@@ -76,6 +94,14 @@ private:
     void onPeerTransactions(SyncMsgPacket const& _packet);
     void onPeerBlocks(SyncMsgPacket const& _packet);
     void onPeerRequestBlocks(SyncMsgPacket const& _packet);
+    void onPeerRequestHeaders(SyncMsgPacket const& _packet);
+    void onPeerHeaders(SyncMsgPacket const& _packet);
+    void onPeerTxsHashes(SyncMsgPacket const& _packet);
+    void onPeerRequestTxs(SyncMsgPacket const& _packet);
+    void onPeerRequestSnapshotManifest(SyncMsgPacket const& _packet);
+    void onPeerSnapshotManifest(SyncMsgPacket const& _packet);
+    void onPeerRequestSnapshotChunk(SyncMsgPacket const& _packet);
+    void onPeerSnapshotChunk(SyncMsgPacket const& _packet);
 
 private:
     // Outside data
@@ -89,6 +115,15 @@ private:
     GROUP_ID m_groupId;
     NodeID m_nodeId;  ///< Nodeid of this node
     h256 m_genesisHash;
+
+    /// transactions requested from peers but not received yet: tx hash => request time
+    Mutex x_requestedTxs;
+    std::unordered_map<h256, uint64_t> m_requestedTxs;
+
+    dev::storage::LevelDBStorage::Ptr m_snapshotStorage;
+    dev::ThreadPool::Ptr m_snapshotPool;
+    SnapshotSync::Ptr m_snapshotSync;
+    BlockResponder::Ptr m_blockResponder;
 };
 
 class DownloadBlocksContainer
@@ -103,6 +138,8 @@ public:
     ~DownloadBlocksContainer() { clearBatchAndSend(); }
 
     void batchAndSend(BlockPtr _block);
+    /// batch the encoded block, which is moved into the batch
+    void batchAndSend(bytes&& _blockRLP);
 
 private:
     void clearBatchAndSend();
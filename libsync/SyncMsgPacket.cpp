@@ -107,3 +107,55 @@ void SyncReqBlockPacket::encode(int64_t _from, unsigned _size)
     m_rlpStream.clear();
     prep(m_rlpStream, ReqBlocskPacket, 2) << _from << _size;
 }
+
+void SyncTxsHashesPacket::encode(std::vector<dev::h256> const& _txHashes)
+{
+    m_rlpStream.clear();
+    prep(m_rlpStream, TxsHashesPacket, 1) << _txHashes;
+}
+
+void SyncReqTxsPacket::encode(std::vector<dev::h256> const& _txHashes)
+{
+    m_rlpStream.clear();
+    prep(m_rlpStream, ReqTxsPacket, 1) << _txHashes;
+}
+
+void SyncReqHeadersPacket::encode(int64_t _from, unsigned _size)
+{
+    m_rlpStream.clear();
+    prep(m_rlpStream, ReqHeadersPacket, 2) << _from << _size;
+}
+
+void SyncHeadersPacket::encode(std::vector<dev::bytes> const& _headerRLPs)
+{
+    m_rlpStream.clear();
+    prep(m_rlpStream, HeadersPacket, _headerRLPs.size());
+    for (bytes const& bs : _headerRLPs)
+        m_rlpStream.appendRaw(bs);
+}
+
+void SyncReqSnapshotManifestPacket::encode(int64_t _number, unsigned _from)
+{
+    m_rlpStream.clear();
+    prep(m_rlpStream, ReqSnapshotManifestPacket, 2) << _number << _from;
+}
+
+void SyncSnapshotManifestPacket::encode(int64_t _number, h256 const& _blockHash,
+    h256 const& _root, unsigned _chunks, unsigned _from, std::vector<dev::h256> const& _chunkHashes)
+{
+    m_rlpStream.clear();
+    prep(m_rlpStream, SnapshotManifestPacket, 6)
+        << _number << _blockHash << _root << _chunks << _from << _chunkHashes;
+}
+
+void SyncReqSnapshotChunkPacket::encode(int64_t _number, unsigned _index)
+{
+    m_rlpStream.clear();
+    prep(m_rlpStream, ReqSnapshotChunkPacket, 2) << _number << _index;
+}
+
+void SyncSnapshotChunkPacket::encode(int64_t _number, unsigned _index, bytes const& _chunk)
+{
+    m_rlpStream.clear();
+    prep(m_rlpStream, SnapshotChunkPacket, 3) << _number << _index << _chunk;
+}
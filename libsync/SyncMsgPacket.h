@@ -91,6 +91,70 @@ public:
     void encode(int64_t _from, unsigned _size);
 };
 
+/// announce hashes of the transactions in txpool
+class SyncTxsHashesPacket : public SyncMsgPacket
+{
+public:
+    SyncTxsHashesPacket() { packetType = TxsHashesPacket; }
+    void encode(std::vector<dev::h256> const& _txHashes);
+};
+
+/// request bodies of the announced transactions
+class SyncReqTxsPacket : public SyncMsgPacket
+{
+public:
+    SyncReqTxsPacket() { packetType = ReqTxsPacket; }
+    void encode(std::vector<dev::h256> const& _txHashes);
+};
+
+/// request the headers and the signatures of the blocks in [from, from + size)
+class SyncReqHeadersPacket : public SyncMsgPacket
+{
+public:
+    SyncReqHeadersPacket() { packetType = ReqHeadersPacket; }
+    void encode(int64_t _from, unsigned _size);
+};
+
+/// list of [header, sigList] of the consecutive blocks
+class SyncHeadersPacket : public SyncMsgPacket
+{
+public:
+    SyncHeadersPacket() { packetType = HeadersPacket; }
+    void encode(std::vector<dev::bytes> const& _headerRLPs);
+};
+
+/// [number, from], request the manifest of the snapshot of the checkpoint, or the latest one if
+/// the number is c_latestSnapshotNumber, with the chunk hashes from the given index
+class SyncReqSnapshotManifestPacket : public SyncMsgPacket
+{
+public:
+    SyncReqSnapshotManifestPacket() { packetType = ReqSnapshotManifestPacket; }
+    void encode(int64_t _number, unsigned _from);
+};
+
+/// [number, blockHash, root, chunks, from, chunkHashes]
+class SyncSnapshotManifestPacket : public SyncMsgPacket
+{
+public:
+    SyncSnapshotManifestPacket() { packetType = SnapshotManifestPacket; }
+    void encode(int64_t _number, h256 const& _blockHash, h256 const& _root, unsigned _chunks,
+        unsigned _from, std::vector<dev::h256> const& _chunkHashes);
+};
+
+class SyncReqSnapshotChunkPacket : public SyncMsgPacket
+{
+public:
+    SyncReqSnapshotChunkPacket() { packetType = ReqSnapshotChunkPacket; }
+    void encode(int64_t _number, unsigned _index);
+};
+
+class SyncSnapshotChunkPacket : public SyncMsgPacket
+{
+public:
+    SyncSnapshotChunkPacket() { packetType = SnapshotChunkPacket; }
+    void encode(int64_t _number, unsigned _index, bytes const& _chunk);
+};
+
 
 }  // namespace sync
 }  // namespace dev
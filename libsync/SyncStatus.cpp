@@ -186,4 +186,87 @@ NodeIDs SyncMasterStatus::randomSelectionSize(
         allowed.erase(allowed.begin() + n);
     }
     return chosen;
-}
\ No newline at end of file
+}
+
+/// weight of the latest sample in the moving averages
+static double const c_sampleWeight = 0.25;
+
+void PeerDownloadWindow::request(int64_t _from, int64_t _size, uint64_t _now)
+{
+    Guard l(x_window);
+    m_from = _from;
+    m_size = _size;
+    m_received = 0;
+    m_requestTime = _now;
+}
+
+void PeerDownloadWindow::onBlocks(size_t _blocks, size_t _bytes, uint64_t _now)
+{
+    if (_blocks == 0)
+        return;
+    Guard l(x_window);
+    double blockSize = (double)_bytes / _blocks;
+    m_blockSize = m_blockSize == 0 ?
+                      blockSize :
+                      (1 - c_sampleWeight) * m_blockSize + c_sampleWeight * blockSize;
+
+    if (m_size == 0)
+        return;
+    m_received += _blocks;
+    if (m_received < m_size)
+        return;
+
+    // the range clipped by the highest number says nothing about the peer
+    if (m_size >= m_window)
+    {
+        uint64_t elapsed = std::max(_now - m_requestTime, (uint64_t)1);
+        double throughput = (double)m_size * 1000 / elapsed;
+        m_throughput = m_throughput == 0 ?
+                           throughput :
+                           (1 - c_sampleWeight) * m_throughput + c_sampleWeight * throughput;
+        int64_t window = m_throughput * c_bodyRequestTargetTime / 1000;
+        m_window = std::min(std::max(window, (int64_t)1), c_maxBodyRequestWindow);
+    }
+    m_size = 0;
+}
+
+bool PeerDownloadWindow::checkTimeout(uint64_t _now, int64_t& _from, int64_t& _size)
+{
+    Guard l(x_window);
+    if (m_size == 0)
+        return false;
+    uint64_t expected = m_throughput == 0 ? 0 : m_size * 1000 / m_throughput;
+    if (_now - m_requestTime <= std::max(c_minBodyRequestTimeout, expected * 4))
+        return false;
+
+    _from = m_from + m_received;
+    _size = m_size - m_received;
+    m_size = 0;
+    m_window = std::max(m_window / 2, (int64_t)1);
+    m_throughput /= 2;
+    return true;
+}
+
+bool PeerDownloadWindow::idle() const
+{
+    Guard l(x_window);
+    return m_size == 0;
+}
+
+int64_t PeerDownloadWindow::window() const
+{
+    Guard l(x_window);
+    return m_window;
+}
+
+double PeerDownloadWindow::throughput() const
+{
+    Guard l(x_window);
+    return m_throughput;
+}
+
+size_t PeerDownloadWindow::blockSize() const
+{
+    Guard l(x_window);
+    return m_blockSize;
+}
@@ -22,6 +22,7 @@
 #pragma once
 #include "Common.h"
 #include "DownloadingBlockQueue.h"
+#include "DownloadingHeaderChain.h"
 #include "RspBlockReq.h"
 #include <libblockchain/BlockChainInterface.h>
 #include <libdevcore/FixedHash.h>
@@ -31,6 +32,7 @@
 #include <libnetwork/Session.h>
 #include <libp2p/P2PInterface.h>
 #include <libtxpool/TxPoolInterface.h>
+#include <atomic>
 #include <map>
 #include <queue>
 #include <set>
@@ -50,6 +52,37 @@ struct SyncStatus
     h256 knownLatestHash;
 };
 
+/// The blocks requested from a peer are as many as it's measured to send in
+/// c_bodyRequestTargetTime, with one request in flight at a time
+class PeerDownloadWindow
+{
+public:
+    /// note the request sent to the peer
+    void request(int64_t _from, int64_t _size, uint64_t _now);
+    /// note the blocks received from the peer
+    void onBlocks(size_t _blocks, size_t _bytes, uint64_t _now);
+    /// @returns true and the range not received if the request in flight timed out
+    bool checkTimeout(uint64_t _now, int64_t& _from, int64_t& _size);
+
+    bool idle() const;
+    /// blocks to request next time
+    int64_t window() const;
+    /// blocks received per second, 0 if not measured
+    double throughput() const;
+    /// average bytes of the blocks received, 0 if not measured
+    size_t blockSize() const;
+
+private:
+    mutable Mutex x_window;
+    int64_t m_from = 0;
+    int64_t m_size = 0;
+    int64_t m_received = 0;
+    uint64_t m_requestTime = 0;
+    int64_t m_window = c_maxRequestBlocks;
+    double m_throughput = 0;
+    double m_blockSize = 0;
+};
+
 class SyncPeerStatus
 {
 public:
@@ -59,14 +92,16 @@ public:
         number(_number),
         genesisHash(_genesisHash),
         latestHash(_latestHash),
-        reqQueue(_nodeId)
+        reqQueue(_nodeId),
+        headersReqQueue(_nodeId)
     {}
     SyncPeerStatus(const SyncPeerInfo& _info, PROTOCOL_ID)
       : nodeId(_info.nodeId),
         number(_info.number),
         genesisHash(_info.genesisHash),
         latestHash(_info.latestHash),
-        reqQueue(_info.nodeId)
+        reqQueue(_info.nodeId),
+        headersReqQueue(_info.nodeId)
     {}
 
     void update(const SyncPeerInfo& _info)
@@ -83,7 +118,24 @@ public:
     h256 genesisHash;
     h256 latestHash;
     DownloadRequestQueue reqQueue;
+    DownloadRequestQueue headersReqQueue;
+    /// the requests of the peer are being served by the responder
+    std::atomic<bool> responding = {false};
+    RespondBandwidth respondBandwidth;
+    PeerDownloadWindow downloadWindow;
     bool isSealer = false;
+    /// the peer has sent headers, set by the network thread
+    std::atomic<bool> headersServed = {false};
+    /// the time the headers were first requested from the peer, 0 if never
+    uint64_t headersRequestTime = 0;
+
+    /// an older peer never answers the headers requests, only its block bodies are requested and
+    /// checked by their signatures
+    bool bodyOnly(uint64_t _now) const
+    {
+        return !headersServed && headersRequestTime != 0 &&
+               _now - headersRequestTime >= c_headersRequestTimeout;
+    }
 };
 
 class SyncMasterStatus
@@ -96,7 +148,8 @@ public:
         knownLatestHash(_genesisHash),
         m_protocolId(_protocolId),
         m_nodeId(_nodeId),
-        m_downloadingBlockQueue(_blockChain, _protocolId, _nodeId)
+        m_downloadingBlockQueue(_blockChain, _protocolId, _nodeId),
+        m_headerChain(_blockChain, _protocolId, _nodeId)
     {
         m_groupId = dev::eth::getGroupAndProtocol(m_protocolId).first;
     }
@@ -107,7 +160,8 @@ public:
         knownLatestHash(_genesisHash),
         m_protocolId(0),
         m_nodeId(0),
-        m_downloadingBlockQueue(nullptr, 0, NodeID())
+        m_downloadingBlockQueue(nullptr, 0, NodeID()),
+        m_headerChain(nullptr, 0, NodeID())
     {}
 
     bool hasPeer(NodeID const& _id);
@@ -133,6 +187,7 @@ public:
         size_t _maxChosenSize, std::function<bool(std::shared_ptr<SyncPeerStatus>)> const& _allow);
 
     DownloadingBlockQueue& bq() { return m_downloadingBlockQueue; }
+    DownloadingHeaderChain& headerChain() { return m_headerChain; }
 
 public:
     h256 genesisHash;
@@ -148,6 +203,7 @@ private:
     mutable SharedMutex x_peerStatus;
     std::map<NodeID, std::shared_ptr<SyncPeerStatus>> m_peersStatus;
     DownloadingBlockQueue m_downloadingBlockQueue;
+    DownloadingHeaderChain m_headerChain;
 };
 
 }  // namespace sync
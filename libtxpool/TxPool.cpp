@@ -30,6 +30,10 @@ namespace dev
 {
 namespace txpool
 {
+/// governance precompiled contracts: SystemConfig, Consensus and Authority
+static std::unordered_set<Address> const c_systemLaneTargets = {
+    Address(0x1000), Address(0x1003), Address(0x1005)};
+
 /**
  * @brief submit a transaction through RPC/web3sdk
  *
@@ -118,7 +122,7 @@ ImportResult TxPool::import(Transaction& _tx, IfDropped)
     _tx.setImportTime(u256(utcTime()));
     UpgradableGuard l(m_lock);
     /// check the txpool size
-    if (m_txsQueue.size() >= m_limit)
+    if (m_txsHash.size() >= m_limit)
         return ImportResult::TransactionPoolIsFull;
     /// check the verify result(nonce && signature check)
     ImportResult verify_ret = verify(_tx);
@@ -144,7 +148,7 @@ void TxPool::verifyAndSetSenderForBlock(dev::eth::Block& block)
         auto p_tx = m_txsHash.find(block.transactions()[i].sha3());
         if (p_tx != m_txsHash.end())
         {
-            block.setSenderForTransaction(i, p_tx->second->sender());
+            block.setSenderForTransaction(i, p_tx->second.tx->sender());
         }
         /// verify the transaction
         else
@@ -220,24 +224,32 @@ bool TxPool::isBlockLimitOrNonceOk(Transaction const& _tx, bool _needInsert) con
 }
 
 /**
- * @brief : remove latest transactions from queue after the transaction queue overloaded
+ * @brief : remove the transaction from the queue
+ * @param _committed : the transaction has been committed in a block
+ * @param _callback : the RPC callback of the transaction is moved out to it if not null
+ *                    (the callback is triggered by notifyReceipts without holding m_lock)
  */
-bool TxPool::removeTrans(h256 const& _txHash, bool needTriggerCallback,
-    dev::eth::LocalisedTransactionReceipt::Ptr pReceipt)
+bool TxPool::removeTrans(h256 const& _txHash, bool _committed, dev::eth::RPCCallback* _callback)
 {
     auto p_tx = m_txsHash.find(_txHash);
     if (p_tx == m_txsHash.end())
     {
         return false;
     }
-    /// trigger callback from RPC
-    /// todo: there is performace problem here,
-    ///       need to use the thread pool to execute this callback
-    if (needTriggerCallback && pReceipt)
+    if (_callback)
+    {
+        *_callback = p_tx->second.tx->rpcCallback();
+    }
+    auto lane = p_tx->second.lane;
+    /// the committed transactions are counted into the wait time of the lane
+    if (_committed)
     {
-        p_tx->second->tiggerRpcCallback(pReceipt);
+        u256 importTime = p_tx->second.tx->importTime();
+        u256 now = u256(utcTime());
+        m_laneCommitted[lane]++;
+        m_laneCommitWait[lane] += (now > importTime ? (uint64_t)(now - importTime) : 0);
     }
-    m_txsQueue.erase(p_tx->second);
+    m_txsQueues[lane].erase(p_tx->second.tx);
     m_txsHash.erase(p_tx);
     return true;
 }
@@ -253,36 +265,52 @@ bool TxPool::insert(Transaction const& _tx)
     {
         return false;
     }
-    TransactionQueue::iterator p_tx = m_txsQueue.emplace(_tx).first;
-    m_txsHash[tx_hash] = p_tx;
+    TxPoolLane lane = laneOf(_tx);
+    TransactionQueue::iterator p_tx = m_txsQueues[lane].emplace(_tx).first;
+    m_txsHash.emplace(std::piecewise_construct, std::forward_as_tuple(tx_hash),
+        std::forward_as_tuple(p_tx, lane));
     return true;
 }
 
+/// the sender of the transaction has been recovered when verifying
+TxPoolLane TxPool::laneOf(Transaction const& _tx) const
+{
+    if (c_systemLaneTargets.count(_tx.receiveAddress()))
+        return SystemLane;
+    if (!m_prioritySenders.empty() && m_prioritySenders.count(_tx.safeSender()))
+        return PrioritySenderLane;
+    return NormalLane;
+}
+
+void TxPool::setPrioritySenders(dev::h160s const& _senders)
+{
+    WriteGuard l(m_lock);
+    m_prioritySenders = std::unordered_set<dev::Address>(_senders.begin(), _senders.end());
+}
+
+void TxPool::setLaneWeights(std::array<uint64_t, LaneCount> const& _weights)
+{
+    WriteGuard l(m_lock);
+    for (size_t lane = 0; lane < LaneCount; lane++)
+        m_laneWeights[lane] = std::max(_weights[lane], (uint64_t)1);
+}
+
 /**
  * @brief Remove bad transaction from the queue
  * @param _txHash: transaction hash
  */
 bool TxPool::drop(h256 const& _txHash)
 {
-    bool succ = false;
-    /// drop transactions
-    {
-        UpgradableGuard l(m_lock);
-        if (m_txsHash.find(_txHash) == m_txsHash.end())
-            return false;
-        UpgradeGuard ul(l);
-        if (m_dropped.size() < m_limit)
-            m_dropped.insert(_txHash);
-        else
-            m_dropped.clear();
-        succ = removeTrans(_txHash);
-    }
-    /// drop information of transactions
-    {
-        WriteGuard l(x_transactionKnownBy);
-        removeTransactionKnowBy(_txHash);
-    }
-    return succ;
+    /// the known-by information is dropped together with the transaction
+    UpgradableGuard l(m_lock);
+    if (m_txsHash.find(_txHash) == m_txsHash.end())
+        return false;
+    UpgradeGuard ul(l);
+    if (m_dropped.size() < m_limit)
+        m_dropped.insert(_txHash);
+    else
+        m_dropped.clear();
+    return removeTrans(_txHash);
 }
 
 dev::eth::LocalisedTransactionReceipt::Ptr TxPool::constructTransactionReceipt(
@@ -295,36 +323,79 @@ dev::eth::LocalisedTransactionReceipt::Ptr TxPool::constructTransactionReceipt(
     return pTxReceipt;
 }
 
-bool TxPool::removeBlockKnowTrans(Block const& block)
+bool TxPool::dropTransactions(Block const& block, bool needNotify)
 {
     if (block.getTransactionSize() == 0)
         return true;
-    WriteGuard l(x_transactionKnownBy);
-    for (auto const& trans : block.transactions())
+    bool succ = true;
+    /// RPC callbacks of the removed transactions with their index in the block
+    std::vector<std::pair<size_t, RPCCallback>> callbacks;
     {
-        removeTransactionKnowBy(trans.sha3());
+        WriteGuard l(m_lock);
+        RPCCallback callback;
+        for (size_t i = 0; i < block.transactions().size(); i++)
+        {
+            callback = nullptr;
+            if (removeTrans(block.transactions()[i].sha3(), true,
+                    needNotify ? &callback : nullptr) == false)
+                succ = false;
+            if (callback)
+                callbacks.emplace_back(i, std::move(callback));
+        }
     }
-    return true;
+    if (callbacks.size() > 0)
+        notifyReceipts(block, callbacks);
+    return succ;
 }
 
-bool TxPool::dropTransactions(Block const& block, bool)
+/**
+ * @brief : deliver the receipts of a committed block to the RPC callbacks in one batch
+ *          the callbacks(channel or websocket push) are called on the notifier threads, the
+ *          batch is dropped if too many batches are waiting(the clients can query the receipts)
+ */
+void TxPool::notifyReceipts(
+    Block const& block, std::vector<std::pair<size_t, RPCCallback>> const& callbacks)
 {
-    if (block.getTransactionSize() == 0)
-        return true;
-    WriteGuard l(m_lock);
-    bool succ = true;
-    for (size_t i = 0; i < block.transactions().size(); i++)
+    using NotifyBatch = std::vector<std::pair<RPCCallback, LocalisedTransactionReceipt::Ptr>>;
+    auto batch = std::make_shared<NotifyBatch>();
+    batch->reserve(callbacks.size());
+    for (auto const& item : callbacks)
+    {
+        if (block.transactionReceipts().size() <= item.first)
+            continue;
+        batch->emplace_back(item.second,
+            constructTransactionReceipt(block.transactions()[item.first],
+                block.transactionReceipts()[item.first], block, item.first));
+    }
+    if (batch->empty())
+        return;
+    if (m_notifyPending >= c_maxPendingNotifyBatches)
     {
-        LocalisedTransactionReceipt::Ptr pReceipt = nullptr;
-        if (block.transactionReceipts().size() > i)
+        m_notifyDropped += batch->size();
+        TXPOOL_LOG(WARNING) << LOG_DESC("notifyReceipts: too many pending batches, drop")
+                            << LOG_KV("blkNum", block.blockHeader().number())
+                            << LOG_KV("pending", m_notifyPending.load())
+                            << LOG_KV("dropped", batch->size());
+        return;
+    }
+    m_notifyPending++;
+    m_notifier->enqueue([this, batch]() {
+        for (auto const& item : *batch)
         {
-            pReceipt = constructTransactionReceipt(
-                block.transactions()[i], block.transactionReceipts()[i], block, i);
+            try
+            {
+                item.first(item.second);
+            }
+            catch (std::exception& e)
+            {
+                TXPOOL_LOG(WARNING) << LOG_DESC("notifyReceipts: callback failed")
+                                    << LOG_KV("hash", item.second->hash().abridged())
+                                    << LOG_KV("EINFO", boost::diagnostic_information(e));
+            }
         }
-        if (removeTrans(block.transactions()[i].sha3(), true, pReceipt) == false)
-            succ = false;
-    }
-    return succ;
+        m_notifyDelivered += batch->size();
+        m_notifyPending--;
+    });
 }
 
 // TODO: drop a block when it has been committed failed
@@ -341,8 +412,6 @@ bool TxPool::dropBlockTrans(Block const& block)
     /// update the nonce check related to block chain
     m_txNonceCheck->updateCache(false);
     bool ret = dropTransactions(block, true);
-    /// remove the information of known transactions from map
-    removeBlockKnowTrans(block);
     /// remove the nonce check related to txpool
     m_commonNonceCheck->delCache(block.transactions());
     return ret;
@@ -371,21 +440,38 @@ Transactions TxPool::topTransactions(uint64_t const& _limit, h256Hash& _avoid, b
     std::vector<dev::eth::NonceKeyType> nonceKeyCache;
     {
         UpgradableGuard l(m_lock);
-        for (auto it = m_txsQueue.begin(); txCnt < limit && it != m_txsQueue.end(); it++)
+        /// weighted round robin among the lanes: in each round a lane contributes at most
+        /// m_laneWeights[lane] transactions, the quota of the empty lanes goes to the others
+        std::array<TransactionQueue::iterator, LaneCount> its;
+        for (size_t lane = 0; lane < LaneCount; lane++)
+            its[lane] = m_txsQueues[lane].begin();
+        bool progressed = true;
+        while (txCnt < limit && progressed)
         {
-            /// check block limit and nonce again when obtain transactions
-            if (false == m_txNonceCheck->isBlockLimitOk(*it))
+            progressed = false;
+            for (size_t lane = 0; lane < LaneCount && txCnt < limit; lane++)
             {
-                invalidBlockLimitTxs.push_back(it->sha3());
-                nonceKeyCache.push_back(m_commonNonceCheck->generateKey(*it));
-                continue;
-            }
-            if (!_avoid.count(it->sha3()))
-            {
-                ret.push_back(*it);
-                txCnt++;
-                if (_updateAvoid)
-                    _avoid.insert(it->sha3());
+                auto& it = its[lane];
+                uint64_t quota = m_laneWeights[lane];
+                for (; quota > 0 && txCnt < limit && it != m_txsQueues[lane].end(); it++)
+                {
+                    progressed = true;
+                    /// check block limit and nonce again when obtain transactions
+                    if (false == m_txNonceCheck->isBlockLimitOk(*it))
+                    {
+                        invalidBlockLimitTxs.push_back(it->sha3());
+                        nonceKeyCache.push_back(m_commonNonceCheck->generateKey(*it));
+                        continue;
+                    }
+                    if (!_avoid.count(it->sha3()))
+                    {
+                        ret.push_back(*it);
+                        txCnt++;
+                        quota--;
+                        if (_updateAvoid)
+                            _avoid.insert(it->sha3());
+                    }
+                }
             }
         }
         if (invalidBlockLimitTxs.size() > 0)
@@ -405,15 +491,10 @@ Transactions TxPool::topTransactions(uint64_t const& _limit, h256Hash& _avoid, b
         }
     }
 
-    if (invalidBlockLimitTxs.size() > 0)
+    for (auto const& txHash : invalidBlockLimitTxs)
     {
-        WriteGuard l(x_transactionKnownBy);
-        for (auto txHash : invalidBlockLimitTxs)
-        {
-            removeTransactionKnowBy(txHash);
-            TXPOOL_LOG(DEBUG) << LOG_DESC("remove imported tx: the block limit expired")
-                              << LOG_KV("hash", txHash.abridged());
-        }
+        TXPOOL_LOG(DEBUG) << LOG_DESC("remove imported tx: the block limit expired")
+                          << LOG_KV("hash", txHash.abridged());
     }
 
     return ret;
@@ -421,23 +502,27 @@ Transactions TxPool::topTransactions(uint64_t const& _limit, h256Hash& _avoid, b
 
 Transactions TxPool::topTransactionsCondition(uint64_t const& _limit, dev::h512 const& _nodeId)
 {
-    ReadGuard l(m_lock);
     Transactions ret;
     uint64_t limit = min(m_limit, _limit);
     uint64_t txCnt = 0;
+    ReadGuard pl(x_peerIndex);
+    size_t index = peerIndex(_nodeId);
 
+    ReadGuard l(m_lock);
+    for (auto const& txsQueue : m_txsQueues)
     {
-        ReadGuard l_kownTrans(x_transactionKnownBy);
-        for (auto it = m_txsQueue.begin(); txCnt < limit && it != m_txsQueue.end(); it++)
+        for (auto it = txsQueue.begin(); txCnt < limit && it != txsQueue.end(); it++)
         {
-            if (!isTransactionKnownBy(it->sha3(), _nodeId))
+            if (index < c_maxKnownByPeers)
             {
-                ret.push_back(*it);
-                txCnt++;
+                auto p_tx = m_txsHash.find(it->sha3());
+                if (p_tx != m_txsHash.end() && p_tx->second.knownBy.test(index))
+                    continue;
             }
+            ret.push_back(*it);
+            txCnt++;
         }
     }
-
     return ret;
 }
 
@@ -446,9 +531,14 @@ Transactions TxPool::pendingList() const
 {
     ReadGuard l(m_lock);
     Transactions ret;
-    for (auto t = m_txsQueue.begin(); t != m_txsQueue.end(); ++t)
+    ret.reserve(m_txsHash.size());
+    /// lanes are listed in priority order, transactions of a lane are listed in import order
+    for (auto const& txsQueue : m_txsQueues)
     {
-        ret.push_back(*t);
+        for (auto t = txsQueue.begin(); t != txsQueue.end(); ++t)
+        {
+            ret.push_back(*t);
+        }
     }
     return ret;
 }
@@ -457,7 +547,7 @@ Transactions TxPool::pendingList() const
 size_t TxPool::pendingSize()
 {
     ReadGuard l(m_lock);
-    return m_txsQueue.size();
+    return m_txsHash.size();
 }
 
 /// @returns the status of the transaction queue.
@@ -465,8 +555,24 @@ TxPoolStatus TxPool::status() const
 {
     TxPoolStatus status;
     ReadGuard l(m_lock);
-    status.current = m_txsQueue.size();
+    status.current = m_txsHash.size();
     status.dropped = m_dropped.size();
+    u256 now = u256(utcTime());
+    for (size_t lane = 0; lane < LaneCount; lane++)
+    {
+        auto const& txsQueue = m_txsQueues[lane];
+        auto& laneStatus = status.lanes[lane];
+        laneStatus.depth = txsQueue.size();
+        /// the queue is ordered by import time
+        if (!txsQueue.empty() && now > txsQueue.begin()->importTime())
+            laneStatus.oldestWait = (uint64_t)(now - txsQueue.begin()->importTime());
+        laneStatus.committed = m_laneCommitted[lane];
+        if (m_laneCommitted[lane] > 0)
+            laneStatus.avgCommitWait = m_laneCommitWait[lane] / m_laneCommitted[lane];
+    }
+    status.notifyPending = m_notifyPending;
+    status.notifyDelivered = m_notifyDelivered;
+    status.notifyDropped = m_notifyDropped;
     return status;
 }
 
@@ -474,45 +580,191 @@ TxPoolStatus TxPool::status() const
 void TxPool::clear()
 {
     WriteGuard l(m_lock);
-    m_txsQueue.clear();
+    for (auto& txsQueue : m_txsQueues)
+        txsQueue.clear();
     m_txsHash.clear();
     m_dropped.clear();
-    WriteGuard l_trans(x_transactionKnownBy);
-    m_transactionKnownBy.clear();
+}
+
+/**
+ * @brief : get the index of the given peer in TransactionKnownBy
+ * @param _nodeId : the node id of the peer
+ * @return size_t : the index of the peer, c_maxKnownByPeers if the peer has no index
+ */
+size_t TxPool::peerIndex(h512 const& _nodeId) const
+{
+    auto p = m_peerIndex.find(_nodeId);
+    if (p != m_peerIndex.end())
+        return p->second;
+    return c_maxKnownByPeers;
+}
+
+/// allocate an index for the given peer, reuse the indexes released by the inactive peers first
+void TxPool::allocatePeerIndex(h512 const& _nodeId)
+{
+    {
+        ReadGuard l(x_peerIndex);
+        if (m_peerIndex.count(_nodeId))
+            return;
+    }
+    WriteGuard l(x_peerIndex);
+    if (m_peerIndex.count(_nodeId))
+        return;
+    if (!m_freePeerIndexes.empty())
+    {
+        m_peerIndex[_nodeId] = m_freePeerIndexes.back();
+        m_freePeerIndexes.pop_back();
+        return;
+    }
+    if (m_peerIndex.size() >= c_maxKnownByPeers)
+    {
+        TXPOOL_LOG(WARNING) << LOG_DESC(
+                                   "allocatePeerIndex: too many peers to record known transactions")
+                            << LOG_KV("nodeId", _nodeId.abridged());
+        return;
+    }
+    size_t index = m_peerIndex.size();
+    m_peerIndex[_nodeId] = index;
+}
+
+/// release the indexes of the peers not in _activePeers, and clear their bits of the transactions
+/// so that the indexes can be reused by the new peers
+void TxPool::removeInactivePeers(std::set<h512> const& _activePeers)
+{
+    {
+        ReadGuard l(x_peerIndex);
+        bool hasInactive = false;
+        for (auto const& peer : m_peerIndex)
+        {
+            if (!_activePeers.count(peer.first))
+            {
+                hasInactive = true;
+                break;
+            }
+        }
+        if (!hasInactive)
+            return;
+    }
+    WriteGuard l(x_peerIndex);
+    std::vector<size_t> released;
+    for (auto it = m_peerIndex.begin(); it != m_peerIndex.end();)
+    {
+        if (_activePeers.count(it->first))
+        {
+            ++it;
+            continue;
+        }
+        TXPOOL_LOG(DEBUG) << LOG_DESC("removeInactivePeers: release the index of inactive peer")
+                          << LOG_KV("nodeId", it->first.abridged())
+                          << LOG_KV("index", it->second);
+        released.push_back(it->second);
+        it = m_peerIndex.erase(it);
+    }
+    if (released.empty())
+        return;
+    {
+        ReadGuard txsLock(m_lock);
+        for (auto& tx : m_txsHash)
+        {
+            for (auto const& index : released)
+                tx.second.knownBy.reset(index);
+        }
+    }
+    m_freePeerIndexes.insert(m_freePeerIndexes.end(), released.begin(), released.end());
 }
 
 /// Set transaction is known by a node
 void TxPool::setTransactionIsKnownBy(h256 const& _txHash, h512 const& _nodeId)
 {
-    m_transactionKnownBy[_txHash].insert(_nodeId);
+    allocatePeerIndex(_nodeId);
+    /// hold x_peerIndex to keep the index from being released while setting the bit
+    ReadGuard pl(x_peerIndex);
+    size_t index = peerIndex(_nodeId);
+    if (index >= c_maxKnownByPeers)
+        return;
+    ReadGuard l(m_lock);
+    auto p_tx = m_txsHash.find(_txHash);
+    if (p_tx != m_txsHash.end())
+        p_tx->second.knownBy.set(index);
 }
 
 /// set transactions is known by a node
 void TxPool::setTransactionsAreKnownBy(
     std::vector<dev::h256> const& _txHashVec, h512 const& _nodeId)
 {
-    WriteGuard l(x_transactionKnownBy);
+    allocatePeerIndex(_nodeId);
+    ReadGuard pl(x_peerIndex);
+    size_t index = peerIndex(_nodeId);
+    if (index >= c_maxKnownByPeers)
+        return;
+    ReadGuard l(m_lock);
+    for (auto const& tx_hash : _txHashVec)
+    {
+        auto p_tx = m_txsHash.find(tx_hash);
+        if (p_tx != m_txsHash.end())
+            p_tx->second.knownBy.set(index);
+    }
+}
+
+/// set transactions is not known by a node
+void TxPool::resetTransactionsKnownBy(std::vector<dev::h256> const& _txHashVec, h512 const& _nodeId)
+{
+    ReadGuard pl(x_peerIndex);
+    size_t index = peerIndex(_nodeId);
+    if (index >= c_maxKnownByPeers)
+        return;
+    ReadGuard l(m_lock);
     for (auto const& tx_hash : _txHashVec)
     {
-        m_transactionKnownBy[tx_hash].insert(_nodeId);
+        auto p_tx = m_txsHash.find(tx_hash);
+        if (p_tx != m_txsHash.end())
+            p_tx->second.knownBy.reset(index);
     }
 }
 
+/// Is the transaction is known by the node ?
+bool TxPool::isTransactionKnownBy(h256 const& _txHash, h512 const& _nodeId)
+{
+    ReadGuard pl(x_peerIndex);
+    size_t index = peerIndex(_nodeId);
+    if (index >= c_maxKnownByPeers)
+        return false;
+    ReadGuard l(m_lock);
+    auto p_tx = m_txsHash.find(_txHash);
+    if (p_tx == m_txsHash.end())
+        return false;
+    return p_tx->second.knownBy.test(index);
+}
+
 /// Is the transaction is known by someone
 bool TxPool::isTransactionKnownBySomeone(h256 const& _txHash)
 {
-    auto p = m_transactionKnownBy.find(_txHash);
-    if (p == m_transactionKnownBy.end())
+    ReadGuard l(m_lock);
+    auto p_tx = m_txsHash.find(_txHash);
+    if (p_tx == m_txsHash.end())
         return false;
-    return !p->second.empty();
+    return p_tx->second.knownBy.any();
 }
 
-// Remove the record of transaction know by some peers
-void TxPool::removeTransactionKnowBy(h256 const& _txHash)
+/// Is the transaction in the transaction pool ?
+bool TxPool::isTransactionInPool(h256 const& _txHash)
 {
-    auto p = m_transactionKnownBy.find(_txHash);
-    if (p != m_transactionKnownBy.end())
-        m_transactionKnownBy.erase(p);
+    ReadGuard l(m_lock);
+    return m_txsHash.count(_txHash);
+}
+
+/// get the transactions with the given hashes, transactions not in the pool are ignored
+Transactions TxPool::transactionsByHash(std::vector<dev::h256> const& _txHashes)
+{
+    Transactions ret;
+    ReadGuard l(m_lock);
+    for (auto const& txHash : _txHashes)
+    {
+        auto p_tx = m_txsHash.find(txHash);
+        if (p_tx != m_txsHash.end())
+            ret.push_back(*(p_tx->second.tx));
+    }
+    return ret;
 }
 
 }  // namespace txpool
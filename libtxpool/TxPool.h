@@ -25,12 +25,15 @@
 #include "TransactionNonceCheck.h"
 #include "TxPoolInterface.h"
 #include <libblockchain/BlockChainInterface.h>
+#include <libdevcore/ThreadPool.h>
 #include <libdevcore/easylog.h>
 #include <libethcore/Block.h>
 #include <libethcore/Common.h>
 #include <libethcore/Protocol.h>
 #include <libethcore/Transaction.h>
 #include <libp2p/P2PInterface.h>
+#include <array>
+#include <atomic>
 using namespace dev::eth;
 using namespace dev::p2p;
 
@@ -44,16 +47,94 @@ namespace txpool
 {
 class TxPool;
 
+/// priority lanes of the transaction pool, the lane with smaller index is served first in a round
+enum TxPoolLane : size_t
+{
+    /// calls to the governance precompiled contracts(SystemConfig, Consensus, Authority)
+    SystemLane = 0,
+    /// transactions sent by the whitelisted senders
+    PrioritySenderLane = 1,
+    NormalLane = 2,
+    LaneCount
+};
+/// a lane contributes at most weight transactions in each round of topTransactions
+static std::array<uint64_t, LaneCount> const c_defaultLaneWeights = {{4, 2, 1}};
+
+struct TxPoolLaneStatus
+{
+    /// number of pending transactions
+    size_t depth = 0;
+    /// wait time(ms) of the oldest pending transaction
+    uint64_t oldestWait = 0;
+    /// number of committed transactions
+    uint64_t committed = 0;
+    /// average wait time(ms) from import to commit
+    uint64_t avgCommitWait = 0;
+};
+
 struct TxPoolStatus
 {
     size_t current;
     size_t dropped;
+    std::array<TxPoolLaneStatus, LaneCount> lanes;
+    /// receipt notification batches waiting for the notifier threads
+    size_t notifyPending;
+    /// receipt notifications delivered to the RPC callbacks
+    uint64_t notifyDelivered;
+    /// receipt notifications dropped since too many batches are pending
+    uint64_t notifyDropped;
 };
 
+/// threads delivering the receipts to the RPC callbacks
+static size_t const c_txNotifierThreadNum = 2;
+/// max number of pending receipt notification batches(one batch per block)
+static size_t const c_maxPendingNotifyBatches = 1000;
+
 class TxPoolNonceManager
 {
 public:
 };
+/// max number of peers that can be recorded by TransactionKnownBy
+static size_t const c_maxKnownByPeers = 256;
+
+/// fixed-width bitmap recording which peers(indexed by peer index) know a transaction
+class TransactionKnownBy
+{
+public:
+    TransactionKnownBy()
+    {
+        for (auto& word : m_bits)
+            word.store(0, std::memory_order_relaxed);
+    }
+    void set(size_t const& _peerIndex)
+    {
+        m_bits[_peerIndex / 64].fetch_or(
+            uint64_t(1) << (_peerIndex % 64), std::memory_order_relaxed);
+    }
+    bool test(size_t const& _peerIndex) const
+    {
+        return m_bits[_peerIndex / 64].load(std::memory_order_relaxed) &
+               (uint64_t(1) << (_peerIndex % 64));
+    }
+    void reset(size_t const& _peerIndex)
+    {
+        m_bits[_peerIndex / 64].fetch_and(
+            ~(uint64_t(1) << (_peerIndex % 64)), std::memory_order_relaxed);
+    }
+    bool any() const
+    {
+        for (auto const& word : m_bits)
+        {
+            if (word.load(std::memory_order_relaxed))
+                return true;
+        }
+        return false;
+    }
+
+private:
+    std::array<std::atomic<uint64_t>, c_maxKnownByPeers / 64> m_bits;
+};
+
 struct transactionCompare
 {
     bool operator()(dev::eth::Transaction const& _first, dev::eth::Transaction const& _second) const
@@ -78,6 +159,8 @@ public:
         m_groupId = dev::eth::getGroupAndProtocol(m_protocolId).first;
         m_txNonceCheck = std::make_shared<TransactionNonceCheck>(m_blockChain, m_protocolId);
         m_commonNonceCheck = std::make_shared<CommonTransactionNonceCheck>(m_protocolId);
+        m_notifier = std::make_shared<dev::ThreadPool>(
+            "txNotifier-" + std::to_string(m_groupId), c_txNotifierThreadNum);
     }
     void setMaxBlockLimit(unsigned const& limit) { m_txNonceCheck->setBlockLimit(limit); }
     unsigned const& maxBlockLimit() { return m_txNonceCheck->maxBlockLimit(); }
@@ -123,23 +206,28 @@ public:
     /// protocol id used when register handler to p2p module
     virtual PROTOCOL_ID const& getProtocolId() const override { return m_protocolId; }
     void setTxPoolLimit(uint64_t const& _limit) { m_limit = _limit; }
+    /// set the senders whose transactions are put into PrioritySenderLane
+    void setPrioritySenders(dev::h160s const& _senders);
+    /// set the weights of the lanes, zero weight is treated as one
+    void setLaneWeights(std::array<uint64_t, LaneCount> const& _weights);
 
     /// Set transaction is known by a node
     void setTransactionIsKnownBy(h256 const& _txHash, h512 const& _nodeId) override;
 
     /// Is the transaction is known by the node ?
-    bool isTransactionKnownBy(h256 const& _txHash, h512 const& _nodeId) override
-    {
-        auto p = m_transactionKnownBy.find(_txHash);
-        if (p == m_transactionKnownBy.end())
-            return false;
-        return p->second.find(_nodeId) != p->second.end();
-    }
+    bool isTransactionKnownBy(h256 const& _txHash, h512 const& _nodeId) override;
     void setTransactionsAreKnownBy(
         std::vector<dev::h256> const& _txHashVec, h512 const& _nodeId) override;
+    void resetTransactionsKnownBy(
+        std::vector<dev::h256> const& _txHashVec, h512 const& _nodeId) override;
     /// Is the transaction is known by someone
     bool isTransactionKnownBySomeone(h256 const& _txHash) override;
-    SharedMutex& xtransactionKnownBy() override { return x_transactionKnownBy; }
+    /// release the indexes of the peers not in _activePeers for the new peers
+    void removeInactivePeers(std::set<h512> const& _activePeers) override;
+    /// Is the transaction in the transaction pool ?
+    bool isTransactionInPool(h256 const& _txHash) override;
+    /// get the transactions with the given hashes
+    dev::eth::Transactions transactionsByHash(std::vector<dev::h256> const& _txHashes) override;
 
     /// verify and set the sender of known transactions of sepcified block
     void verifyAndSetSenderForBlock(dev::eth::Block& block) override;
@@ -164,17 +252,27 @@ protected:
     virtual u256 filterCheck(const Transaction&) const { return u256(0); };
     void clear();
     bool dropTransactions(dev::eth::Block const& block, bool needNotify = false);
-    bool removeBlockKnowTrans(dev::eth::Block const& block);
 
 private:
     dev::eth::LocalisedTransactionReceipt::Ptr constructTransactionReceipt(
         dev::eth::Transaction const& tx, dev::eth::TransactionReceipt const& receipt,
         dev::eth::Block const& block, unsigned index);
 
-    bool removeTrans(h256 const& _txHash, bool needTriggerCallback = false,
-        dev::eth::LocalisedTransactionReceipt::Ptr pReceipt = nullptr);
+    /// remove the transaction, move its RPC callback out to _callback if given
+    bool removeTrans(h256 const& _txHash, bool _committed = false,
+        dev::eth::RPCCallback* _callback = nullptr);
+    /// construct the receipts and deliver them to the RPC callbacks on the notifier threads
+    void notifyReceipts(dev::eth::Block const& block,
+        std::vector<std::pair<size_t, dev::eth::RPCCallback>> const& callbacks);
     bool insert(dev::eth::Transaction const& _tx);
-    void removeTransactionKnowBy(h256 const& _txHash);
+    /// get the lane of the given verified transaction
+    TxPoolLane laneOf(dev::eth::Transaction const& _tx) const;
+    /// allocate an index for the given peer if it has none
+    void allocatePeerIndex(h512 const& _nodeId);
+    /// get the index of the given peer, x_peerIndex must be held to keep the index from being
+    /// released and reused by another peer
+    /// @return c_maxKnownByPeers if the peer has no index
+    size_t peerIndex(h512 const& _nodeId) const;
     bool inline txPoolNonceCheck(dev::eth::Transaction const& tx)
     {
         if (!m_commonNonceCheck->isNonceOk(tx, true))
@@ -198,15 +296,38 @@ private:
     /// protocolId
     PROTOCOL_ID m_protocolId;
     GROUP_ID m_groupId;
-    /// transaction queue
+    /// transaction queues of the lanes
     using TransactionQueue = std::set<dev::eth::Transaction, transactionCompare>;
-    TransactionQueue m_txsQueue;
-    std::unordered_map<h256, TransactionQueue::iterator> m_txsHash;
+    std::array<TransactionQueue, LaneCount> m_txsQueues;
+    /// transaction entry indexed by hash, the peers known the transaction are recorded inline
+    struct TxPoolEntry
+    {
+        TxPoolEntry(TransactionQueue::iterator const& _tx, TxPoolLane const& _lane)
+          : tx(_tx), lane(_lane)
+        {}
+        TransactionQueue::iterator tx;
+        TxPoolLane lane;
+        TransactionKnownBy knownBy;
+    };
+    std::unordered_map<h256, TxPoolEntry> m_txsHash;
     /// hash of dropped transactions
     h256Hash m_dropped;
-    /// Transaction is known by some peers
-    mutable SharedMutex x_transactionKnownBy;
-    std::unordered_map<h256, std::unordered_set<h512>> m_transactionKnownBy;
+    /// lane settings and commit metrics(protected by m_lock)
+    std::array<uint64_t, LaneCount> m_laneWeights = c_defaultLaneWeights;
+    std::unordered_set<dev::Address> m_prioritySenders;
+    std::array<uint64_t, LaneCount> m_laneCommitted = {{0}};
+    std::array<uint64_t, LaneCount> m_laneCommitWait = {{0}};
+    /// maps from node id to the index of TransactionKnownBy, the indexes released by the
+    /// disconnected peers are reused
+    mutable SharedMutex x_peerIndex;
+    std::unordered_map<h512, size_t> m_peerIndex;
+    std::vector<size_t> m_freePeerIndexes;
+    /// receipt notification metrics
+    std::atomic<size_t> m_notifyPending = {0};
+    std::atomic<uint64_t> m_notifyDelivered = {0};
+    std::atomic<uint64_t> m_notifyDropped = {0};
+    /// must be declared last: stopped before the members used by the notify tasks are destroyed
+    std::shared_ptr<dev::ThreadPool> m_notifier;
 };
 }  // namespace txpool
 }  // namespace dev
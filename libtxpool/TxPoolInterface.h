@@ -26,6 +26,7 @@
 #include <libethcore/Common.h>
 #include <libethcore/Protocol.h>
 #include <libethcore/Transaction.h>
+#include <set>
 namespace dev
 {
 namespace txpool
@@ -101,19 +102,34 @@ public:
     /// param2: the node id
     virtual void setTransactionsAreKnownBy(std::vector<dev::h256> const&, h512 const&){};
 
+    /// param1: the vector of txhashes no longer known by the node, e.g. the announcement is lost
+    /// param2: the node id
+    virtual void resetTransactionsKnownBy(std::vector<dev::h256> const&, h512 const&){};
+
     /// Is the transaction is known by the node ?
     virtual bool isTransactionKnownBy(h256 const&, h512 const&) { return false; };
 
     /// Is the transaction is known by someone
     virtual bool isTransactionKnownBySomeone(h256 const&) { return false; };
 
+    /// forget the transactions known by the peers not in the given active peers
+    virtual void removeInactivePeers(std::set<h512> const&){};
+
+    /// Is the transaction in the transaction pool ?
+    virtual bool isTransactionInPool(h256 const&) { return false; };
+
+    /// get the transactions with the given hashes, transactions not in the pool are ignored
+    virtual dev::eth::Transactions transactionsByHash(std::vector<dev::h256> const&)
+    {
+        return dev::eth::Transactions();
+    };
+
     /// Register a handler that will be called once there is a new transaction imported
     template <class T>
     dev::eth::Handler<> onReady(T const& _t)
     {
         return m_onReady.add(_t);
     }
-    virtual SharedMutex& xtransactionKnownBy() = 0;
 
     /// param: the block that should be verified and set sender according to transactions of local
     /// transaction pool
@@ -0,0 +1,202 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2018 fisco-dev contributors.
+ */
+
+/**
+ * @brief: unit test for the link model of the SimulatedNetwork of the consensus benchmark
+ * @file: SimulatedNetwork.cpp
+ */
+#include <fisco-bcos/benchmark/SimulatedNetwork.h>
+#include <libdevcrypto/Common.h>
+#include <libethcore/Protocol.h>
+#include <test/tools/libutils/TestOutputHelper.h>
+#include <boost/test/unit_test.hpp>
+
+using namespace dev;
+using namespace dev::p2p;
+using namespace dev::benchmark;
+
+namespace dev
+{
+namespace test
+{
+/// records the messages delivered to one node
+class Receiver
+{
+public:
+    void onMessage(P2PMessage::Ptr)
+    {
+        std::lock_guard<std::mutex> l(m_mutex);
+        m_recvTimes.push_back(std::chrono::steady_clock::now());
+        m_signalled.notify_all();
+    }
+
+    /// wait until _condition holds or the timeout expires
+    bool waitFor(std::function<bool()> const& _condition)
+    {
+        std::unique_lock<std::mutex> l(m_mutex);
+        return m_signalled.wait_for(l, std::chrono::seconds(10), _condition);
+    }
+
+    bool waitForCount(size_t _count)
+    {
+        return waitFor([this, _count]() { return m_recvTimes.size() >= _count; });
+    }
+
+    std::vector<std::chrono::steady_clock::time_point> recvTimes()
+    {
+        std::lock_guard<std::mutex> l(m_mutex);
+        return m_recvTimes;
+    }
+
+private:
+    std::mutex m_mutex;
+    std::condition_variable m_signalled;
+    std::vector<std::chrono::steady_clock::time_point> m_recvTimes;
+};
+
+class SimulatedNetworkFixture : public TestOutputHelperFixture
+{
+public:
+    SimulatedNetworkFixture()
+    {
+        for (size_t i = 0; i < 4; i++)
+        {
+            m_nodes.push_back(KeyPair::create().pub());
+        }
+    }
+
+    /// create a network of all the nodes, every node records the messages delivered to it
+    SimulatedNetwork::Ptr createNetwork(
+        uint64_t _seed, std::vector<std::shared_ptr<Receiver>>& _receivers)
+    {
+        auto network = std::make_shared<SimulatedNetwork>(LinkModel(), _seed);
+        _receivers.clear();
+        for (auto const& node : m_nodes)
+        {
+            auto service = network->addNode(node);
+            auto receiver = std::make_shared<Receiver>();
+            service->registerHandlerByProtoclID(
+                c_protocolID, [receiver](dev::network::NetworkException,
+                                  std::shared_ptr<P2PSession>, P2PMessage::Ptr _message) {
+                    receiver->onMessage(_message);
+                });
+            _receivers.push_back(receiver);
+        }
+        network->start();
+        return network;
+    }
+
+    P2PMessage::Ptr createMessage(size_t _size)
+    {
+        auto message = std::make_shared<P2PMessage>();
+        message->setProtocolID(c_protocolID);
+        message->setBuffer(std::make_shared<bytes>(_size, 0x01));
+        return message;
+    }
+
+    /// send _count messages from the first node to the second one through _link and return the
+    /// number of them delivered
+    size_t sendThroughLossyLink(uint64_t _seed, size_t _count, LinkModel const& _link)
+    {
+        std::vector<std::shared_ptr<Receiver>> receivers;
+        auto network = createNetwork(_seed, receivers);
+        network->setLink(m_nodes[0], m_nodes[1], _link);
+        for (size_t i = 0; i < _count; i++)
+        {
+            network->send(m_nodes[0], m_nodes[1], createMessage(16));
+        }
+        /// the drops are decided when sending, so the rest of the messages must arrive
+        size_t expected = _count - network->droppedMessages();
+        BOOST_CHECK(receivers[1]->waitForCount(expected));
+        network->stop();
+        BOOST_CHECK_EQUAL(receivers[1]->recvTimes().size(), expected);
+        return expected;
+    }
+
+    static const PROTOCOL_ID c_protocolID = dev::eth::ProtocolID::TxPool;
+    std::vector<NodeID> m_nodes;
+};
+
+BOOST_FIXTURE_TEST_SUITE(SimulatedNetworkTest, SimulatedNetworkFixture)
+
+BOOST_AUTO_TEST_CASE(testLossyLink)
+{
+    LinkModel halfLoss;
+    halfLoss.loss = 0.5;
+    size_t delivered = sendThroughLossyLink(100, 1000, halfLoss);
+    BOOST_CHECK(delivered > 300 && delivered < 700);
+    /// the same seed drops the same messages
+    BOOST_CHECK_EQUAL(sendThroughLossyLink(100, 1000, halfLoss), delivered);
+
+    /// a link dropping every message delivers nothing while the other links are unaffected
+    std::vector<std::shared_ptr<Receiver>> receivers;
+    auto network = createNetwork(100, receivers);
+    LinkModel broken;
+    broken.loss = 1;
+    network->setLink(m_nodes[0], m_nodes[1], broken);
+    for (size_t i = 0; i < 10; i++)
+    {
+        network->send(m_nodes[0], m_nodes[1], createMessage(16));
+        network->send(m_nodes[0], m_nodes[2], createMessage(16));
+        /// the link is directed
+        network->send(m_nodes[1], m_nodes[0], createMessage(16));
+    }
+    BOOST_CHECK(receivers[2]->waitForCount(10));
+    BOOST_CHECK(receivers[0]->waitForCount(10));
+    network->stop();
+    BOOST_CHECK_EQUAL(network->droppedMessages(), 10u);
+    BOOST_CHECK(receivers[1]->recvTimes().empty());
+}
+
+BOOST_AUTO_TEST_CASE(testSlowLink)
+{
+    std::vector<std::shared_ptr<Receiver>> receivers;
+    auto network = createNetwork(100, receivers);
+    LinkModel slow;
+    slow.latency = 300;
+    network->setLink(m_nodes[0], m_nodes[1], slow);
+    /// 2000 bytes per second, so every message of about 1000 bytes takes about half a second
+    LinkModel narrow;
+    narrow.bandwidth = 2000;
+    network->setLink(m_nodes[0], m_nodes[2], narrow);
+
+    auto sendTime = std::chrono::steady_clock::now();
+    network->send(m_nodes[0], m_nodes[1], createMessage(16));
+    network->send(m_nodes[0], m_nodes[2], createMessage(1000));
+    network->send(m_nodes[0], m_nodes[2], createMessage(1000));
+    network->send(m_nodes[0], m_nodes[3], createMessage(16));
+    BOOST_CHECK(receivers[1]->waitForCount(1));
+    BOOST_CHECK(receivers[2]->waitForCount(2));
+    BOOST_CHECK(receivers[3]->waitForCount(1));
+    network->stop();
+
+    auto elapsed = [sendTime](std::chrono::steady_clock::time_point const& _time) {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(_time - sendTime).count();
+    };
+    /// the default link delivers at once while the slow link adds its latency
+    BOOST_CHECK(elapsed(receivers[1]->recvTimes()[0]) >= 300);
+    BOOST_CHECK(elapsed(receivers[3]->recvTimes()[0]) < 300);
+    /// the second message of the narrow link waits for the first one to be transmitted
+    auto narrowTimes = receivers[2]->recvTimes();
+    BOOST_CHECK(elapsed(narrowTimes[0]) >= 500);
+    BOOST_CHECK(elapsed(narrowTimes[1]) >= 1000);
+    BOOST_CHECK_EQUAL(network->droppedMessages(), 0u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+}  // namespace test
+}  // namespace dev
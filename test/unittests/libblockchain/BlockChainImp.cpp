@@ -259,6 +259,14 @@ BOOST_AUTO_TEST_CASE(getBlockByHash)
     BOOST_CHECK_EQUAL(bptr->getTransactionSize(), 5);
 }
 
+BOOST_AUTO_TEST_CASE(getBlockRLPsByNumber)
+{
+    std::vector<bytes> blockRLPs = m_blockChainImp->getBlockRLPsByNumber(0, 2);
+    BOOST_REQUIRE_EQUAL(blockRLPs.size(), 1);
+    BOOST_CHECK(blockRLPs[0] == m_fakeBlock->getBlockData());
+    BOOST_CHECK_EQUAL(m_blockChainImp->getBlockRLPsByNumber(1, 1).size(), 0);
+}
+
 BOOST_AUTO_TEST_CASE(getLocalisedTxByHash)
 {
     Transaction tx = m_blockChainImp->getLocalisedTxByHash(h256(c_commonHashPrefix));
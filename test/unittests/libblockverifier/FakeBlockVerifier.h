@@ -45,7 +45,16 @@ public:
         dev::eth::TransactionReceipt reciept;
         return std::make_pair(res, reciept);
     }
-
+    std::shared_ptr<ExecutiveContext> createExecutiveContext(BlockInfo const&) override
+    {
+        return m_execContext;
+    }
+    void executeNextTransaction(dev::eth::Block& block, dev::eth::Transaction const&,
+        std::shared_ptr<ExecutiveContext>) override
+    {
+        block.appendTransactionReceipt(dev::eth::TransactionReceipt());
+    }
+    void finalizeExecutedBlock(dev::eth::Block&, std::shared_ptr<ExecutiveContext>) override {}
 
 private:
     std::shared_ptr<ExecutiveContext> m_execContext;
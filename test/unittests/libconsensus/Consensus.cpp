@@ -92,6 +92,84 @@ BOOST_AUTO_TEST_CASE(testLoadTransactions)
     /// the transaction pool is empty, stop sealing
     BOOST_CHECK(fake_pbft.checkTxsEnough(11) == true);
 }
+
+/// the block verifier failing to execute the second transaction with the given error
+class FakePreExecuteVerifier : public FakeBlockverifier
+{
+public:
+    FakePreExecuteVerifier(std::function<void()> const& _fail) : m_fail(_fail) {}
+    std::shared_ptr<ExecutiveContext> createExecutiveContext(BlockInfo const&) override
+    {
+        return std::make_shared<ExecutiveContext>();
+    }
+    void executeNextTransaction(Block& block, Transaction const& tx,
+        std::shared_ptr<ExecutiveContext> context) override
+    {
+        if (++m_executed == 2)
+        {
+            m_fail();
+        }
+        FakeBlockverifier::executeNextTransaction(block, tx, context);
+    }
+
+private:
+    std::function<void()> m_fail;
+    size_t m_executed = 0;
+};
+
+/// pre-execute 4 transactions with the second one failing by _fail
+static std::shared_ptr<FakePBFTSealer> preExecuteTransactions(
+    std::shared_ptr<TxPoolFixture> txpool_creator, std::function<void()> const& _fail)
+{
+    std::shared_ptr<SyncInterface> sync = std::make_shared<FakeBlockSync>();
+    std::shared_ptr<BlockVerifierInterface> blockVerifier =
+        std::make_shared<FakePreExecuteVerifier>(_fail);
+
+    Transaction tx(u256(100), u256(0), u256(100000000), toAddress(KeyPair::create().pub()),
+        bytes{0x01, 0x02});
+    Secret sec = KeyPair::create().secret();
+    for (size_t i = 0; i < 4; i++)
+    {
+        tx.setNonce(tx.nonce() + u256(i));
+        tx.setBlockLimit(txpool_creator->m_blockChain->number() + 2);
+        dev::Signature sig = sign(sec, tx.sha3(WithoutSignature));
+        tx.updateSignature(SignatureStruct(sig));
+        txpool_creator->m_txPool->submit(tx);
+    }
+    BOOST_CHECK(txpool_creator->m_txPool->pendingSize() == 4);
+
+    auto fake_pbft = std::make_shared<FakePBFTSealer>(txpool_creator->m_topicService,
+        txpool_creator->m_txPool, txpool_creator->m_blockChain, sync, blockVerifier, 10);
+    fake_pbft->setPreExecute(true);
+    /// make this node the leader of the next block
+    fake_pbft->engine()->setView(0);
+    fake_pbft->engine()->mutableHighest().setSealer(u256(0));
+    fake_pbft->engine()->setNodeIdx(fake_pbft->engine()->mutableHighest().number() % 3);
+    fake_pbft->resetSealing();
+    fake_pbft->loadTransactions(4);
+    return fake_pbft;
+}
+
+BOOST_AUTO_TEST_CASE(testPreExecuteTransactions)
+{
+    /// the transaction failed by itself is dropped from the block and the txpool
+    auto txpool_creator = std::make_shared<TxPoolFixture>(5, 5);
+    auto fake_pbft = preExecuteTransactions(
+        txpool_creator, []() { BOOST_THROW_EXCEPTION(OutOfGasIntrinsic()); });
+    BOOST_CHECK(fake_pbft->sealing().p_execContext != nullptr);
+    BOOST_CHECK(fake_pbft->sealing().block.getTransactionSize() == 3);
+    BOOST_CHECK(fake_pbft->sealing().block.transactionReceipts().size() == 3);
+    BOOST_CHECK(txpool_creator->m_txPool->pendingSize() == 3);
+
+    /// other failures give up the pre-execution and keep all the transactions
+    txpool_creator = std::make_shared<TxPoolFixture>(5, 5);
+    fake_pbft = preExecuteTransactions(
+        txpool_creator, []() { throw std::runtime_error("open table failed"); });
+    BOOST_CHECK(fake_pbft->sealing().p_execContext == nullptr);
+    BOOST_CHECK(fake_pbft->sealing().block.getTransactionSize() == 4);
+    BOOST_CHECK(fake_pbft->sealing().block.transactionReceipts().empty());
+    BOOST_CHECK(txpool_creator->m_txPool->pendingSize() == 4);
+}
 BOOST_AUTO_TEST_SUITE_END()
 }  // namespace test
 }  // namespace dev
@@ -65,6 +65,7 @@ public:
     TimeManager const& timeManager() const { return m_timeManager; }
     TimeManager& mutableTimeManager() { return m_timeManager; }
     const std::shared_ptr<dev::db::LevelDB> backupDB() const { return m_backupDB; }
+    const std::shared_ptr<PBFTBackupWAL> backupWAL() const { return m_backupWAL; }
     bool const& leaderFailed() const { return m_leaderFailed; }
     int64_t const& consensusBlockNumber() const { return m_consensusBlockNumber; }
     VIEWTYPE const& toView() const { return m_toView; }
@@ -96,6 +97,7 @@ public:
     IDXTYPE const& f() { return m_f; }
     void resetConfig() override { PBFTEngine::resetConfig(); }
     PBFTMsgQueue& mutableMsgQueue() { return m_msgQueue; }
+    std::shared_ptr<dev::ThreadPool> sigListVerifyPool() { return m_sigListVerifyPool; }
     void onRecvPBFTMessage(
         NetworkException exception, std::shared_ptr<P2PSession> session, P2PMessage::Ptr message)
     {
@@ -157,6 +159,57 @@ public:
         return PBFTEngine::handlePrepareMsg(prepareReq, ip);
     }
     void setOmitEmpty(bool value) { m_omitEmptyBlock = value; }
+    void preVerifyMsg(PBFTMsgPacket& pbftMsg) { PBFTEngine::preVerifyMsg(pbftMsg); }
+    bool checkSign(PBFTMsg const& req) const { return PBFTEngine::checkSign(req); }
+    bool checkBlock(Block const& block) { return PBFTEngine::checkBlock(block); }
+    bool loadExecutedSealing(h256 const& hash, Sealing& sealing)
+    {
+        return PBFTEngine::loadExecutedSealing(hash, sealing);
+    }
+    void cacheExecutedSealing(h256 const& hash, Sealing const& sealing)
+    {
+        PBFTEngine::cacheExecutedSealing(hash, sealing);
+    }
+    void clearExecutedSealings(int64_t const& number)
+    {
+        PBFTEngine::clearExecutedSealings(number);
+    }
+    bool treeBroadcastMsg(unsigned const& packetType, std::string const& key, bytesConstRef data,
+        IDXTYPE const& rootIdx)
+    {
+        return PBFTEngine::treeBroadcastMsg(packetType, key, data, rootIdx);
+    }
+    void setTreePrepare(PrepareReq const& req, bytes const& data, uint64_t const& time)
+    {
+        m_treePrepareKey = req.uniqueKey();
+        m_treePrepareHash = req.block_hash;
+        m_treePrepareType = PrepareReqPacket;
+        m_treePrepareData = data;
+        m_treePrepareTime = time;
+    }
+    void checkTreeBroadcastTimeout() { PBFTEngine::checkTreeBroadcastTimeout(); }
+    std::vector<IDXTYPE> treeChildren(IDXTYPE const& rootIdx, IDXTYPE const& idx) const
+    {
+        return PBFTEngine::treeChildren(rootIdx, idx);
+    }
+    void encodeCompactBlock(Block const& block, bytes& out) const
+    {
+        PBFTEngine::encodeCompactBlock(block, out);
+    }
+    bool handleCompactPrepareMsg(PrepareReq& prepareReq, PBFTMsgPacket const& pbftMsg)
+    {
+        return PBFTEngine::handleCompactPrepareMsg(prepareReq, pbftMsg);
+    }
+    void handleGetMissedTxsMsg(PBFTMsgPacket const& pbftMsg)
+    {
+        PBFTEngine::handleGetMissedTxsMsg(pbftMsg);
+    }
+    void handleMissedTxsMsg(PBFTMsgPacket const& pbftMsg)
+    {
+        PBFTEngine::handleMissedTxsMsg(pbftMsg);
+    }
+    bool waitingMissedTxs() const { return m_partiallyPrepare != nullptr; }
+    void setPartiallyPrepareTime(uint64_t const& time) { m_partiallyPrepareTime = time; }
     bool handleSignMsg(SignReq& sign_req, PBFTMsgPacket const& pbftMsg)
     {
         return PBFTEngine::handleSignMsg(sign_req, pbftMsg);
@@ -261,6 +314,8 @@ public:
     {
         return PBFTSealer::checkTxsEnough(maxTxsCanSeal);
     }
+    void resetSealing() { resetSealingBlock(); }
+    Sealing const& sealing() const { return m_sealing; }
 
     std::shared_ptr<FakePBFTEngine> engine()
     {
@@ -23,6 +23,7 @@
  */
 #include <libconsensus/raft/RaftEngine.h>
 #include <chrono>
+#include <future>
 #include <thread>
 
 namespace dev
@@ -58,9 +59,9 @@ public:
         return dev::consensus::RaftEngine::generateVoteReq();
     }
 
-    dev::p2p::P2PMessage::Ptr generateHeartbeat()
+    dev::p2p::P2PMessage::Ptr generateHeartbeat(bool _withBlock = true)
     {
-        return dev::consensus::RaftEngine::generateHeartbeat();
+        return dev::consensus::RaftEngine::generateHeartbeat(_withBlock);
     }
 
     dev::consensus::IDXTYPE getIdx() { return m_idx; }
@@ -190,6 +191,20 @@ public:
         dev::consensus::RaftEngine::tryCommitUncommitedBlock(_resp);
     }
 
+    void commitFollowerBlock(dev::consensus::RaftHeartBeat const& _hb)
+    {
+        dev::consensus::RaftEngine::commitFollowerBlock(_hb);
+    }
+
+    /// wait for the blocks queued to the commit thread
+    void waitFollowerCommit()
+    {
+        auto task = std::make_shared<std::packaged_task<void()>>([]() {});
+        auto done = task->get_future();
+        m_commitPool->enqueue([task]() { (*task)(); });
+        done.wait();
+    }
+
     bool heartbeatTimeout = false;
     bool electTimeout = false;
 };
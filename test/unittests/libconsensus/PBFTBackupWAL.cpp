@@ -0,0 +1,165 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2018 fisco-dev contributors.
+ */
+
+/**
+ * @brief: unit test for libconsensus/pbft/PBFTBackupWAL.h
+ * @file: PBFTBackupWAL.cpp
+ */
+#include <libconsensus/pbft/PBFTBackupWAL.h>
+#include <libdevcore/CommonIO.h>
+#include <test/tools/libutils/TestOutputHelper.h>
+#include <boost/filesystem.hpp>
+#include <boost/test/unit_test.hpp>
+using namespace dev::consensus;
+namespace dev
+{
+namespace test
+{
+BOOST_FIXTURE_TEST_SUITE(PBFTBackupWALTest, TestOutputHelperFixture)
+
+static std::string walPath()
+{
+    std::string path = (boost::filesystem::temp_directory_path() /
+                        boost::filesystem::unique_path("pbft-%%%%-%%%%.wal"))
+                           .string();
+    boost::filesystem::remove(path);
+    return path;
+}
+
+/// the latest record of each key is recovered after reopened
+BOOST_AUTO_TEST_CASE(testRecover)
+{
+    std::string path = walPath();
+    {
+        PBFTBackupWAL wal(path, WALSyncPolicy::Always);
+        wal.open();
+        BOOST_CHECK(wal.lookup("committed").empty());
+        BOOST_CHECK(wal.append("committed", dev::ref(bytes(10, 1))));
+        BOOST_CHECK(wal.append("other", dev::ref(bytes(3, 2))));
+        BOOST_CHECK(wal.append("committed", dev::ref(bytes(20, 3))));
+        BOOST_CHECK(wal.lookup("committed") == bytes(20, 3));
+    }
+    PBFTBackupWAL wal(path);
+    wal.open();
+    BOOST_CHECK(wal.lookup("committed") == bytes(20, 3));
+    BOOST_CHECK(wal.lookup("other") == bytes(3, 2));
+    BOOST_CHECK(wal.fileSize() == boost::filesystem::file_size(path));
+    wal.close();
+    boost::filesystem::remove(path);
+}
+
+/// the torn or corrupted tail is truncated and the records before it are kept
+BOOST_AUTO_TEST_CASE(testTruncateInvalidTail)
+{
+    std::string path = walPath();
+    uint64_t validSize = 0;
+    {
+        PBFTBackupWAL wal(path, WALSyncPolicy::Batch);
+        wal.open();
+        wal.append("committed", dev::ref(bytes(10, 1)));
+        validSize = wal.fileSize();
+        wal.append("committed", dev::ref(bytes(10, 2)));
+    }
+    /// corrupt the payload of the second record
+    bytes content = contents(path);
+    content.back() ^= 0xff;
+    writeFile(path, content);
+    {
+        PBFTBackupWAL wal(path);
+        wal.open();
+        BOOST_CHECK(wal.lookup("committed") == bytes(10, 1));
+        BOOST_CHECK(wal.fileSize() == validSize);
+        BOOST_CHECK(boost::filesystem::file_size(path) == validSize);
+        /// torn record
+        wal.close();
+        content = contents(path);
+        content.push_back(0);
+        content.push_back(0);
+        writeFile(path, content);
+    }
+    PBFTBackupWAL wal(path);
+    wal.open();
+    BOOST_CHECK(wal.lookup("committed") == bytes(10, 1));
+    BOOST_CHECK(wal.fileSize() == validSize);
+    /// append after the truncated tail
+    wal.append("committed", dev::ref(bytes(5, 4)));
+    wal.close();
+    wal.open();
+    BOOST_CHECK(wal.lookup("committed") == bytes(5, 4));
+    wal.close();
+    boost::filesystem::remove(path);
+}
+
+/// the log is rewritten with the latest records when it grows over c_maxWALFileSize
+BOOST_AUTO_TEST_CASE(testCompact)
+{
+    std::string path = walPath();
+    bytes data(1024 * 1024, 1);
+    {
+        PBFTBackupWAL wal(path);
+        wal.open();
+        for (size_t i = 0; i < c_maxWALFileSize / data.size(); i++)
+        {
+            data[0] = (byte)i;
+            BOOST_CHECK(wal.append("committed", ref(data)));
+        }
+        BOOST_CHECK(wal.fileSize() < 2 * data.size());
+        BOOST_CHECK(wal.fileSize() == boost::filesystem::file_size(path));
+        BOOST_CHECK(wal.lookup("committed") == data);
+        /// the records are appended to the compacted log
+        BOOST_CHECK(wal.append("other", dev::ref(bytes(3, 2))));
+        BOOST_CHECK(wal.fileSize() == boost::filesystem::file_size(path));
+    }
+    PBFTBackupWAL wal(path);
+    wal.open();
+    BOOST_CHECK(wal.lookup("committed") == data);
+    BOOST_CHECK(wal.lookup("other") == bytes(3, 2));
+    wal.close();
+    boost::filesystem::remove(path);
+}
+
+/// the old log is kept appending if it fails to be compacted
+BOOST_AUTO_TEST_CASE(testCompactFailed)
+{
+    std::string path = walPath();
+    /// the compacted file can't be created
+    boost::filesystem::create_directory(path + ".tmp");
+    bytes data(1024 * 1024, 1);
+    {
+        PBFTBackupWAL wal(path);
+        wal.open();
+        for (size_t i = 0; i <= c_maxWALFileSize / data.size(); i++)
+        {
+            data[0] = (byte)i;
+            BOOST_CHECK(wal.append("committed", ref(data)));
+        }
+        BOOST_CHECK(wal.fileSize() > c_maxWALFileSize);
+        BOOST_CHECK(wal.append("other", dev::ref(bytes(3, 2))));
+        BOOST_CHECK(wal.fileSize() == boost::filesystem::file_size(path));
+    }
+    boost::filesystem::remove(path + ".tmp");
+    PBFTBackupWAL wal(path);
+    wal.open();
+    BOOST_CHECK(wal.lookup("committed") == data);
+    BOOST_CHECK(wal.lookup("other") == bytes(3, 2));
+    wal.close();
+    boost::filesystem::remove(path);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+}  // namespace test
+}  // namespace dev
@@ -26,6 +26,7 @@
 #include <test/tools/libutils/TestOutputHelper.h>
 #include <boost/filesystem.hpp>
 #include <boost/test/unit_test.hpp>
+#include <future>
 namespace dev
 {
 namespace test
@@ -43,8 +44,8 @@ BOOST_AUTO_TEST_CASE(testInitPBFTEnvNormalCase)
     /// init pbft env
     fake_pbft.consensus()->initPBFTEnv(
         fake_pbft.consensus()->timeManager().m_intervalBlockTime * 3);
-    /// check level db has already been openend
-    BOOST_CHECK(fake_pbft.consensus()->backupDB());
+    /// check the backup log has already been openend
+    BOOST_CHECK(fake_pbft.consensus()->backupWAL());
     BOOST_CHECK(fake_pbft.consensus()->consensusBlockNumber() == 0);
     BOOST_CHECK(fake_pbft.consensus()->toView() == 0);
     BOOST_CHECK(fake_pbft.consensus()->view() == 0);
@@ -116,6 +117,40 @@ BOOST_AUTO_TEST_CASE(testOnRecvPBFTMessage)
     CheckOnRecvPBFTMessage(
         fake_pbft.consensus(), session2, viewChange_req, ViewChangeReqPacket, true);
 }
+
+/// the messages of a sender are pre-verified in parallel but queued in the received order
+BOOST_AUTO_TEST_CASE(testRecvOrderOfSender)
+{
+    KeyPair key_pair;
+    PrepareReq prepare_req = FakePrepareReq(key_pair);
+    FakeConsensus<FakePBFTEngine> fake_pbft(1, ProtocolID::PBFT);
+    FakePBFTSealer(fake_pbft);
+    std::shared_ptr<FakeSession> session = FakeSessionFunc(fake_pbft.m_sealerList[0]);
+    SignReq sign_req(prepare_req, key_pair, prepare_req.idx + 100);
+    CommitReq commit_req(prepare_req, key_pair, prepare_req.idx + 10);
+    ViewChangeReq viewChange_req(
+        key_pair, prepare_req.height, prepare_req.view, prepare_req.idx, prepare_req.block_hash);
+    auto pbft = fake_pbft.consensus();
+    std::vector<P2PMessage::Ptr> messages = {
+        FakeReqMessage(pbft, prepare_req, PrepareReqPacket, ProtocolID::PBFT),
+        FakeReqMessage(pbft, sign_req, SignReqPacket, ProtocolID::PBFT),
+        FakeReqMessage(pbft, commit_req, CommitReqPacket, ProtocolID::PBFT),
+        FakeReqMessage(pbft, viewChange_req, ViewChangeReqPacket, ProtocolID::PBFT)};
+    std::vector<PACKET_TYPE> packetTypes = {
+        PrepareReqPacket, SignReqPacket, CommitReqPacket, ViewChangeReqPacket};
+    size_t rounds = 50;
+    for (size_t i = 0; i < rounds; i++)
+    {
+        for (auto const& message : messages)
+            pbft->onRecvPBFTMessage(NetworkException(), session, message);
+    }
+    for (size_t i = 0; i < rounds * messages.size(); i++)
+    {
+        auto ret = pbft->mutableMsgQueue().tryPop(unsigned(1000));
+        BOOST_REQUIRE(ret.first);
+        BOOST_CHECK_EQUAL(ret.second.packet_id, packetTypes[i % packetTypes.size()]);
+    }
+}
 /// test broadcastMsg
 BOOST_AUTO_TEST_CASE(testBroadcastMsg)
 {
@@ -251,6 +286,8 @@ BOOST_AUTO_TEST_CASE(testTimeout)
     fake_pbft.consensus()->checkTimeout();
     BOOST_CHECK(fake_pbft.consensus()->toView() == oriToView + 1);
     BOOST_CHECK(timeManager.m_changeCycle == oriChangeCycle + 1);
+    /// the timeout is recorded for the leader of the view
+    BOOST_CHECK(timeManager.sealerStats()[fake_pbft.m_sealerList[0]].timeouts == 1);
 
     ///< expect to no timeout
     fake_pbft.consensus()->checkTimeout();
@@ -258,6 +295,58 @@ BOOST_AUTO_TEST_CASE(testTimeout)
     BOOST_CHECK(timeManager.m_changeCycle == oriChangeCycle + 1);
 }
 
+/// test the view timeout adapted to the latencies of the leader
+BOOST_AUTO_TEST_CASE(testAdaptiveTimeout)
+{
+    TimeManager timeManager;
+    timeManager.initTimerManager(3 * timeManager.m_intervalBlockTime);
+    KeyPair leader = KeyPair::create();
+    for (size_t i = 0; i < c_minLatencySamples; i++)
+    {
+        timeManager.updateLatency(leader.pub(), 100);
+    }
+    /// disabled
+    BOOST_CHECK(timeManager.viewTimeout(leader.pub()) == timeManager.m_viewTimeout);
+
+    timeManager.m_adaptive = true;
+    /// not sampled
+    BOOST_CHECK(timeManager.viewTimeout(KeyPair::create().pub()) == timeManager.m_viewTimeout);
+    /// shortened to the lower bound
+    BOOST_CHECK(timeManager.viewTimeout(leader.pub()) == timeManager.m_viewTimeout / 2);
+    /// the percentile grows with the latencies
+    for (size_t i = 0; i < c_maxLatencySamples; i++)
+    {
+        timeManager.updateLatency(leader.pub(), 1000);
+    }
+    BOOST_CHECK(timeManager.sealerStats()[leader.pub()].latencies.size() == c_maxLatencySamples);
+    BOOST_CHECK(timeManager.sealerStats()[leader.pub()].percentile == 1000);
+    BOOST_CHECK(timeManager.viewTimeout(leader.pub()) ==
+                timeManager.m_intervalBlockTime + c_latencyTimeoutFactor * 1000);
+
+    /// skip the leader timed out repeatedly until it commits a block again
+    for (size_t i = 0; i < c_leaderSkipTimeouts; i++)
+    {
+        timeManager.updateTimeouts(leader.pub());
+    }
+    BOOST_CHECK(timeManager.viewTimeout(leader.pub()) == timeManager.m_viewTimeout / 2);
+
+    /// the statistics are restored from the backup
+    bytes data;
+    timeManager.encodeSealerStats(data);
+    TimeManager restored;
+    restored.initTimerManager(timeManager.m_viewTimeout);
+    restored.m_adaptive = true;
+    restored.decodeSealerStats(ref(data));
+    BOOST_CHECK(restored.sealerStats()[leader.pub()].timeouts == c_leaderSkipTimeouts);
+    BOOST_CHECK(restored.sealerStats()[leader.pub()].percentile == 1000);
+    BOOST_CHECK(restored.viewTimeout(leader.pub()) == timeManager.m_viewTimeout / 2);
+
+    timeManager.updateLatency(leader.pub(), 1000);
+    BOOST_CHECK(timeManager.sealerStats()[leader.pub()].timeouts == 0);
+    BOOST_CHECK(timeManager.viewTimeout(leader.pub()) ==
+                timeManager.m_intervalBlockTime + c_latencyTimeoutFactor * 1000);
+}
+
 /// test checkAndChangeView
 BOOST_AUTO_TEST_CASE(testCheckAndChangeView)
 {
@@ -397,6 +486,79 @@ BOOST_AUTO_TEST_CASE(testCheckAndCommit)
     /// checkReportBlock(fake_pbft, highest, false);
     /// BOOST_CHECK(fake_pbft.consensus()->timeManager().m_lastSignTime <= utcTime());
 }
+/// test the parent of the block proposed in pipelined mode
+BOOST_AUTO_TEST_CASE(testPipelineParent)
+{
+    BlockHeader highest;
+    FakeConsensus<FakePBFTEngine> fake_pbft(1, ProtocolID::PBFT);
+    fake_pbft.consensus()->initPBFTEnv(
+        3 * fake_pbft.consensus()->timeManager().m_intervalBlockTime);
+    int64_t block_number = obtainBlockNumber(fake_pbft);
+    PrepareReq prepare_req;
+    KeyPair peer_keyPair = KeyPair::create();
+    fake_pbft.m_sealerList.push_back(peer_keyPair.pub());
+    fake_pbft.consensus()->appendSealer(peer_keyPair.pub());
+    FakeValidNodeNum(fake_pbft, 4);
+    fake_pbft.consensus()->setPipeline(true);
+    BlockHeader parent;
+    BOOST_CHECK(fake_pbft.consensus()->pipelineParent(parent) == false);
+
+    /// the block locked by 2f+1 signReqs is the parent of the next block
+    FakeSignAndCommitCache(
+        fake_pbft, prepare_req, highest, 0, 0, fake_pbft.consensus()->minValidNodes(), 0);
+    fake_pbft.consensus()->setView(prepare_req.view);
+    fake_pbft.consensus()->checkAndCommit();
+    CheckBlockChain(fake_pbft, block_number);
+    BOOST_CHECK(fake_pbft.consensus()->pipelineParent(parent) == true);
+    BOOST_CHECK(parent.hash() == prepare_req.pBlock->blockHeader().hash());
+    BOOST_CHECK(parent.number() == block_number);
+
+    /// the locked block is no longer a parent after committed
+    fake_pbft.consensus()->reqCache()->clearAll();
+    FakeSignAndCommitCache(
+        fake_pbft, prepare_req, highest, 0, 0, fake_pbft.consensus()->minValidNodes(), 2);
+    fake_pbft.consensus()->checkAndCommit();
+    CheckBlockChain(fake_pbft, block_number + 1);
+    BOOST_CHECK(fake_pbft.consensus()->pipelineParent(parent) == false);
+
+    /// disabled
+    fake_pbft.consensus()->setPipeline(false);
+    BOOST_CHECK(fake_pbft.consensus()->pipelineParent(parent) == false);
+}
+
+/// test reusing the executed block when it's proposed again in a new view
+BOOST_AUTO_TEST_CASE(testExecutedSealingCache)
+{
+    FakeConsensus<FakePBFTEngine> fake_pbft(1, ProtocolID::PBFT);
+    Block block;
+    fake_pbft.consensus()->resetBlock(block);
+    h256 proposalHash = block.header().hash();
+    Sealing sealing;
+    sealing.block = block;
+    sealing.block.header().setStateRoot(sha3("executed"));
+    sealing.p_execContext = std::make_shared<ExecutiveContext>();
+    fake_pbft.consensus()->cacheExecutedSealing(proposalHash, sealing);
+
+    Sealing executed;
+    BOOST_CHECK(fake_pbft.consensus()->loadExecutedSealing(proposalHash, executed) == true);
+    BOOST_CHECK(executed.p_execContext == sealing.p_execContext);
+    BOOST_CHECK(executed.block.header().hash() == sealing.block.header().hash());
+    /// the prepare re-generated from the committed prepare carries the executed hash
+    Sealing reproposed;
+    BOOST_CHECK(fake_pbft.consensus()->loadExecutedSealing(
+                    sealing.block.header().hash(), reproposed) == true);
+    BOOST_CHECK(reproposed.p_execContext == sealing.p_execContext);
+    Sealing unknown;
+    BOOST_CHECK(fake_pbft.consensus()->loadExecutedSealing(sha3("unknown"), unknown) == false);
+    BOOST_CHECK(unknown.p_execContext == nullptr);
+
+    /// dropped once the block number is committed
+    fake_pbft.consensus()->clearExecutedSealings(block.header().number() - 1);
+    BOOST_CHECK(fake_pbft.consensus()->loadExecutedSealing(proposalHash, executed) == true);
+    fake_pbft.consensus()->clearExecutedSealings(block.header().number());
+    BOOST_CHECK(fake_pbft.consensus()->loadExecutedSealing(proposalHash, executed) == false);
+}
+
 /// test isValidPrepare
 BOOST_AUTO_TEST_CASE(testIsValidPrepare)
 {
@@ -449,6 +611,87 @@ BOOST_AUTO_TEST_CASE(testHandlePrepareReq)
     CheckBlockChain(fake_pbft, block_number + 1);
 }
 
+/// test compact prepare: rebuild the block with the missed transactions
+BOOST_AUTO_TEST_CASE(testHandleCompactPrepareReq)
+{
+    FakeConsensus<FakePBFTEngine> fake_pbft(1, ProtocolID::PBFT);
+    fake_pbft.consensus()->initPBFTEnv(
+        3 * (fake_pbft.consensus()->timeManager().m_intervalBlockTime));
+    fake_pbft.consensus()->setOmitEmpty(false);
+    KeyPair key_pair;
+    PrepareReq req = FakePrepareReq(key_pair);
+    fakeValidPrepare(fake_pbft, req);
+    /// fill the block with transactions that are not in the txpool and re-sign the prepare
+    Transactions txs = fake_pbft.consensus()->blockChain()->getBlockByNumber(0)->transactions();
+    req.pBlock->setTransactions(txs);
+    req.pBlock->calTransactionRoot();
+    req.block_hash = req.pBlock->header().hash();
+    Secret sec = fake_pbft.m_secrets[req.idx];
+    req.sig = dev::sign(sec, req.block_hash);
+    req.sig2 = dev::sign(sec, req.fieldsWithoutBlock());
+
+    PrepareReq compact_req(req);
+    fake_pbft.consensus()->encodeCompactBlock(*req.pBlock, compact_req.block);
+    compact_req.pBlock = nullptr;
+    KeyPair peer_keyPair = KeyPair::create();
+    PBFTMsgPacket packet;
+    FakePBFTMsgPacket(packet, compact_req, CompactPrepareReqPacket, req.idx, peer_keyPair.pub());
+
+    /// all transactions missed: request them from the peer
+    PrepareReq prepare_req;
+    BOOST_CHECK(fake_pbft.consensus()->handleCompactPrepareMsg(prepare_req, packet) == false);
+    compareAsyncSendTime(fake_pbft, peer_keyPair.pub(), 1);
+    BOOST_CHECK(fake_pbft.consensus()->reqCache()->prepareCache().block_hash != req.block_hash);
+    /// duplicated compact prepare is ignored while waiting for the transactions
+    BOOST_CHECK(fake_pbft.consensus()->handleCompactPrepareMsg(prepare_req, packet) == false);
+    compareAsyncSendTime(fake_pbft, peer_keyPair.pub(), 1);
+    /// and requests the transactions again after timeout
+    fake_pbft.consensus()->setPartiallyPrepareTime(utcTime() - c_missedTxsTimeout);
+    BOOST_CHECK(fake_pbft.consensus()->handleCompactPrepareMsg(prepare_req, packet) == false);
+    compareAsyncSendTime(fake_pbft, peer_keyPair.pub(), 2);
+    /// the view change drops the waiting prepare, which is rebuilt when received again
+    fake_pbft.consensus()->checkAndChangeView();
+    BOOST_CHECK(!fake_pbft.consensus()->waitingMissedTxs());
+    BOOST_CHECK(fake_pbft.consensus()->handleCompactPrepareMsg(prepare_req, packet) == false);
+    compareAsyncSendTime(fake_pbft, peer_keyPair.pub(), 3);
+    BOOST_CHECK(fake_pbft.consensus()->waitingMissedTxs());
+
+    /// response with the missed transactions
+    RLPStream s;
+    s.appendList(2);
+    s << req.block_hash;
+    s.appendList(txs.size());
+    for (auto const& tx : txs)
+    {
+        bytes tx_data;
+        tx.encode(tx_data);
+        s.appendRaw(tx_data);
+    }
+    PBFTMsgPacket response;
+    s.swapOut(response.data);
+    response.packet_id = MissedTxsPacket;
+    response.setOtherField(req.idx, peer_keyPair.pub(), "");
+    fake_pbft.consensus()->handleMissedTxsMsg(response);
+    BOOST_CHECK(fake_pbft.consensus()->reqCache()->prepareCache().block_hash == req.block_hash);
+    /// the raw prepare keeps the whole block
+    bytes block_data;
+    req.pBlock->encode(block_data);
+    BOOST_CHECK(fake_pbft.consensus()->reqCache()->rawPrepareCache().block == block_data);
+
+    /// serve the transactions of the handled prepare to other nodes
+    KeyPair requester = KeyPair::create();
+    std::vector<h256> txsHash = {txs[1].sha3(), txs[0].sha3()};
+    RLPStream request;
+    request.appendList(2);
+    request << req.block_hash << txsHash;
+    PBFTMsgPacket request_packet;
+    request.swapOut(request_packet.data);
+    request_packet.packet_id = GetMissedTxsPacket;
+    request_packet.setOtherField(req.idx, requester.pub(), "");
+    fake_pbft.consensus()->handleGetMissedTxsMsg(request_packet);
+    compareAsyncSendTime(fake_pbft, requester.pub(), 1);
+}
+
 BOOST_AUTO_TEST_CASE(testIsValidSignReq)
 {
     FakeConsensus<FakePBFTEngine> fake_pbft(1, ProtocolID::PBFT);
@@ -459,6 +702,187 @@ BOOST_AUTO_TEST_CASE(testIsValidSignReq)
     TestIsValidSignReq(fake_pbft, pbftMsg, signReq, prepareReq, peer_keyPair, false);
 }
 
+/// test the signatures pre-verified out of the workLoop
+BOOST_AUTO_TEST_CASE(testPreVerifyMsg)
+{
+    FakeConsensus<FakePBFTEngine> fake_pbft(1, ProtocolID::PBFT);
+    PBFTMsgPacket packet;
+    SignReq signReq;
+    PrepareReq prepareReq;
+    KeyPair peer_keyPair = KeyPair::create();
+    FakeValidSignorCommitReq(fake_pbft, packet, signReq, prepareReq, peer_keyPair);
+
+    /// valid signatures: the packet is marked with the sealer that signed it
+    fake_pbft.consensus()->preVerifyMsg(packet);
+    BOOST_CHECK(packet.signVerifiedBy == KeyPair(fake_pbft.m_secrets[signReq.idx]).pub());
+    SignReq verifiedReq = signReq;
+    verifiedReq.signVerifiedBy = packet.signVerifiedBy;
+    BOOST_CHECK(fake_pbft.consensus()->checkSign(verifiedReq) == true);
+
+    /// invalid signatures: the packet is left to be checked by the workLoop
+    SignReq invalidReq = signReq;
+    invalidReq.sig2 = Signature();
+    PBFTMsgPacket invalidPacket;
+    FakePBFTMsgPacket(invalidPacket, invalidReq, SignReqPacket, packet.node_idx, packet.node_id);
+    fake_pbft.consensus()->preVerifyMsg(invalidPacket);
+    BOOST_CHECK(invalidPacket.signVerifiedBy == h512());
+    BOOST_CHECK(fake_pbft.consensus()->checkSign(invalidReq) == false);
+
+    /// the result verified against another node is ignored
+    invalidReq.signVerifiedBy = peer_keyPair.pub();
+    BOOST_CHECK(fake_pbft.consensus()->checkSign(invalidReq) == false);
+}
+
+/// test the signatures of the block verified in batches
+BOOST_AUTO_TEST_CASE(testCheckBlockSigList)
+{
+    FakeConsensus<FakePBFTEngine> fake_pbft(13, ProtocolID::PBFT);
+    Block block;
+    fake_pbft.consensus()->resetBlock(block);
+    block.header().setSealerList(fake_pbft.consensus()->sealerList());
+    block.header().setSealer(u256(0));
+    h256 hash = block.header().hash();
+    std::vector<std::pair<u256, Signature>> sig_list;
+    for (size_t i = 0; i < fake_pbft.consensus()->minValidNodes(); i++)
+    {
+        sig_list.push_back(std::make_pair(u256(i), dev::sign(fake_pbft.m_secrets[i], hash)));
+    }
+    block.setSigList(sig_list);
+    BOOST_CHECK(fake_pbft.consensus()->checkBlock(block) == true);
+
+    /// a sealer signing twice is counted once
+    auto duplicated = sig_list;
+    duplicated.back() = duplicated.front();
+    block.setSigList(duplicated);
+    BOOST_CHECK(fake_pbft.consensus()->checkBlock(block) == false);
+
+    /// an invalid signature in any batch fails the block
+    auto invalid = sig_list;
+    invalid.back().second = dev::sign(KeyPair::create().secret(), hash);
+    block.setSigList(invalid);
+    BOOST_CHECK(fake_pbft.consensus()->checkBlock(block) == false);
+    invalid = sig_list;
+    invalid.front().second = dev::sign(KeyPair::create().secret(), hash);
+    block.setSigList(invalid);
+    BOOST_CHECK(fake_pbft.consensus()->checkBlock(block) == false);
+
+    /// called on all the pool threads, the batches queued behind the callers are claimed by them
+    block.setSigList(sig_list);
+    auto pool = fake_pbft.consensus()->sigListVerifyPool();
+    std::vector<std::future<bool>> results;
+    for (size_t i = 0; i < c_sigListVerifyThreadNum; i++)
+    {
+        auto task = std::make_shared<std::packaged_task<bool()>>(
+            [&fake_pbft, &block]() { return fake_pbft.consensus()->checkBlock(block); });
+        results.push_back(task->get_future());
+        pool->enqueue([task]() { (*task)(); });
+    }
+    for (auto& result : results)
+    {
+        BOOST_REQUIRE(result.wait_for(std::chrono::seconds(30)) == std::future_status::ready);
+        BOOST_CHECK(result.get() == true);
+    }
+    /// the batches are verified by the caller after the pool stopped
+    pool->stop();
+    BOOST_CHECK(fake_pbft.consensus()->checkBlock(block) == true);
+}
+
+/// test the prepare disseminated along the broadcast tree
+BOOST_AUTO_TEST_CASE(testTreeBroadcastMsg)
+{
+    FakeConsensus<FakePBFTEngine> fake_pbft(12, ProtocolID::PBFT);
+    FakePBFTSealer(fake_pbft);
+    fake_pbft.consensus()->setTreeBroadcastWidth(3);
+    IDXTYPE root = fake_pbft.consensus()->nodeIdx();
+    BOOST_CHECK(root == 12);
+    /// the tree is ordered from the root
+    BOOST_CHECK(fake_pbft.consensus()->treeChildren(root, root) == std::vector<IDXTYPE>({0, 1, 2}));
+    BOOST_CHECK(fake_pbft.consensus()->treeChildren(root, 0) == std::vector<IDXTYPE>({3, 4, 5}));
+    BOOST_CHECK(fake_pbft.consensus()->treeChildren(root, 3) == std::vector<IDXTYPE>());
+    BOOST_CHECK(fake_pbft.consensus()->treeChildren(5, 5) == std::vector<IDXTYPE>({6, 7, 8}));
+
+    KeyPair key_pair;
+    PrepareReq prepare_req = FakePrepareReq(key_pair);
+    bytes data;
+    prepare_req.encode(data);
+    /// the root only sends to its children
+    fake_pbft.consensus()->treeBroadcastMsg(PrepareReqPacket, "tree1", ref(data), root);
+    for (size_t i = 0; i < 12; i++)
+    {
+        compareAsyncSendTime(fake_pbft, fake_pbft.m_sealerList[i], (i < 3 ? 1 : 0));
+    }
+    /// the children of the disconnected child are served by the root
+    FakeService* service =
+        dynamic_cast<FakeService*>(fake_pbft.consensus()->mutableService().get());
+    service->clearSessionInfo();
+    for (size_t i = 1; i < fake_pbft.m_sealerList.size(); i++)
+    {
+        appendSessionInfo(fake_pbft, fake_pbft.m_sealerList[i]);
+    }
+    fake_pbft.consensus()->treeBroadcastMsg(PrepareReqPacket, "tree2", ref(data), root);
+    compareAsyncSendTime(fake_pbft, fake_pbft.m_sealerList[0], 1);
+    for (size_t i = 1; i < 12; i++)
+    {
+        compareAsyncSendTime(fake_pbft, fake_pbft.m_sealerList[i], (i < 3 ? 2 : (i < 6 ? 1 : 0)));
+    }
+}
+
+/// the prepare is broadcast to all the sealers if it is not signed in time along the tree
+BOOST_AUTO_TEST_CASE(testTreeBroadcastTimeout)
+{
+    FakeConsensus<FakePBFTEngine> fake_pbft(1, ProtocolID::PBFT);
+    fake_pbft.consensus()->initPBFTEnv(
+        3 * (fake_pbft.consensus()->timeManager().m_intervalBlockTime));
+    PrepareReq req;
+    TestIsValidPrepare(fake_pbft, req, true);
+    for (size_t i = 0; i < fake_pbft.m_sealerList.size(); i++)
+    {
+        appendSessionInfo(fake_pbft, fake_pbft.m_sealerList[i]);
+    }
+    fake_pbft.consensus()->reqCache()->clearAll();
+    fake_pbft.consensus()->setOmitEmpty(false);
+    fake_pbft.consensus()->handlePrepareMsg(req);
+    /// the sealers sign the executed block, whose hash differs from the raw prepare
+    PrepareReq executed = req;
+    executed.block_hash = sha3(req.block_hash);
+    fake_pbft.consensus()->reqCache()->addPrepareReq(executed);
+    for (size_t i = 0; i < fake_pbft.m_sealerList.size(); i++)
+    {
+        compareAsyncSendTime(fake_pbft, fake_pbft.m_sealerList[i], 1);
+    }
+
+    bytes data;
+    req.encode(data);
+    fake_pbft.consensus()->setTreePrepare(req, data, utcTime());
+    fake_pbft.consensus()->checkTreeBroadcastTimeout();
+    for (size_t i = 0; i < fake_pbft.m_sealerList.size(); i++)
+    {
+        compareAsyncSendTime(fake_pbft, fake_pbft.m_sealerList[i], 1);
+    }
+    /// timeout without 2f+1 signatures: fall back to the full broadcast once
+    fake_pbft.consensus()->setTreePrepare(req, data, utcTime() - c_treeBroadcastTimeout - 1);
+    fake_pbft.consensus()->checkTreeBroadcastTimeout();
+    fake_pbft.consensus()->checkTreeBroadcastTimeout();
+    for (size_t i = 0; i < fake_pbft.m_sealerList.size(); i++)
+    {
+        compareAsyncSendTime(fake_pbft, fake_pbft.m_sealerList[i], 2);
+    }
+}
+
+/// the timeouts of the sealers are appended after the items read by position
+BOOST_AUTO_TEST_CASE(testConsensusStatus)
+{
+    FakeConsensus<FakePBFTEngine> fake_pbft(1, ProtocolID::PBFT);
+    json_spirit::Value value;
+    BOOST_REQUIRE(json_spirit::read_string(fake_pbft.consensus()->consensusStatus(), value));
+    json_spirit::Array const& status = value.get_array();
+    BOOST_REQUIRE(status.size() == 9);
+    BOOST_CHECK(status[1].type() == json_spirit::array_type);
+    BOOST_CHECK(status[2].get_obj()[0].name_ == "prepareCache_blockHash");
+    BOOST_CHECK(status[7].get_obj()[0].name_ == "viewChangeCache_cachedSize");
+    BOOST_CHECK(status.back().type() == json_spirit::array_type);
+}
+
 /// test handleSignMsg
 BOOST_AUTO_TEST_CASE(testHandleSignMsg)
 {
@@ -100,7 +100,9 @@ void CheckOnRecvPBFTMessage(std::shared_ptr<FakePBFTEngine> pbft,
 {
     P2PMessage::Ptr message_ptr = FakeReqMessage(pbft, req, packetType, ProtocolID::PBFT);
     pbft->onRecvPBFTMessage(NetworkException(), session, message_ptr);
-    std::pair<bool, PBFTMsgPacket> ret = pbft->mutableMsgQueue().tryPop(unsigned(5));
+    /// the valid message is pushed into the queue after the signatures are pre-verified
+    std::pair<bool, PBFTMsgPacket> ret =
+        pbft->mutableMsgQueue().tryPop(valid ? unsigned(1000) : unsigned(5));
     if (valid == true)
     {
         BOOST_CHECK(ret.first == true);
@@ -259,18 +261,17 @@ static void checkReportBlock(
 static void checkBackupMsg(FakeConsensus<FakePBFTEngine>& fake_pbft, std::string const& key,
     bytes const& msgData, bool shouldClean = true)
 {
-    BOOST_CHECK(fake_pbft.consensus()->backupDB());
+    BOOST_CHECK(fake_pbft.consensus()->backupWAL());
     /// insert succ
-    std::string data = fake_pbft.consensus()->backupDB()->lookup(key);
+    bytes data = fake_pbft.consensus()->backupWAL()->lookup(key);
     if (msgData.size() == 0)
         BOOST_CHECK(data.empty() == true);
     else
     {
-        BOOST_CHECK(data == toHex(msgData));
+        BOOST_CHECK(data == msgData);
         /// remove the key
-        std::string empty = "";
         if (shouldClean)
-            fake_pbft.consensus()->backupDB()->insert(key, empty);
+            fake_pbft.consensus()->backupWAL()->append(key, bytesConstRef());
     }
 }
 
@@ -105,6 +105,33 @@ BOOST_AUTO_TEST_CASE(testSigListSetting)
         BOOST_CHECK(!!p);
     }
 }
+/// test generateAndSetSigList with only the signatures of a quorum
+BOOST_AUTO_TEST_CASE(testSigListCertificate)
+{
+    size_t node_num = 5;
+    size_t quorum = 3;
+    PBFTReqCache req_cache(0);
+    KeyPair key_pair;
+    PrepareReq prepare_req = FakePrepareReq(key_pair);
+    req_cache.addPrepareReq(prepare_req);
+    for (size_t i = 0; i < node_num; i++)
+    {
+        KeyPair key = KeyPair::create();
+        CommitReq commit_req(prepare_req, key, node_num - i - 1);
+        req_cache.addCommitReq(commit_req);
+    }
+    Block block;
+    BOOST_CHECK(req_cache.generateAndSetSigList(block, quorum, true));
+    /// the certificate holds the first quorum signers ordered by index
+    BOOST_CHECK(block.sigList().size() == quorum);
+    for (size_t i = 0; i < quorum; i++)
+    {
+        BOOST_CHECK(block.sigList()[i].first == u256(i));
+    }
+    /// all the signatures are kept without the certificate
+    BOOST_CHECK(req_cache.generateAndSetSigList(block, quorum));
+    BOOST_CHECK(block.sigList().size() == node_num);
+}
 /// test collectGarbage
 BOOST_AUTO_TEST_CASE(testCollectGarbage)
 {
@@ -208,6 +208,14 @@ BOOST_AUTO_TEST_CASE(testGenerateMsg)
     BOOST_CHECK(hb.leader == raftEngine->nodeIdx());
     BOOST_CHECK(hb.uncommitedBlockNumber == 10);
 
+    /// the heartbeat sent to the followers which have received the block
+    hbMsg = raftEngine->generateHeartbeat(false);
+    data = *(hbMsg->buffer());
+    packet.decode(ref(data));
+    hb.populate(RLP(ref(packet.data))[0]);
+    BOOST_CHECK(hb.hasData() == false);
+    BOOST_CHECK(hb.uncommitedBlockNumber == 0);
+
     auto vrMsg = raftEngine->generateVoteReq();
     BOOST_CHECK(vrMsg->protocolID() == raftEngine->protocolId());
 
@@ -635,6 +643,42 @@ BOOST_AUTO_TEST_CASE(testTryCommitUncommitedBlock)
     BOOST_CHECK_NO_THROW(raftEngine->tryCommitUncommitedBlock(resp));
 }
 
+BOOST_AUTO_TEST_CASE(testCommitFollowerBlock)
+{
+    auto number = raftEngine->getBlockChain()->number();
+    auto block = fakeBlock.m_block;
+    block.header().setNumber(number + 1);
+    auto parent = raftEngine->getBlockChain()->getBlockByNumber(number);
+    block.header().setParentHash(parent->header().hash());
+    block.header().setSealerList(fakeSealerList);
+    raftEngine->setUncommitedBlock(block);
+    raftEngine->setUncommitedNumber(number + 1);
+
+    RaftHeartBeat hb;
+    /// the leader has not committed the block
+    hb.height = number;
+    hb.blockHash = parent->header().hash();
+    raftEngine->commitFollowerBlock(hb);
+    raftEngine->waitFollowerCommit();
+    BOOST_CHECK(raftEngine->getBlockChain()->number() == number);
+
+    /// the executed block differs from the block committed by the leader
+    hb.height = number + 1;
+    hb.blockHash = h256(1);
+    raftEngine->commitFollowerBlock(hb);
+    raftEngine->waitFollowerCommit();
+    BOOST_CHECK(raftEngine->getBlockChain()->number() == number);
+    BOOST_CHECK(bool(raftEngine->getUncommitedBlock()));
+
+    /// commit the replicated block on the commit thread
+    hb.blockHash = block.header().hash();
+    raftEngine->commitFollowerBlock(hb);
+    raftEngine->waitFollowerCommit();
+    BOOST_CHECK(raftEngine->getBlockChain()->number() == number + 1);
+    BOOST_CHECK(raftEngine->getHighestBlock().number() == number + 1);
+    BOOST_CHECK(!bool(raftEngine->getUncommitedBlock()));
+}
+
 BOOST_AUTO_TEST_CASE(testShouldSeal)
 {
     raftEngine->setState(RaftRole::EN_STATE_FOLLOWER);
@@ -0,0 +1,80 @@
+/**
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2018 fisco-dev contributors.
+ *
+ * @brief unit test for IOServicePool
+ *
+ * @file IOServicePool.cpp
+ * @date 2019-06-26
+ */
+
+#include <libdevcore/IOServicePool.h>
+#include <test/tools/libutils/TestOutputHelper.h>
+#include <boost/test/unit_test.hpp>
+#include <future>
+
+using namespace dev;
+using namespace std;
+
+namespace dev
+{
+namespace test
+{
+BOOST_FIXTURE_TEST_SUITE(IOServicePoolTest, TestOutputHelperFixture)
+
+BOOST_AUTO_TEST_CASE(roundRobin)
+{
+    IOServicePool pool("IOTest", 3);
+    BOOST_CHECK_EQUAL(pool.size(), 3);
+    auto first = pool.next();
+    BOOST_CHECK_EQUAL(pool.indexOf(*first), 0);
+    BOOST_CHECK_EQUAL(pool.indexOf(*pool.next()), 1);
+    BOOST_CHECK_EQUAL(pool.indexOf(*pool.next()), 2);
+    BOOST_CHECK(pool.next() == first);
+    boost::asio::io_service other;
+    BOOST_CHECK_EQUAL(pool.indexOf(other), pool.size());
+
+    BOOST_CHECK(IOServicePool("IOTest", 0).size() > 0);
+}
+
+BOOST_AUTO_TEST_CASE(handledTasks)
+{
+    IOServicePool pool("IOTest", 2);
+    pool.start();
+    /// the handlers posted to an io_service run on its own thread
+    std::vector<std::future<std::thread::id>> threads;
+    for (size_t i = 0; i < 4; ++i)
+    {
+        auto task = std::make_shared<std::packaged_task<std::thread::id()>>(
+            []() { return std::this_thread::get_id(); });
+        threads.push_back(task->get_future());
+        pool.next()->post([task]() { (*task)(); });
+    }
+    std::vector<std::thread::id> ids;
+    for (auto& thread : threads)
+        ids.push_back(thread.get());
+    BOOST_CHECK(ids[0] == ids[2]);
+    BOOST_CHECK(ids[1] == ids[3]);
+    BOOST_CHECK(ids[0] != ids[1]);
+
+    pool.stop();
+    auto handled = pool.handledTasks();
+    BOOST_CHECK_EQUAL(handled.size(), 2);
+    BOOST_CHECK_EQUAL(handled[0] + handled[1], 4);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+}  // namespace test
+}  // namespace dev
@@ -27,6 +27,7 @@
 #include <libdevcore/CommonIO.h>
 
 #include <libdevcore/Assertions.h>
+#include <libp2p/CompressStatistics.h>
 #include <libp2p/P2PMessage.h>
 #include <test/tools/libutils/TestOutputHelper.h>
 #include <boost/test/unit_test.hpp>
@@ -151,6 +152,109 @@ BOOST_AUTO_TEST_CASE(testMessage)
     BOOST_CHECK_EQUAL("topic", t);
 }
 
+/// the payload is shared instead of being copied after the header
+BOOST_AUTO_TEST_CASE(testEncodeHeader)
+{
+    auto msg = std::make_shared<p2p::P2PMessage>();
+    msg->setProtocolID(2);
+    msg->setSeq(1);
+    msg->setBuffer(std::make_shared<bytes>(1024, 0xab));
+
+    bytes header;
+    auto payload = msg->encodeHeader(header);
+    BOOST_CHECK(payload == msg->buffer());
+    BOOST_CHECK_EQUAL(header.size(), p2p::P2PMessage::HEADER_LENGTH);
+    header.insert(header.end(), payload->begin(), payload->end());
+    bytes encoded;
+    msg->encode(encoded);
+    BOOST_CHECK(header == encoded);
+}
+
+BOOST_AUTO_TEST_CASE(testCompress)
+{
+    auto msg = std::make_shared<p2p::P2PMessage>();
+    msg->setProtocolID(9);
+    msg->setPacketType(2);
+    msg->setSeq(1);
+    msg->setBuffer(std::make_shared<bytes>(p2p::P2PMessage::COMPRESS_THRESHOLD * 4, 0xab));
+    auto before = p2p::CompressStatistics::instance().counters()[9];
+
+    /// the payload is compressed only if the peer supports it
+    bytes raw;
+    msg->encode(raw);
+    msg->setCompress(true);
+    bytes compressed;
+    msg->encode(compressed);
+    BOOST_CHECK(compressed.size() < raw.size());
+    auto message = std::make_shared<p2p::P2PMessage>();
+    BOOST_CHECK_EQUAL(message->decode(compressed.data(), compressed.size()), compressed.size());
+    BOOST_CHECK_EQUAL(message->packetType(), 2);
+    BOOST_CHECK(*message->buffer() == *msg->buffer());
+
+    /// compressed once for all the sessions
+    msg->encode(compressed);
+    auto after = p2p::CompressStatistics::instance().counters()[9];
+    BOOST_CHECK_EQUAL(after.compressedMessages, before.compressedMessages + 1);
+    BOOST_CHECK_EQUAL(after.uncompressedMessages, before.uncompressedMessages + 1);
+    BOOST_CHECK(after.compressedBytes - before.compressedBytes <
+                after.rawBytes - before.rawBytes);
+
+    /// the small payloads are sent as is
+    msg->setBuffer(std::make_shared<bytes>(p2p::P2PMessage::COMPRESS_THRESHOLD - 1, 0xab));
+    msg->encode(compressed);
+    BOOST_CHECK_EQUAL(compressed.size(), p2p::P2PMessage::HEADER_LENGTH + msg->buffer()->size());
+
+    /// the payloads over the message limit are sent as is
+    msg->setBuffer(std::make_shared<bytes>(p2p::P2PMessage::MAX_LENGTH + 1, 0xab));
+    msg->encode(compressed);
+    BOOST_CHECK_EQUAL(compressed.size(), p2p::P2PMessage::HEADER_LENGTH + msg->buffer()->size());
+    message = std::make_shared<p2p::P2PMessage>();
+    BOOST_CHECK_EQUAL(message->decode(compressed.data(), compressed.size()), compressed.size());
+    BOOST_CHECK(*message->buffer() == *msg->buffer());
+}
+
+BOOST_AUTO_TEST_CASE(testDecodeForgedCompress)
+{
+    /// a compressed payload of the uncompressed length in varint followed by the data
+    auto encodeCompressed = [](uint64_t _uncompressedLength, bytes const& _data) {
+        bytes payload;
+        while (_uncompressedLength >= 0x80)
+        {
+            payload.push_back(byte(_uncompressedLength | 0x80));
+            _uncompressedLength >>= 7;
+        }
+        payload.push_back(byte(_uncompressedLength));
+        payload += _data;
+        uint32_t length = htonl(p2p::P2PMessage::HEADER_LENGTH + payload.size());
+        PROTOCOL_ID protocolID = htons(9);
+        PACKET_TYPE packetType = htons(2 | p2p::P2PMessage::COMPRESS_FLAG);
+        uint32_t seq = htonl(1);
+        bytes buffer;
+        buffer.insert(buffer.end(), (byte*)&length, (byte*)&length + sizeof(length));
+        buffer.insert(buffer.end(), (byte*)&protocolID, (byte*)&protocolID + sizeof(protocolID));
+        buffer.insert(buffer.end(), (byte*)&packetType, (byte*)&packetType + sizeof(packetType));
+        buffer.insert(buffer.end(), (byte*)&seq, (byte*)&seq + sizeof(seq));
+        return buffer + payload;
+    };
+
+    /// a length over the limit is rejected without allocating it
+    auto message = std::make_shared<p2p::P2PMessage>();
+    bytes forged = encodeCompressed(200 * 1024 * 1024, bytes(16, 0xff));
+    BOOST_CHECK_EQUAL(message->decode(forged.data(), forged.size()), dev::network::PACKET_ERROR);
+    BOOST_CHECK_EQUAL(message->buffer()->size(), 0u);
+
+    /// so is a length within the limit the data doesn't uncompress to
+    forged = encodeCompressed(p2p::P2PMessage::MAX_LENGTH, bytes(16, 0xff));
+    BOOST_CHECK_EQUAL(message->decode(forged.data(), forged.size()), dev::network::PACKET_ERROR);
+    BOOST_CHECK_EQUAL(message->buffer()->size(), 0u);
+
+    /// a literal of 4 bytes is valid
+    bytes literal{byte(3 << 2), 0x01, 0x02, 0x03, 0x04};
+    bytes valid = encodeCompressed(4, literal);
+    BOOST_CHECK_EQUAL(message->decode(valid.data(), valid.size()), valid.size());
+    BOOST_CHECK(*message->buffer() == bytes({0x01, 0x02, 0x03, 0x04}));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 }  // namespace test
 }  // namespace dev
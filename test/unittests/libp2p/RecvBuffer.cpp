@@ -0,0 +1,115 @@
+/**
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2018 fisco-dev contributors.
+ *
+ * @brief: unit test for RecvBuffer
+ *
+ * @file RecvBuffer.cpp
+ * @date 2019-06-24
+ */
+
+#include "libnetwork/RecvBuffer.h"
+#include <libp2p/P2PMessage.h>
+#include <test/tools/libutils/TestOutputHelper.h>
+#include <boost/test/unit_test.hpp>
+
+using namespace dev;
+using namespace dev::network;
+
+namespace dev
+{
+namespace test
+{
+BOOST_FIXTURE_TEST_SUITE(RecvBufferTest, TestOutputHelperFixture)
+
+/// simulate the socket reading @a _data into the buffer
+static size_t receive(RecvBuffer& _buffer, bytesConstRef _data)
+{
+    auto space = _buffer.prepare();
+    size_t size = std::min(_data.size(), boost::asio::buffer_size(space));
+    std::memcpy(boost::asio::buffer_cast<byte*>(space), _data.data(), size);
+    _buffer.commit(size);
+    return size;
+}
+
+static bytes encodeMessage(uint32_t _seq, size_t _payloadSize)
+{
+    auto msg = std::make_shared<p2p::P2PMessage>();
+    msg->setProtocolID(2);
+    msg->setPacketType(2);
+    msg->setSeq(_seq);
+    msg->setBuffer(std::make_shared<bytes>(_payloadSize, byte(_seq)));
+    msg->setLength(p2p::P2PMessage::HEADER_LENGTH + _payloadSize);
+    bytes out;
+    msg->encode(out);
+    return out;
+}
+
+BOOST_AUTO_TEST_CASE(decodeInPlace)
+{
+    RecvBuffer buffer(c_minRecvSpace * 2);
+    bytes stream;
+    for (uint32_t seq = 1; seq <= 3; ++seq)
+    {
+        bytes msg = encodeMessage(seq, c_minRecvSpace * seq);
+        stream.insert(stream.end(), msg.begin(), msg.end());
+    }
+
+    /// the messages larger than the buffer grow it, and are decoded as they complete
+    uint32_t decoded = 0;
+    size_t offset = 0;
+    while (offset < stream.size())
+    {
+        offset += receive(buffer, bytesConstRef(&stream).cropped(offset));
+        while (true)
+        {
+            auto message = std::make_shared<p2p::P2PMessage>();
+            ssize_t result = message->decode(buffer.data(), buffer.size());
+            if (result <= 0)
+                break;
+            ++decoded;
+            BOOST_CHECK_EQUAL(message->seq(), decoded);
+            BOOST_CHECK_EQUAL(message->buffer()->size(), c_minRecvSpace * decoded);
+            BOOST_CHECK(message->buffer()->back() == byte(decoded));
+            buffer.consume(result);
+        }
+    }
+    BOOST_CHECK_EQUAL(decoded, 3);
+    BOOST_CHECK_EQUAL(buffer.size(), 0);
+    BOOST_CHECK(buffer.capacity() > c_minRecvSpace * 2);
+}
+
+BOOST_AUTO_TEST_CASE(shrinkWhenDrained)
+{
+    RecvBuffer buffer;
+    bytes data(c_maxIdleRecvBufferSize + 1);
+    size_t offset = 0;
+    while (offset < data.size())
+        offset += receive(buffer, bytesConstRef(&data).cropped(offset));
+    BOOST_CHECK_EQUAL(buffer.size(), data.size());
+    BOOST_CHECK(buffer.capacity() > c_maxIdleRecvBufferSize);
+
+    /// the partial bytes are kept at the front when the space runs out
+    buffer.consume(data.size() - 1);
+    BOOST_CHECK_EQUAL(buffer.size(), 1);
+    buffer.prepare();
+    BOOST_CHECK_EQUAL(buffer.size(), 1);
+    buffer.consume(1);
+    BOOST_CHECK_EQUAL(buffer.capacity(), c_recvBufferSize);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+}  // namespace test
+}  // namespace dev
@@ -0,0 +1,168 @@
+/**
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2018 fisco-dev contributors.
+ *
+ * @brief: the throughput of the session writing over loopback
+ *
+ * @file SessionWrite.cpp
+ * @date 2019-06-25
+ */
+
+#include <libdevcore/ThreadPool.h>
+#include <libnetwork/ASIOInterface.h>
+#include <libnetwork/Host.h>
+#include <libnetwork/Session.h>
+#include <libp2p/P2PMessage.h>
+#include <test/tools/libutils/TestOutputHelper.h>
+#include <boost/test/unit_test.hpp>
+#include <atomic>
+#include <thread>
+
+using namespace dev;
+using namespace dev::network;
+using namespace dev::p2p;
+
+namespace dev
+{
+namespace test
+{
+/// a host with the network up, without listening and handshaking
+class LoopbackHost : public Host
+{
+public:
+    virtual bool haveNetwork() const override { return true; }
+};
+
+/// two sessions connected by the plain tcp sockets over loopback
+class LoopbackFixture : public TestOutputHelperFixture
+{
+public:
+    LoopbackFixture()
+    {
+        ioService = std::make_shared<ba::io_service>();
+        asioInterface = std::make_shared<ASIOInterface>();
+        asioInterface->setIOService(ioService);
+        asioInterface->setSSLContext(std::make_shared<ba::ssl::context>(ba::ssl::context::tlsv12));
+        asioInterface->setType(ASIOInterface::TCP_ONLY);
+        asioInterface->init("127.0.0.1", 0);
+
+        host = std::make_shared<LoopbackHost>();
+        host->setASIOInterface(asioInterface);
+        host->setThreadPool(std::make_shared<dev::ThreadPool>("LoopbackTest", 1));
+        host->setMessageFactory(std::make_shared<P2PMessageFactory>());
+
+        auto clientSocket = asioInterface->newSocket();
+        auto serverSocket = asioInterface->newSocket();
+        clientSocket->ref().connect(asioInterface->acceptor()->local_endpoint());
+        asioInterface->acceptor()->accept(serverSocket->ref());
+        sender = createSession(clientSocket);
+        receiver = createSession(serverSocket);
+        receiver->setMessageHandler(
+            [this](NetworkException _e, SessionFace::Ptr, Message::Ptr _message) {
+                if (_e.errorCode() != P2PExceptionType::Success || !_message)
+                    return;
+                if (_message->seq() != received + 1)
+                    outOfOrder = true;
+                receivedBytes += _message->length();
+                ++received;
+            });
+
+        work = std::make_shared<ba::io_service::work>(*ioService);
+        ioThread = std::thread([this]() { ioService->run(); });
+        sender->start();
+        receiver->start();
+    }
+
+    ~LoopbackFixture()
+    {
+        sender->socket()->close();
+        receiver->socket()->close();
+        work.reset();
+        ioService->stop();
+        ioThread.join();
+        host->threadPool()->stop();
+        sender.reset();
+        receiver.reset();
+    }
+
+    Session::Ptr createSession(std::shared_ptr<SocketFace> _socket)
+    {
+        auto session = std::make_shared<Session>();
+        session->setHost(host);
+        session->setSocket(_socket);
+        session->setMessageFactory(host->messageFactory());
+        return session;
+    }
+
+    /// send @a _count messages with @a _payloadSize bytes, @returns the seconds to receive all
+    double transfer(uint32_t _count, size_t _payloadSize)
+    {
+        auto start = std::chrono::steady_clock::now();
+        for (uint32_t seq = 1; seq <= _count; ++seq)
+        {
+            auto message = std::make_shared<P2PMessage>();
+            message->setProtocolID(2);
+            message->setPacketType(2);
+            message->setSeq(seq);
+            message->setBuffer(std::make_shared<bytes>(_payloadSize, byte(seq)));
+            message->setLength(P2PMessage::HEADER_LENGTH + _payloadSize);
+            sender->asyncSendMessage(message);
+        }
+        auto deadline = start + std::chrono::seconds(30);
+        while (received < _count && std::chrono::steady_clock::now() < deadline)
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    std::shared_ptr<ba::io_service> ioService;
+    std::shared_ptr<ASIOInterface> asioInterface;
+    std::shared_ptr<LoopbackHost> host;
+    Session::Ptr sender;
+    Session::Ptr receiver;
+    std::shared_ptr<ba::io_service::work> work;
+    std::thread ioThread;
+
+    std::atomic<uint32_t> received = {0};
+    std::atomic<uint64_t> receivedBytes = {0};
+    std::atomic<bool> outOfOrder = {false};
+};
+
+BOOST_FIXTURE_TEST_SUITE(SessionWriteTest, LoopbackFixture)
+
+/// a burst of small messages, e.g. the consensus votes, written in batches
+BOOST_AUTO_TEST_CASE(smallMessagesThroughput)
+{
+    uint32_t count = 20000;
+    double seconds = transfer(count, 128);
+    BOOST_CHECK_EQUAL(received, count);
+    BOOST_CHECK(!outOfOrder);
+    BOOST_TEST_MESSAGE("small messages: " << count / seconds << " msg/s, "
+                                          << receivedBytes / seconds / 1024 / 1024 << " MB/s");
+}
+
+/// the messages larger than the batch are written without copying
+BOOST_AUTO_TEST_CASE(largeMessagesThroughput)
+{
+    uint32_t count = 200;
+    double seconds = transfer(count, c_maxWriteBatchBytes * 4);
+    BOOST_CHECK_EQUAL(received, count);
+    BOOST_CHECK(!outOfOrder);
+    BOOST_TEST_MESSAGE("large messages: " << count / seconds << " msg/s, "
+                                          << receivedBytes / seconds / 1024 / 1024 << " MB/s");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+}  // namespace test
+}  // namespace dev
@@ -294,6 +294,16 @@ public:
         dev::eth::TransactionReceipt reciept;
         return std::make_pair(res, reciept);
     }
+    std::shared_ptr<ExecutiveContext> createExecutiveContext(BlockInfo const&) override
+    {
+        return m_executiveContext;
+    }
+    void executeNextTransaction(dev::eth::Block& block, dev::eth::Transaction const&,
+        std::shared_ptr<ExecutiveContext>) override
+    {
+        block.appendTransactionReceipt(dev::eth::TransactionReceipt());
+    }
+    void finalizeExecutedBlock(dev::eth::Block&, std::shared_ptr<ExecutiveContext>) override {}
 
 private:
     std::shared_ptr<ExecutiveContext> m_executiveContext;
@@ -366,13 +376,10 @@ public:
         return ImportResult::Success;
     }
 
-    SharedMutex& xtransactionKnownBy() override { return x_transactionKnownBy; }
-
 private:
     Transactions transactions;
     Transaction transaction;
     PROTOCOL_ID protocolId = 0;
-    mutable dev::SharedMutex x_transactionKnownBy;
 };
 
 class MockBlockSync : public SyncInterface
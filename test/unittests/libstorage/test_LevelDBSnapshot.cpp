@@ -0,0 +1,248 @@
+/*
+ * @CopyRight:
+ * FISCO-BCOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * FISCO-BCOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with FISCO-BCOS.  If not, see <http://www.gnu.org/licenses/>
+ * (c) 2016-2018 fisco-dev contributors.
+ */
+
+#include <libdevcore/BasicLevelDB.h>
+#include <libdevcore/LevelDB.h>
+#include <libdevcore/RLP.h>
+#include <libdevcrypto/Hash.h>
+#include <libstorage/Common.h>
+#include <libstorage/LevelDBStorage.h>
+#include <test/unittests/libethcore/FakeBlock.h>
+#include <boost/filesystem.hpp>
+#include <boost/test/unit_test.hpp>
+
+using namespace dev;
+using namespace dev::eth;
+using namespace dev::storage;
+
+namespace test_LevelDBSnapshot
+{
+struct LevelDBSnapshotFixture
+{
+    LevelDBSnapshotFixture()
+    {
+        path = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path();
+        source = createStorage("source");
+        target = createStorage("target");
+    }
+    ~LevelDBSnapshotFixture()
+    {
+        source.reset();
+        target.reset();
+        boost::filesystem::remove_all(path);
+    }
+
+    LevelDBStorage::Ptr createStorage(std::string const& _name)
+    {
+        auto db = std::make_shared<dev::db::BasicLevelDB>(
+            dev::db::LevelDB::defaultDBOptions(), (path / _name).string());
+        auto storage = std::make_shared<LevelDBStorage>();
+        storage->setDB(db);
+        return storage;
+    }
+
+    /// commit the block writing the value to the tables
+    void commit(int64_t _number, std::vector<std::string> const& _tables)
+    {
+        std::vector<TableData::Ptr> datas;
+        for (auto const& table : _tables)
+        {
+            auto entries = std::make_shared<Entries>();
+            auto entry = std::make_shared<Entry>();
+            entry->setField("value", std::to_string(_number));
+            entries->addEntry(entry);
+            auto tableData = std::make_shared<TableData>();
+            tableData->tableName = table;
+            tableData->data.insert(std::make_pair(std::string("key"), entries));
+            datas.push_back(tableData);
+        }
+        source->commit(h256(_number), _number, datas, h256(_number));
+    }
+
+    /// commit the block as the blockchain does, with the given signature list
+    void commitBlock(LevelDBStorage::Ptr _storage, Block _block,
+        std::vector<std::pair<u256, Signature>> const& _sigList)
+    {
+        _block.setSigList(_sigList);
+        bytes blockData;
+        _block.encode(blockData);
+        std::vector<TableData::Ptr> datas;
+        auto addEntry = [&datas](std::string const& _table, std::string const& _key,
+                            std::string const& _value) {
+            auto entries = std::make_shared<Entries>();
+            auto entry = std::make_shared<Entry>();
+            entry->setField(SYS_VALUE, _value);
+            entries->addEntry(entry);
+            auto tableData = std::make_shared<TableData>();
+            tableData->tableName = _table;
+            tableData->data.insert(std::make_pair(_key, entries));
+            datas.push_back(tableData);
+        };
+        addEntry(SYS_HASH_2_BLOCK, _block.blockHeader().hash().hex(), toHexPrefixed(blockData));
+        addEntry(SYS_CURRENT_STATE, SYS_KEY_CURRENT_NUMBER, "1");
+        addEntry("t_test", "key", "1");
+        _storage->commit(_block.blockHeader().hash(), 1, datas, _block.blockHeader().hash());
+    }
+
+    std::string select(LevelDBStorage::Ptr _storage, std::string const& _table)
+    {
+        auto entries = _storage->select(h256(), 0, _table, "key");
+        if (entries->size() == 0)
+        {
+            return "";
+        }
+        return entries->get(0)->getField("value");
+    }
+
+    boost::filesystem::path path;
+    LevelDBStorage::Ptr source;
+    LevelDBStorage::Ptr target;
+};
+
+BOOST_FIXTURE_TEST_SUITE(LevelDBSnapshot, LevelDBSnapshotFixture)
+
+BOOST_AUTO_TEST_CASE(exportAndImport)
+{
+    source->setSnapshotInterval(2);
+    commit(1, {"t_test"});
+    BOOST_CHECK(source->snapshot() == nullptr);
+    commit(2, {"t_test", SYS_CURRENT_STATE});
+    auto snapshot = source->snapshot();
+    BOOST_REQUIRE(snapshot != nullptr);
+    BOOST_CHECK_EQUAL(snapshot->number(), 2);
+    BOOST_CHECK(snapshot->blockHash() == h256(2));
+    /// the snapshot is not changed by the later blocks
+    commit(3, {"t_test"});
+    BOOST_CHECK(source->snapshot(2) == snapshot);
+    BOOST_CHECK(source->snapshot(3) == nullptr);
+
+    auto chunkHashes = snapshot->chunkHashes();
+    BOOST_REQUIRE(chunkHashes.size() > 0);
+    RLPStream s;
+    s << chunkHashes;
+    BOOST_CHECK(snapshot->root() == sha3(s.out()));
+    BOOST_CHECK(snapshot->chunk(chunkHashes.size()).empty());
+
+    for (size_t i = 0; i < chunkHashes.size(); ++i)
+    {
+        bytes chunk = snapshot->chunk(i);
+        BOOST_CHECK(sha3(chunk) == chunkHashes[i]);
+        target->importSnapshotChunk(ref(chunk));
+    }
+    BOOST_CHECK_EQUAL(select(target, "t_test"), "2");
+    /// the current state is written after all the chunks
+    BOOST_CHECK_EQUAL(select(target, SYS_CURRENT_STATE), "");
+    target->finishSnapshotImport();
+    BOOST_CHECK_EQUAL(select(target, SYS_CURRENT_STATE), "2");
+    BOOST_CHECK_EQUAL(select(source, "t_test"), "3");
+}
+
+BOOST_AUTO_TEST_CASE(discardImport)
+{
+    source->setSnapshotInterval(1);
+    commit(1, {"t_test", SYS_CURRENT_STATE});
+    auto snapshot = source->snapshot();
+    BOOST_REQUIRE(snapshot != nullptr);
+    for (size_t i = 0; i < snapshot->chunkHashes().size(); ++i)
+    {
+        bytes chunk = snapshot->chunk(i);
+        target->importSnapshotChunk(ref(chunk));
+    }
+    /// the current state of the discarded import is never written
+    target->discardSnapshotImport();
+    target->finishSnapshotImport();
+    BOOST_CHECK_EQUAL(select(target, "t_test"), "1");
+    BOOST_CHECK_EQUAL(select(target, SYS_CURRENT_STATE), "");
+}
+
+BOOST_AUTO_TEST_CASE(sameRootWithDifferentSigLists)
+{
+    /// the sealers commit the same block with the different signatures collected
+    dev::test::FakeBlock fakeBlock(4);
+    Block block = fakeBlock.getBlock();
+    auto sigList = block.sigList();
+    source->setSnapshotInterval(1);
+    commitBlock(source, block, sigList);
+    sigList.pop_back();
+    target->setSnapshotInterval(1);
+    commitBlock(target, block, sigList);
+    auto sourceSnapshot = source->snapshot();
+    auto targetSnapshot = target->snapshot();
+    BOOST_REQUIRE(sourceSnapshot != nullptr && targetSnapshot != nullptr);
+    BOOST_CHECK(sourceSnapshot->root() == targetSnapshot->root());
+    BOOST_CHECK(sourceSnapshot->chunkHashes() == targetSnapshot->chunkHashes());
+
+    /// the block imported from the snapshot keeps everything but the signatures
+    auto imported = createStorage("imported");
+    for (size_t i = 0; i < sourceSnapshot->chunkHashes().size(); ++i)
+    {
+        bytes chunk = sourceSnapshot->chunk(i);
+        imported->importSnapshotChunk(ref(chunk));
+    }
+    imported->finishSnapshotImport();
+    auto entries = imported->select(h256(), 0, SYS_HASH_2_BLOCK, block.blockHeader().hash().hex());
+    BOOST_REQUIRE(entries->size() == 1);
+    Block importedBlock(fromHex(entries->get(0)->getField(SYS_VALUE)), CheckTransaction::None);
+    BOOST_CHECK(importedBlock.blockHeader().hash() == block.blockHeader().hash());
+    BOOST_CHECK(importedBlock.transactions() == block.transactions());
+    BOOST_CHECK(importedBlock.sigList().empty());
+}
+
+BOOST_AUTO_TEST_CASE(refuseCommitWhileImporting)
+{
+    source->setSnapshotInterval(1);
+    commit(1, {"t_test", SYS_CURRENT_STATE});
+    auto snapshot = source->snapshot();
+    BOOST_REQUIRE(snapshot != nullptr);
+    auto db = std::make_shared<dev::db::BasicLevelDB>(
+        dev::db::LevelDB::defaultDBOptions(), (path / "importing").string());
+    auto importing = std::make_shared<LevelDBStorage>();
+    importing->setDB(db);
+    BOOST_CHECK(!importing->snapshotImporting());
+    bytes chunk = snapshot->chunk(0);
+    importing->importSnapshotChunk(ref(chunk));
+    BOOST_CHECK(importing->snapshotImporting());
+    BOOST_CHECK_THROW(importing->commit(h256(2), 2, {}, h256(2)), std::exception);
+
+    /// the unfinished import is found after a restart
+    auto restarted = std::make_shared<LevelDBStorage>();
+    restarted->setDB(db);
+    BOOST_CHECK(restarted->snapshotImporting());
+    restarted->finishSnapshotImport();
+    BOOST_CHECK(restarted->snapshotImporting());
+    restarted->confirmSnapshotImport();
+    BOOST_CHECK(!restarted->snapshotImporting());
+    BOOST_CHECK_NO_THROW(restarted->commit(h256(2), 2, {}, h256(2)));
+    restarted.reset();
+    importing.reset();
+    db.reset();
+}
+
+BOOST_AUTO_TEST_CASE(keptSnapshots)
+{
+    source->setSnapshotInterval(1);
+    for (int64_t number = 1; number <= 3; ++number)
+    {
+        commit(number, {"t_test"});
+    }
+    BOOST_CHECK(source->snapshot(1) == nullptr);
+    BOOST_CHECK(source->snapshot(2) != nullptr);
+    BOOST_CHECK_EQUAL(source->snapshot()->number(), 3);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+}  // namespace test_LevelDBSnapshot
@@ -116,6 +116,31 @@ BOOST_AUTO_TEST_CASE(AllTest)
         fakeQueue.size() == c_maxDownloadingBlockQueueSize + c_maxDownloadingBlockQueueBufferSize);
 }
 
+BOOST_AUTO_TEST_CASE(DecodePoolTest)
+{
+    DownloadingBlockQueue fakeQueue;
+    fakeQueue.setDecodePool(std::make_shared<dev::ThreadPool>("decode", 2));
+    vector<shared_ptr<Block>> blocks;
+    for (int64_t i = 20; i > 0; --i)
+    {
+        FakeBlock fakeBlock;
+        fakeBlock.getBlock().header().setNumber(i);
+        blocks.emplace_back(make_shared<Block>(fakeBlock.getBlock()));
+    }
+    fakeQueue.push(blocks);
+    fakeQueue.flushBufferToQueue();
+    BOOST_CHECK(fakeQueue.size() == 20);
+
+    // the blocks decoded by different threads are queued in order
+    for (int64_t i = 1; i <= 20; ++i)
+    {
+        BOOST_CHECK(fakeQueue.top()->header().number() == i);
+        BOOST_CHECK(fakeQueue.top()->headerHash() == blocks[20 - i]->headerHash());
+        fakeQueue.pop();
+    }
+    BOOST_CHECK(fakeQueue.empty());
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 }  // namespace test
 }  // namespace dev
@@ -69,7 +69,8 @@ public:
     };
 
     FakeSyncToolsSet fakeSyncToolsSet(uint64_t _blockNum, size_t const& _transSize,
-        NodeID const& _nodeId, Secret const& sec = KeyPair::create().secret())
+        NodeID const& _nodeId, Secret const& sec = KeyPair::create().secret(),
+        bool _announceTransactions = false)
     {
         TxPoolFixture txpool_creator(_blockNum, _transSize, sec);
         m_genesisHash = txpool_creator.m_blockChain->getBlockByNumber(0)->headerHash();
@@ -78,7 +79,8 @@ public:
             std::make_shared<FakeBlockverifier>();
         std::shared_ptr<SyncMaster> fakeSyncMaster =
             std::make_shared<SyncMaster>(txpool_creator.m_topicService, txpool_creator.m_txPool,
-                txpool_creator.m_blockChain, blockVerifier, c_protocolId, _nodeId, m_genesisHash);
+                txpool_creator.m_blockChain, blockVerifier, c_protocolId, _nodeId, m_genesisHash,
+                200, _announceTransactions);
         return FakeSyncToolsSet{fakeSyncMaster, txpool_creator.m_topicService,
             txpool_creator.m_txPool, txpool_creator.m_blockChain, blockVerifier};
     }
@@ -201,6 +203,56 @@ BOOST_AUTO_TEST_CASE(MaintainTransactionsTest)
     BOOST_CHECK_EQUAL(service->getAsyncSendSizeByNodeID(NodeID(102)), 3);
 }
 
+BOOST_AUTO_TEST_CASE(AnnounceTransactionsTest)
+{
+    int64_t currentBlockNumber = 4;
+    FakeSyncToolsSet syncTools = fakeSyncToolsSet(
+        currentBlockNumber + 1, 5, NodeID(100), KeyPair::create().secret(), true);
+    std::shared_ptr<SyncMaster> sync = syncTools.sync;
+    std::shared_ptr<FakeService> service = syncTools.service;
+    std::shared_ptr<TxPoolInterface> txPool = syncTools.txPool;
+    service->setConnected();
+
+    sync->syncStatus()->newSyncPeerStatus(
+        SyncPeerInfo{NodeID(101), 0, m_genesisHash, m_genesisHash});
+    sync->syncStatus()->newSyncPeerStatus(
+        SyncPeerInfo{NodeID(102), 0, m_genesisHash, m_genesisHash});
+    sync->syncStatus()->foreachPeer([&](shared_ptr<SyncPeerStatus> _p) {
+        _p->isSealer = true;
+        return true;
+    });
+
+    shared_ptr<Transactions> txs = fakeTransactions(3, currentBlockNumber);
+    for (auto& tx : *txs)
+        txPool->submit(tx);
+    txPool->setTransactionIsKnownBy((*txs)[0].sha3(), NodeID(101));
+
+    // hashes are announced to every sealer in one packet
+    sync->maintainTransactions();
+    BOOST_CHECK_EQUAL(service->getAsyncSendSizeByNodeID(NodeID(101)), 1);
+    BOOST_CHECK_EQUAL(service->getAsyncSendSizeByNodeID(NodeID(102)), 1);
+
+    // NodeID(101) already knows the first transaction
+    bytesConstRef frame = ref(*(service->getAsyncSendMessageByNodeID(NodeID(101))->buffer()));
+    BOOST_CHECK_EQUAL(frame[0], TxsHashesPacket + c_syncPacketIDBase);
+    BOOST_CHECK_EQUAL(RLP(frame.cropped(1))[0].toVector<h256>().size(), 2);
+
+    // announced transactions are not announced again
+    sync->maintainTransactions();
+    BOOST_CHECK_EQUAL(service->getAsyncSendSizeByNodeID(NodeID(101)), 1);
+    BOOST_CHECK_EQUAL(service->getAsyncSendSizeByNodeID(NodeID(102)), 1);
+
+    // the announcements to the disconnected peers may be lost, they are announced again
+    service->clearSessionInfo();
+    sync->maintainPeersConnection();
+    BOOST_CHECK(!txPool->isTransactionKnownBy((*txs)[1].sha3(), NodeID(102)));
+    sync->maintainTransactions();
+    BOOST_CHECK_EQUAL(service->getAsyncSendSizeByNodeID(NodeID(101)), 2);
+    BOOST_CHECK_EQUAL(service->getAsyncSendSizeByNodeID(NodeID(102)), 2);
+    frame = ref(*(service->getAsyncSendMessageByNodeID(NodeID(102))->buffer()));
+    BOOST_CHECK_EQUAL(RLP(frame.cropped(1))[0].toVector<h256>().size(), 3);
+}
+
 BOOST_AUTO_TEST_CASE(MaintainBlocksTest)
 {
     int64_t currentBlockNumber = 4;
@@ -221,28 +273,189 @@ BOOST_AUTO_TEST_CASE(MaintainBlocksTest)
 
 BOOST_AUTO_TEST_CASE(MaintainPeersStatusTest)
 {
-    int64_t currentBlockNumber = 4;
-    FakeSyncToolsSet syncTools = fakeSyncToolsSet(currentBlockNumber + 1, 5, NodeID(100));
+    int64_t currentBlockNumber = 0;
+    Secret sec = dev::KeyPair::create().secret();
+    FakeSyncToolsSet syncTools = fakeSyncToolsSet(currentBlockNumber + 1, 5, NodeID(100), sec);
     std::shared_ptr<SyncMaster> sync = syncTools.sync;
     std::shared_ptr<FakeService> service = syncTools.service;
+    std::shared_ptr<SyncMasterStatus> status = sync->syncStatus();
 
-    // Can recieve 5 req
+    // Can send 1 shard
     sync->syncStatus()->newSyncPeerStatus(SyncPeerInfo{
-        NodeID(101), c_maxRequestBlocks * 5 + currentBlockNumber, m_genesisHash, m_genesisHash});
-    // Can recieve 1 req
+        NodeID(101), c_maxRequestBlocks + currentBlockNumber, m_genesisHash, m_genesisHash});
+    // Can send 5 shards
     sync->syncStatus()->newSyncPeerStatus(SyncPeerInfo{
-        NodeID(102), c_maxRequestBlocks + currentBlockNumber, m_genesisHash, m_genesisHash});
-    // Can recieve 10(at least 5)req
+        NodeID(102), c_maxRequestBlocks * 5 + currentBlockNumber, m_genesisHash, m_genesisHash});
+    // Can send 10 shards
     sync->syncStatus()->newSyncPeerStatus(SyncPeerInfo{
         NodeID(103), c_maxRequestBlocks * 10 + currentBlockNumber, m_genesisHash, m_genesisHash});
 
+    auto reqPacketSum = [&]() {
+        return service->getAsyncSendSizeByNodeID(NodeID(101)) +
+               service->getAsyncSendSizeByNodeID(NodeID(102)) +
+               service->getAsyncSendSizeByNodeID(NodeID(103));
+    };
+
+    // only the headers are requested before any header is verified
+    sync->maintainPeersStatus();
+    BOOST_CHECK_EQUAL(reqPacketSum(), 1);
+    BOOST_CHECK(sync->isSyncing());
+
+    // the headers request in flight is not sent again
+    sync->maintainPeersStatus();
+    BOOST_CHECK_EQUAL(reqPacketSum(), 1);
+
+    // receive the headers of 2 shards
+    int64_t headersNumber = currentBlockNumber + c_maxRequestBlocks * 2;
+    FakeBlockChain latestBlockChain(headersNumber + 1, 5, sec);
+    std::vector<bytes> headerRLPs;
+    for (int64_t i = currentBlockNumber + 1; i <= headersNumber; ++i)
+    {
+        // the downloaded transactions are checked against the root in the verified header
+        auto block = latestBlockChain.getBlockByNumber(i);
+        block->header().setParentHash(latestBlockChain.getBlockByNumber(i - 1)->headerHash());
+        block->calTransactionRoot();
+        bytes headerBytes;
+        block->header().encode(headerBytes);
+        RLPStream s;
+        s.appendList(2).appendRaw(headerBytes).appendVector(block->sigList());
+        headerRLPs.push_back(s.out());
+    }
+    SyncHeadersPacket packet;
+    packet.encode(headerRLPs);
+    auto msg = packet.toMessage(c_protocolId);
+    status->headerChain().push(NodeID(103), RLP(ref(*msg->buffer()).cropped(1)));
+
+    // the next headers and the blocks of the verified headers are requested from idle peers
+    sync->maintainPeersStatus();
+    BOOST_CHECK_EQUAL(status->headerChain().highest(), headersNumber);
+    BOOST_CHECK(status->headerChain().verifiedHash(headersNumber) ==
+                latestBlockChain.getBlockByNumber(headersNumber)->headerHash());
+    BOOST_CHECK_EQUAL(reqPacketSum(), 4);
+
+    // the verified headers are checked against the downloaded blocks
+    status->knownHighestNumber = headersNumber;
+    status->knownLatestHash = latestBlockChain.getBlockByNumber(headersNumber)->headerHash();
+    BlockPtrVec blocks;
+    for (int64_t i = currentBlockNumber + 1; i <= headersNumber; ++i)
+        blocks.push_back(latestBlockChain.getBlockByNumber(i));
+    status->bq().push(blocks);
+    status->bq().flushBufferToQueue();
+    BOOST_CHECK_EQUAL(sync->maintainDownloadingQueue(), true);
+    BOOST_CHECK_EQUAL(syncTools.blockChain->number(), headersNumber);
+    status->headerChain().prune();
+    BOOST_CHECK_EQUAL(status->headerChain().size(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(BodyOnlyPeerTest)
+{
+    int64_t currentBlockNumber = 0;
+    FakeSyncToolsSet syncTools = fakeSyncToolsSet(currentBlockNumber + 1, 5, NodeID(100));
+    std::shared_ptr<SyncMaster> sync = syncTools.sync;
+    std::shared_ptr<FakeService> service = syncTools.service;
+    std::shared_ptr<SyncMasterStatus> status = sync->syncStatus();
+    status->newSyncPeerStatus(SyncPeerInfo{
+        NodeID(101), c_maxRequestBlocks + currentBlockNumber, m_genesisHash, m_genesisHash});
+    auto lastPacketType = [&]() {
+        return (*service->getAsyncSendMessageByNodeID(NodeID(101))->buffer())[0];
+    };
+
+    // the headers are requested first
+    sync->maintainPeersStatus();
+    BOOST_CHECK_EQUAL(service->getAsyncSendSizeByNodeID(NodeID(101)), 1);
+    BOOST_CHECK(lastPacketType() == ReqHeadersPacket);
+    auto peer = status->peerStatus(NodeID(101));
+    BOOST_CHECK(peer->headersRequestTime != 0);
+    BOOST_CHECK(!peer->bodyOnly(utcTime()));
+
+    // the peer never answers the headers request, its blocks are requested without headers
+    peer->headersRequestTime -= c_headersRequestTimeout;
+    BOOST_CHECK(peer->bodyOnly(utcTime()));
     sync->maintainPeersStatus();
-    cout << "Msg number: " << service->getAsyncSendSizeByNodeID(NodeID(103)) << endl;
+    BOOST_CHECK_EQUAL(service->getAsyncSendSizeByNodeID(NodeID(101)), 2);
+    BOOST_CHECK(lastPacketType() == ReqBlocskPacket);
+    auto msg = service->getAsyncSendMessageByNodeID(NodeID(101));
+    BOOST_CHECK_EQUAL(RLP(ref(*msg->buffer()).cropped(1))[0].toInt<int64_t>(), 1);
+
+    // a peer which has sent headers is never body-only
+    peer->headersServed = true;
+    BOOST_CHECK(!peer->bodyOnly(utcTime()));
+}
 
-    size_t reqPacketSum = service->getAsyncSendSizeByNodeID(NodeID(101)) +
-                          service->getAsyncSendSizeByNodeID(NodeID(102)) +
-                          service->getAsyncSendSizeByNodeID(NodeID(103));
-    BOOST_CHECK_EQUAL(reqPacketSum, c_maxRequestShards);
+BOOST_AUTO_TEST_CASE(PeerDownloadWindowTest)
+{
+    PeerDownloadWindow window;
+    BOOST_CHECK(window.idle());
+    BOOST_CHECK_EQUAL(window.window(), c_maxRequestBlocks);
+
+    // the window grows to the blocks the peer sends in c_bodyRequestTargetTime
+    window.request(1, c_maxRequestBlocks, 1000);
+    BOOST_CHECK(!window.idle());
+    window.onBlocks(c_maxRequestBlocks / 2, 1024 * c_maxRequestBlocks / 2, 1100);
+    BOOST_CHECK(!window.idle());
+    window.onBlocks(c_maxRequestBlocks / 2, 1024 * c_maxRequestBlocks / 2, 1250);
+    BOOST_CHECK(window.idle());
+    BOOST_CHECK_EQUAL(window.blockSize(), 1024);
+    BOOST_CHECK_EQUAL(window.throughput(), c_maxRequestBlocks * 4);
+    BOOST_CHECK_EQUAL(window.window(), c_maxRequestBlocks * 4 * c_bodyRequestTargetTime / 1000);
+
+    // the range not received is taken back on timeout and the window shrinks
+    int64_t size = window.window();
+    window.request(100, size, 2000);
+    window.onBlocks(10, 10240, 2100);
+    int64_t from = 0;
+    int64_t left = 0;
+    BOOST_CHECK(!window.checkTimeout(2100, from, left));
+    BOOST_CHECK(window.checkTimeout(2000 + c_minBodyRequestTimeout * 10, from, left));
+    BOOST_CHECK_EQUAL(from, 110);
+    BOOST_CHECK_EQUAL(left, size - 10);
+    BOOST_CHECK(window.idle());
+    BOOST_CHECK_EQUAL(window.window(), size / 2);
+}
+
+BOOST_AUTO_TEST_CASE(MaintainBlockRequestTest)
+{
+    int64_t currentBlockNumber = 4;
+    FakeSyncToolsSet syncTools = fakeSyncToolsSet(currentBlockNumber + 1, 5, NodeID(100));
+    std::shared_ptr<SyncMaster> sync = syncTools.sync;
+    std::shared_ptr<FakeService> service = syncTools.service;
+    std::shared_ptr<BlockChainInterface> blockChain = syncTools.blockChain;
+
+    sync->syncStatus()->newSyncPeerStatus(
+        SyncPeerInfo{NodeID(101), 0, m_genesisHash, m_genesisHash});
+    auto peer = sync->syncStatus()->peerStatus(NodeID(101));
+    peer->headersReqQueue.push(1, 2);
+    peer->reqQueue.push(1, 3);
+
+    // the headers are sent before the blocks by the responder pool
+    sync->maintainBlockRequest();
+    for (size_t i = 0; i < 100 && peer->responding; ++i)
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    BOOST_CHECK(!peer->responding);
+    BOOST_CHECK_EQUAL(service->getAsyncSendSizeByNodeID(NodeID(101)), 2);
+    BOOST_CHECK(peer->headersReqQueue.empty());
+    BOOST_CHECK(peer->reqQueue.empty());
+    BOOST_CHECK(sync->syncInfo().find("blockResponder") != std::string::npos);
+
+    // the blocks are sent in the encoding they are stored
+    bytesConstRef frame = ref(*(service->getAsyncSendMessageByNodeID(NodeID(101))->buffer()));
+    BOOST_CHECK_EQUAL(frame[0], BlocksPacket + c_syncPacketIDBase);
+    RLP const rlps(frame.cropped(1));
+    BOOST_REQUIRE_EQUAL(rlps.itemCount(), 3);
+    for (size_t i = 0; i < rlps.itemCount(); ++i)
+        BOOST_CHECK(rlps[i].data().toBytes() == blockChain->getBlockByNumber(i + 1)->rlp());
+}
+
+BOOST_AUTO_TEST_CASE(RespondBandwidthTest)
+{
+    RespondBandwidth bandwidth;
+    BOOST_CHECK(!bandwidth.exceeded(1000));
+    bandwidth.add(c_maxRespondBytesPerPeer - 1, 1000);
+    BOOST_CHECK(!bandwidth.exceeded(1999));
+    bandwidth.add(1, 1999);
+    BOOST_CHECK(bandwidth.exceeded(1999));
+    // the bytes are counted per second
+    BOOST_CHECK(!bandwidth.exceeded(2000));
 }
 
 BOOST_AUTO_TEST_CASE(MaintainDownloadingQueueTest)
@@ -339,6 +552,81 @@ BOOST_AUTO_TEST_CASE(MaintainDownloadingQueueTest)
     }
 }
 
+BOOST_AUTO_TEST_CASE(CatchUpStatisticsTest)
+{
+    Secret sec = dev::KeyPair::create().secret();
+    FakeSyncToolsSet syncTools = fakeSyncToolsSet(1, 5, NodeID(100), sec);
+    std::shared_ptr<SyncMaster> sync = syncTools.sync;
+    std::shared_ptr<SyncMasterStatus> status = sync->syncStatus();
+    std::shared_ptr<BlockChainInterface> blockChain = syncTools.blockChain;
+    BOOST_CHECK_EQUAL(sync->catchUpBlocksPerSecond(), 0);
+
+    int64_t latestNumber = 3;
+    FakeBlockChain latestBlockChain(latestNumber + 1, 5, sec);
+    status->knownHighestNumber = latestNumber;
+    status->knownLatestHash = latestBlockChain.getBlockByNumber(latestNumber)->headerHash();
+
+    sync->noteDownloadingBegin();
+    uint64_t beginTime = utcTime();
+    vector<shared_ptr<Block>> blocks;
+    for (int64_t i = latestNumber; i > 0; --i)
+    {
+        blocks.emplace_back(latestBlockChain.getBlockByNumber(i));
+    }
+    status->bq().push(blocks);
+    status->bq().flushBufferToQueue();
+    BOOST_CHECK_EQUAL(status->bq().size(), (size_t)latestNumber);
+    BOOST_CHECK_EQUAL(sync->maintainDownloadingQueue(), true);
+    BOOST_CHECK_EQUAL(blockChain->number(), latestNumber);
+    BOOST_CHECK(status->bq().empty());
+    /// the rate is only reported once the catch-up lasts a millisecond
+    while (utcTime() <= beginTime)
+        std::this_thread::yield();
+    sync->noteDownloadingFinish();
+
+    /// the rate of the finished catch-up is kept
+    double blocksPerSecond = sync->catchUpBlocksPerSecond();
+    BOOST_CHECK(blocksPerSecond > 0);
+    BOOST_CHECK(blocksPerSecond <= latestNumber * 1000);
+    BOOST_CHECK(sync->syncInfo().find("catchUpBlocksPerSecond") != std::string::npos);
+}
+
+BOOST_AUTO_TEST_CASE(CheckDownloadedBlockThrowTest)
+{
+    Secret sec = dev::KeyPair::create().secret();
+    FakeSyncToolsSet syncTools = fakeSyncToolsSet(1, 5, NodeID(100), sec);
+    std::shared_ptr<SyncMaster> sync = syncTools.sync;
+    std::shared_ptr<SyncMasterStatus> status = sync->syncStatus();
+    std::shared_ptr<BlockChainInterface> blockChain = syncTools.blockChain;
+
+    int64_t latestNumber = 3;
+    FakeBlockChain latestBlockChain(latestNumber + 1, 5, sec);
+    status->knownHighestNumber = latestNumber;
+    status->knownLatestHash = latestBlockChain.getBlockByNumber(latestNumber)->headerHash();
+    /// the check of the second block throws on the verify pool
+    sync->registerConsensusVerifyHandler([](dev::eth::Block const& _block) -> bool {
+        if (_block.blockHeader().number() == 2)
+            BOOST_THROW_EXCEPTION(std::runtime_error("verify failed"));
+        return true;
+    });
+
+    vector<shared_ptr<Block>> blocks;
+    for (int64_t i = latestNumber; i > 0; --i)
+    {
+        blocks.emplace_back(latestBlockChain.getBlockByNumber(i));
+    }
+    status->bq().push(blocks);
+    status->bq().flushBufferToQueue();
+    BOOST_CHECK_EQUAL(status->bq().size(), (size_t)latestNumber);
+
+    /// the failed block and the blocks behind it are dropped instead of killing the sync thread
+    bool finished = true;
+    BOOST_CHECK_NO_THROW(finished = sync->maintainDownloadingQueue());
+    BOOST_CHECK(!finished);
+    BOOST_CHECK_EQUAL(blockChain->number(), 1);
+    BOOST_CHECK(status->bq().empty());
+}
+
 BOOST_AUTO_TEST_CASE(DoWorkTest)
 {
     int64_t currentBlockNumber = 0;
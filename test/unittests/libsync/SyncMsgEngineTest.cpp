@@ -21,11 +21,17 @@
  * @date: 2018-10-25
  */
 
+#include <libdevcore/BasicLevelDB.h>
+#include <libdevcore/LevelDB.h>
+#include <libstorage/LevelDBStorage.h>
+#include <libsync/SnapshotSync.h>
 #include <libsync/SyncMsgEngine.h>
 #include <libsync/SyncMsgPacket.h>
 #include <test/tools/libutils/TestOutputHelper.h>
 #include <test/unittests/libsync/FakeSyncToolsSet.h>
+#include <boost/filesystem.hpp>
 #include <boost/test/unit_test.hpp>
+#include <future>
 #include <memory>
 
 using namespace std;
@@ -90,6 +96,29 @@ BOOST_AUTO_TEST_CASE(SyncTransactionPacketTest)
     BOOST_CHECK_EQUAL(topTxs[0].sha3(), txPtr->sha3());
 }
 
+BOOST_AUTO_TEST_CASE(SyncReqTxsPacketTest)
+{
+    auto txPacket = SyncTransactionsPacket();
+    auto txPtr = fakeSyncToolsSet.createTransaction(0);
+    txPacket.encode(0x01, txPtr->rlp());
+    auto fakeSessionPtr = fakeSyncToolsSet.createSession();
+    fakeMsgEngine.messageHandler(fakeException, fakeSessionPtr, txPacket.toMessage(0x02));
+
+    /// a request of more hashes than an announcement carries is served up to the announcement
+    SyncReqTxsPacket reqTxsPacket;
+    reqTxsPacket.encode(std::vector<h256>(c_maxAnnounceTransactions + 500, txPtr->sha3()));
+    fakeMsgEngine.messageHandler(fakeException, fakeSessionPtr, reqTxsPacket.toMessage(0x02));
+
+    auto service = std::dynamic_pointer_cast<FakeService>(fakeSyncToolsSet.getServicePtr());
+    BOOST_CHECK_EQUAL(service->getAsyncSendSizeByNodeID(NodeID()), 1);
+    auto response = service->getAsyncSendMessageByNodeID(NodeID());
+    BOOST_REQUIRE(response != nullptr);
+    BOOST_CHECK_EQUAL((*response->buffer())[0], TransactionsPacket + c_syncPacketIDBase);
+    RLP txsRLP(ref(*response->buffer()).cropped(1));
+    BOOST_CHECK_EQUAL(txsRLP.itemCount(), c_maxAnnounceTransactions);
+    BOOST_CHECK_EQUAL(Transaction(txsRLP[0].data(), CheckTransaction::None).sha3(), txPtr->sha3());
+}
+
 BOOST_AUTO_TEST_CASE(SyncBlocksPacketTest)
 {
     SyncBlocksPacket blocksPacket;
@@ -121,6 +150,120 @@ BOOST_AUTO_TEST_CASE(SyncReqBlockPacketTest)
     BOOST_CHECK(!fakeStatusPtr->peerStatus(h512(0))->reqQueue.empty());
 }  // namespace test
 
+BOOST_AUTO_TEST_CASE(SnapshotManifestTest)
+{
+    /// fakeMsgEngine serves the snapshot of block 1 of its storage
+    NodeID serverId(0xabcd);
+    auto path = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path();
+    auto db = std::make_shared<dev::db::BasicLevelDB>(
+        dev::db::LevelDB::defaultDBOptions(), (path / "server").string());
+    auto storage = std::make_shared<dev::storage::LevelDBStorage>();
+    storage->setDB(db);
+    storage->setSnapshotInterval(1);
+    auto entries = std::make_shared<dev::storage::Entries>();
+    auto entry = std::make_shared<dev::storage::Entry>();
+    entry->setField("value", "1");
+    entries->addEntry(entry);
+    auto tableData = std::make_shared<dev::storage::TableData>();
+    tableData->tableName = "t_test";
+    tableData->data.insert(std::make_pair(std::string("key"), entries));
+    storage->commit(h256(1), 1, std::vector<dev::storage::TableData::Ptr>{tableData}, h256(1));
+    auto snapshot = storage->snapshot();
+    BOOST_REQUIRE(snapshot != nullptr);
+    /// a single thread serves the requests in order
+    auto pool = std::make_shared<dev::ThreadPool>("SnapshotServe", 1);
+    fakeMsgEngine.setSnapshotStorage(storage, pool);
+    fakeMsgEngine.needCheckPacketInGroup = false;
+    auto serverService = std::dynamic_pointer_cast<FakeService>(fakeSyncToolsSet.getServicePtr());
+
+    /// the downloading node trusts the manifest of the only sealer
+    NodeID clientId(0x1234);
+    FakeSyncToolsSet clientTools;
+    auto clientService = std::dynamic_pointer_cast<FakeService>(clientTools.getServicePtr());
+    auto clientBlockChain =
+        std::dynamic_pointer_cast<FakeBlockChain>(clientTools.getBlockChainPtr());
+    clientBlockChain->m_sealerList = h512s{serverId};
+    SyncMsgEngine clientMsgEngine(clientService, clientTools.getTxPoolPtr(), clientBlockChain,
+        make_shared<SyncMasterStatus>(h256(0x1024)), 0, clientId, h256(0xcdef));
+    clientMsgEngine.needCheckPacketInGroup = false;
+    auto snapshotSync =
+        std::make_shared<SnapshotSync>(clientService, clientBlockChain, nullptr, 0, clientId);
+    clientMsgEngine.setSnapshotSync(snapshotSync);
+
+    /// the request of the latest manifest is answered by the server
+    BOOST_CHECK(!snapshotSync->maintain(NodeIDs{serverId}));
+    auto request = clientService->getAsyncSendMessageByNodeID(serverId);
+    BOOST_REQUIRE(request != nullptr);
+    fakeMsgEngine.messageHandler(
+        fakeException, fakeSyncToolsSet.createSessionWithID(clientId), request);
+    std::packaged_task<void()> served([]() {});
+    auto servedFuture = served.get_future();
+    pool->enqueue([&served]() { served(); });
+    servedFuture.wait();
+    auto manifest = serverService->getAsyncSendMessageByNodeID(clientId);
+    BOOST_REQUIRE(manifest != nullptr);
+    SyncMsgPacket manifestPacket;
+    BOOST_REQUIRE(manifestPacket.decode(clientTools.createSessionWithID(serverId), manifest));
+    BOOST_CHECK(manifestPacket.packetType == SnapshotManifestPacket);
+    BOOST_CHECK_EQUAL(manifestPacket.rlp()[0].toInt<int64_t>(), snapshot->number());
+    BOOST_CHECK(manifestPacket.rlp()[2].toHash<h256>() == snapshot->root());
+
+    /// the manifest is chosen and its chunks are requested from the server
+    clientMsgEngine.messageHandler(
+        fakeException, clientTools.createSessionWithID(serverId), manifest);
+    BOOST_CHECK(!snapshotSync->maintain(NodeIDs{serverId}));
+    auto chunkRequest = clientService->getAsyncSendMessageByNodeID(serverId);
+    SyncMsgPacket chunkRequestPacket;
+    BOOST_REQUIRE(
+        chunkRequestPacket.decode(fakeSyncToolsSet.createSessionWithID(clientId), chunkRequest));
+    BOOST_CHECK(chunkRequestPacket.packetType == ReqSnapshotChunkPacket);
+    BOOST_CHECK_EQUAL(chunkRequestPacket.rlp()[0].toInt<int64_t>(), snapshot->number());
+
+    pool->stop();
+    storage.reset();
+    db.reset();
+    boost::filesystem::remove_all(path);
+}
+
+BOOST_AUTO_TEST_CASE(SnapshotManifestVoteTest)
+{
+    /// f + 1 of the 4 sealers must send the same manifest
+    NodeIDs sealers{NodeID(1), NodeID(2), NodeID(3), NodeID(4)};
+    NodeID observer(0x99);
+    auto service = std::dynamic_pointer_cast<FakeService>(fakeSyncToolsSet.getServicePtr());
+    auto blockChain =
+        std::dynamic_pointer_cast<FakeBlockChain>(fakeSyncToolsSet.getBlockChainPtr());
+    blockChain->m_sealerList = h512s(sealers.begin(), sealers.end());
+    auto snapshotSync =
+        std::make_shared<SnapshotSync>(service, blockChain, nullptr, 0, NodeID(0xabcd));
+
+    std::vector<h256> chunkHashes{h256(1), h256(2)};
+    std::vector<h256> bogusHashes{h256(3), h256(4)};
+    RLPStream s;
+    s << chunkHashes;
+    h256 root = sha3(s.out());
+    /// the bogus first page of the observer is ignored, and the one of a sealer only drops
+    /// its own vote
+    snapshotSync->onManifest(observer, 1, h256(0xb), root, 2, 0, bogusHashes);
+    snapshotSync->onManifest(sealers[0], 1, h256(0xb), root, 2, 0, bogusHashes);
+    snapshotSync->onManifest(sealers[1], 1, h256(0xb), root, 2, 0, chunkHashes);
+    snapshotSync->onManifest(sealers[2], 1, h256(0xb), root, 2, 0, chunkHashes);
+    NodeIDs peers{sealers[0], sealers[1], sealers[2], observer};
+    BOOST_CHECK(!snapshotSync->maintain(peers));
+    BOOST_CHECK(!snapshotSync->maintain(peers));
+
+    /// the chunks are requested from the sealers sent the valid first page
+    auto chunkRequest = service->getAsyncSendMessageByNodeID(sealers[1]);
+    BOOST_REQUIRE(chunkRequest != nullptr);
+    SyncMsgPacket chunkRequestPacket;
+    BOOST_REQUIRE(chunkRequestPacket.decode(
+        fakeSyncToolsSet.createSessionWithID(NodeID(0xabcd)), chunkRequest));
+    BOOST_CHECK(chunkRequestPacket.packetType == ReqSnapshotChunkPacket);
+    BOOST_CHECK(service->getAsyncSendMessageByNodeID(sealers[2]) != nullptr);
+    BOOST_CHECK(service->getAsyncSendMessageByNodeID(sealers[0]) == nullptr);
+    BOOST_CHECK(service->getAsyncSendMessageByNodeID(observer) == nullptr);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 }  // namespace test
 }  // namespace dev
@@ -183,6 +183,64 @@ BOOST_AUTO_TEST_CASE(SyncReqBlockPacketTest)
     BOOST_CHECK(rlpReqBlock[1].toInt<unsigned>() == 0x40);
 }
 
+BOOST_AUTO_TEST_CASE(SyncTxsHashesPacketTest)
+{
+    std::vector<h256> txHashes{h256(0x10), h256(0x20)};
+    SyncTxsHashesPacket hashesPacket;
+    hashesPacket.encode(txHashes);
+    auto msgPtr = hashesPacket.toMessage(0x03);
+    hashesPacket.decode(fakeSessionPtr, msgPtr);
+    BOOST_CHECK(hashesPacket.packetType == TxsHashesPacket);
+    BOOST_CHECK(hashesPacket.rlp()[0].toVector<h256>() == txHashes);
+
+    SyncReqTxsPacket reqTxsPacket;
+    reqTxsPacket.encode(txHashes);
+    msgPtr = reqTxsPacket.toMessage(0x03);
+    reqTxsPacket.decode(fakeSessionPtr, msgPtr);
+    BOOST_CHECK(reqTxsPacket.packetType == ReqTxsPacket);
+    BOOST_CHECK(reqTxsPacket.rlp()[0].toVector<h256>() == txHashes);
+}
+
+BOOST_AUTO_TEST_CASE(SyncSnapshotPacketTest)
+{
+    /// the request of the latest manifest decodes to c_latestSnapshotNumber
+    SyncReqSnapshotManifestPacket reqManifestPacket;
+    reqManifestPacket.encode(c_latestSnapshotNumber, 0);
+    auto reqMsgPtr = reqManifestPacket.toMessage(0x03);
+    reqManifestPacket.decode(fakeSessionPtr, reqMsgPtr);
+    BOOST_CHECK(reqManifestPacket.packetType == ReqSnapshotManifestPacket);
+    BOOST_CHECK(reqManifestPacket.rlp()[0].toInt<int64_t>() == c_latestSnapshotNumber);
+    BOOST_CHECK(reqManifestPacket.rlp()[1].toInt<unsigned>() == 0);
+    reqManifestPacket.encode(int64_t(0x30), 8192);
+    reqMsgPtr = reqManifestPacket.toMessage(0x03);
+    reqManifestPacket.decode(fakeSessionPtr, reqMsgPtr);
+    BOOST_CHECK(reqManifestPacket.rlp()[0].toInt<int64_t>() == 0x30);
+    BOOST_CHECK(reqManifestPacket.rlp()[1].toInt<unsigned>() == 8192);
+
+    std::vector<h256> chunkHashes{h256(0x10), h256(0x20)};
+    SyncSnapshotManifestPacket manifestPacket;
+    manifestPacket.encode(int64_t(0x30), h256(0x40), h256(0x50), 3, 1, chunkHashes);
+    auto msgPtr = manifestPacket.toMessage(0x03);
+    manifestPacket.decode(fakeSessionPtr, msgPtr);
+    BOOST_CHECK(manifestPacket.packetType == SnapshotManifestPacket);
+    auto const& manifest = manifestPacket.rlp();
+    BOOST_CHECK(manifest[0].toInt<int64_t>() == 0x30);
+    BOOST_CHECK(manifest[1].toHash<h256>() == h256(0x40));
+    BOOST_CHECK(manifest[2].toHash<h256>() == h256(0x50));
+    BOOST_CHECK(manifest[3].toInt<unsigned>() == 3);
+    BOOST_CHECK(manifest[4].toInt<unsigned>() == 1);
+    BOOST_CHECK(manifest[5].toVector<h256>() == chunkHashes);
+
+    bytes chunk(1024, 0x7f);
+    SyncSnapshotChunkPacket chunkPacket;
+    chunkPacket.encode(int64_t(0x30), 2, chunk);
+    msgPtr = chunkPacket.toMessage(0x03);
+    chunkPacket.decode(fakeSessionPtr, msgPtr);
+    BOOST_CHECK(chunkPacket.packetType == SnapshotChunkPacket);
+    BOOST_CHECK(chunkPacket.rlp()[1].toInt<unsigned>() == 2);
+    BOOST_CHECK(chunkPacket.rlp()[2].toBytes() == chunk);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 }  // namespace test
 }  // namespace dev
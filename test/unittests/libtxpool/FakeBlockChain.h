@@ -186,7 +186,7 @@ public:
 
     dev::bytes getCode(dev::Address) override { return bytes(); }
     bool checkAndBuildGenesisBlock(GenesisBlockParam&) override { return true; }
-    dev::h512s sealerList() override { return dev::h512s(); };
+    dev::h512s sealerList() override { return m_sealerList; };
     dev::h512s observerList() override { return dev::h512s(); };
     std::string getSystemConfigByKey(std::string const&, int64_t) override { return "300000000"; };
     std::map<h256, int64_t> m_blockHash;
@@ -194,6 +194,7 @@ public:
     int64_t m_blockNumber;
     int64_t m_totalTransactionCount;
     Secret m_sec;
+    dev::h512s m_sealerList;
 };
 class TxPoolFixture
 {
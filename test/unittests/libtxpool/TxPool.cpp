@@ -135,6 +135,175 @@ BOOST_AUTO_TEST_CASE(testImportAndSubmit)
     pool_test.m_txPool->setMaxBlockLimit(100);
     BOOST_CHECK(pool_test.m_txPool->maxBlockLimit() == 100);
 }
+
+BOOST_AUTO_TEST_CASE(testTransactionKnownBy)
+{
+    TxPoolFixture pool_test(5, 5);
+    Transactions transaction_vec =
+        pool_test.m_blockChain->getBlockByHash(pool_test.m_blockChain->numberHash(0))
+            ->transactions();
+    size_t i = 0;
+    for (auto& tx : transaction_vec)
+    {
+        tx.setNonce(tx.nonce() + u256(i) + u256(1));
+        tx.setBlockLimit(pool_test.m_blockChain->number() + u256(1));
+        Signature sig = sign(pool_test.m_blockChain->m_sec, tx.sha3(WithoutSignature));
+        tx.updateSignature(SignatureStruct(sig));
+        bytes trans_bytes;
+        tx.encode(trans_bytes);
+        BOOST_CHECK(pool_test.m_txPool->import(ref(trans_bytes)) == ImportResult::Success);
+        i++;
+    }
+    Transactions pending_list = pool_test.m_txPool->pendingList();
+    BOOST_CHECK(pending_list.size() == 5);
+    h512 nodeA = KeyPair::create().pub();
+    h512 nodeB = KeyPair::create().pub();
+    BOOST_CHECK(!pool_test.m_txPool->isTransactionKnownBySomeone(pending_list[0].sha3()));
+
+    /// set known by nodeA
+    pool_test.m_txPool->setTransactionIsKnownBy(pending_list[0].sha3(), nodeA);
+    std::vector<h256> txHashes = {pending_list[1].sha3(), pending_list[2].sha3()};
+    pool_test.m_txPool->setTransactionsAreKnownBy(txHashes, nodeA);
+    BOOST_CHECK(pool_test.m_txPool->isTransactionKnownBy(pending_list[0].sha3(), nodeA));
+    BOOST_CHECK(pool_test.m_txPool->isTransactionKnownBy(pending_list[2].sha3(), nodeA));
+    BOOST_CHECK(!pool_test.m_txPool->isTransactionKnownBy(pending_list[3].sha3(), nodeA));
+    BOOST_CHECK(!pool_test.m_txPool->isTransactionKnownBy(pending_list[0].sha3(), nodeB));
+    BOOST_CHECK(pool_test.m_txPool->isTransactionKnownBySomeone(pending_list[0].sha3()));
+    BOOST_CHECK(!pool_test.m_txPool->isTransactionKnownBySomeone(pending_list[4].sha3()));
+
+    /// topTransactionsCondition skips transactions known by the node
+    BOOST_CHECK(pool_test.m_txPool->topTransactionsCondition(20, nodeA).size() == 2);
+    BOOST_CHECK(pool_test.m_txPool->topTransactionsCondition(20, nodeB).size() == 5);
+
+    /// known-by information is removed together with the transaction
+    BOOST_CHECK(pool_test.m_txPool->drop(pending_list[0].sha3()));
+    BOOST_CHECK(!pool_test.m_txPool->isTransactionKnownBy(pending_list[0].sha3(), nodeA));
+    BOOST_CHECK(!pool_test.m_txPool->isTransactionKnownBySomeone(pending_list[0].sha3()));
+}
+
+BOOST_AUTO_TEST_CASE(testReusePeerIndex)
+{
+    TxPoolFixture pool_test(5, 5);
+    Transactions transaction_vec =
+        pool_test.m_blockChain->getBlockByHash(pool_test.m_blockChain->numberHash(0))
+            ->transactions();
+    auto& tx = transaction_vec[0];
+    tx.setNonce(tx.nonce() + u256(1));
+    tx.setBlockLimit(pool_test.m_blockChain->number() + u256(1));
+    Signature sig = sign(pool_test.m_blockChain->m_sec, tx.sha3(WithoutSignature));
+    tx.updateSignature(SignatureStruct(sig));
+    bytes trans_bytes;
+    tx.encode(trans_bytes);
+    BOOST_CHECK(pool_test.m_txPool->import(ref(trans_bytes)) == ImportResult::Success);
+    h256 txHash = pool_test.m_txPool->pendingList()[0].sha3();
+
+    /// all the indexes are taken by the peers
+    std::vector<h512> peers;
+    for (size_t i = 0; i < c_maxKnownByPeers; i++)
+    {
+        peers.push_back(h512(i + 1));
+        pool_test.m_txPool->setTransactionIsKnownBy(txHash, peers.back());
+    }
+    BOOST_CHECK(pool_test.m_txPool->isTransactionKnownBy(txHash, peers.back()));
+    h512 newPeer = h512(c_maxKnownByPeers + 1);
+    pool_test.m_txPool->setTransactionIsKnownBy(txHash, newPeer);
+    BOOST_CHECK(!pool_test.m_txPool->isTransactionKnownBy(txHash, newPeer));
+
+    /// the indexes of the disconnected peers are reused without their records
+    std::set<h512> activePeers = {peers[0]};
+    pool_test.m_txPool->removeInactivePeers(activePeers);
+    BOOST_CHECK(pool_test.m_txPool->isTransactionKnownBy(txHash, peers[0]));
+    BOOST_CHECK(!pool_test.m_txPool->isTransactionKnownBy(txHash, peers[1]));
+    BOOST_CHECK(pool_test.m_txPool->topTransactionsCondition(20, newPeer).size() == 1);
+    pool_test.m_txPool->setTransactionIsKnownBy(txHash, newPeer);
+    BOOST_CHECK(pool_test.m_txPool->isTransactionKnownBy(txHash, newPeer));
+    BOOST_CHECK(!pool_test.m_txPool->isTransactionKnownBy(txHash, peers.back()));
+    BOOST_CHECK(pool_test.m_txPool->topTransactionsCondition(20, newPeer).size() == 0);
+}
+
+BOOST_AUTO_TEST_CASE(testPriorityLanes)
+{
+    TxPoolFixture pool_test(5, 5);
+    Transactions transaction_vec =
+        pool_test.m_blockChain->getBlockByHash(pool_test.m_blockChain->numberHash(0))
+            ->transactions();
+    /// the first two transactions are sent by the priority sender
+    KeyPair prioritySender = KeyPair::create();
+    pool_test.m_txPool->setPrioritySenders({prioritySender.address()});
+    pool_test.m_txPool->setLaneWeights({{1, 1, 1}});
+    size_t i = 0;
+    for (auto& tx : transaction_vec)
+    {
+        tx.setNonce(tx.nonce() + u256(i) + u256(1));
+        tx.setBlockLimit(pool_test.m_blockChain->number() + u256(1));
+        Secret sec = (i < 2 ? prioritySender.secret() : pool_test.m_blockChain->m_sec);
+        Signature sig = sign(sec, tx.sha3(WithoutSignature));
+        tx.updateSignature(SignatureStruct(sig));
+        bytes trans_bytes;
+        tx.encode(trans_bytes);
+        BOOST_CHECK(pool_test.m_txPool->import(ref(trans_bytes)) == ImportResult::Success);
+        i++;
+    }
+    TxPoolStatus status = pool_test.m_txPool->status();
+    BOOST_CHECK(status.current == 5);
+    BOOST_CHECK(status.lanes[SystemLane].depth == 0);
+    BOOST_CHECK(status.lanes[PrioritySenderLane].depth == 2);
+    BOOST_CHECK(status.lanes[NormalLane].depth == 3);
+
+    /// weighted round robin: one transaction from each non-empty lane in a round
+    Transactions top_transactions = pool_test.m_txPool->topTransactions(5);
+    BOOST_CHECK(top_transactions.size() == 5);
+    BOOST_CHECK(top_transactions[0].sender() == prioritySender.address());
+    BOOST_CHECK(top_transactions[1].sender() != prioritySender.address());
+    BOOST_CHECK(top_transactions[2].sender() == prioritySender.address());
+    BOOST_CHECK(top_transactions[3].sender() != prioritySender.address());
+    BOOST_CHECK(top_transactions[4].sender() != prioritySender.address());
+    /// the priority lane is listed first
+    BOOST_CHECK(pool_test.m_txPool->pendingList()[0].sender() == prioritySender.address());
+
+    /// commit metrics of the lanes
+    Block block;
+    block.setTransactions(top_transactions);
+    BOOST_CHECK(pool_test.m_txPool->dropBlockTrans(block));
+    status = pool_test.m_txPool->status();
+    BOOST_CHECK(status.current == 0);
+    BOOST_CHECK(status.lanes[PrioritySenderLane].depth == 0);
+    BOOST_CHECK(status.lanes[PrioritySenderLane].committed == 2);
+    BOOST_CHECK(status.lanes[NormalLane].committed == 3);
+}
+
+BOOST_AUTO_TEST_CASE(testReceiptNotification)
+{
+    TxPoolFixture pool_test(5, 5);
+    Transactions transaction_vec =
+        pool_test.m_blockChain->getBlockByHash(pool_test.m_blockChain->numberHash(0))
+            ->transactions();
+    std::atomic<size_t> notified = {0};
+    size_t i = 0;
+    for (auto& tx : transaction_vec)
+    {
+        tx.setNonce(tx.nonce() + u256(i) + u256(1));
+        tx.setBlockLimit(pool_test.m_blockChain->number() + u256(1));
+        Signature sig = sign(pool_test.m_blockChain->m_sec, tx.sha3(WithoutSignature));
+        tx.updateSignature(SignatureStruct(sig));
+        tx.setRpcCallback([&notified](LocalisedTransactionReceipt::Ptr) { notified++; });
+        pool_test.m_txPool->submit(tx);
+        i++;
+    }
+    /// the receipts of a committed block are delivered asynchronously in one batch
+    Block block;
+    block.setTransactions(transaction_vec);
+    block.setTransactionReceipts(TransactionReceipts(transaction_vec.size()));
+    BOOST_CHECK(pool_test.m_txPool->dropBlockTrans(block));
+    BOOST_CHECK(pool_test.m_txPool->pendingSize() == 0);
+    for (size_t retry = 0; retry < 100 && pool_test.m_txPool->status().notifyPending > 0; retry++)
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    BOOST_CHECK(notified == transaction_vec.size());
+    TxPoolStatus status = pool_test.m_txPool->status();
+    BOOST_CHECK(status.notifyDelivered == transaction_vec.size());
+    BOOST_CHECK(status.notifyPending == 0);
+    BOOST_CHECK(status.notifyDropped == 0);
+}
 BOOST_AUTO_TEST_SUITE_END()
 }  // namespace test
 }  // namespace dev
@@ -493,9 +493,34 @@ function generate_group_ini()
 ; the ttl for broadcasting pbft message
 [consensus]
     ;ttl=2
+    ;broadcast block header and transaction hashes in prepare, all sealers should enable it
+    ;compact_prepare=false
+    ;only store the signatures of 2f+1 sealers in the committed block
+    ;commit_certificate=false
+    ;width of the tree sending the prepare, 0 means broadcast, all sealers should set it
+    ;tree_broadcast_width=0
+    ;the next leader proposes once the current block is signed by 2f+1 sealers
+    ;pipeline=false
+    ;adapt the view timeout to the commit latencies and skip the leaders timed out repeatedly
+    ;adaptive_timeout=false
+    ;the leader executes the transactions while packing them into the block
+    ;pre_execute=false
+    ;when to fsync the pbft backup log: none, batch(every 50ms) or always
+    ;backup_sync=none
 ;txpool limit
 [tx_pool]
     limit=10000
+    ;weights of the system, priority-sender and normal lanes when sealing
+    ;lane_weights=4,2,1
+    ;comma separated senders whose transactions go into the priority-sender lane
+    ;priority_senders=
+;broadcast transaction hashes and fetch the missing transactions from peers
+[sync]
+    ;announce_txs=false
+    ;take a state snapshot every snapshot_interval blocks for the new nodes, 0 disables it
+    ;snapshot_interval=0
+    ;download the latest snapshot of the sealers instead of replaying all the blocks
+    ;fast_sync=false
 EOF
 }
 